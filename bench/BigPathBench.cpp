@@ -7,7 +7,10 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkPath.h"
+#include "SkRandom.h"
+#include "SkScan.h"
 #include "ToolUtils.h"
 
 enum Align {
@@ -82,3 +85,64 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+// A filled path with a quarter of a million segments, like a detailed coastline on a map tile.
+// With banded set, analytic AA fills it in bands on a thread pool.
+class BigFillPathBench : public Benchmark {
+    SkPath                      fPath;
+    bool                        fBanded;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+public:
+    explicit BigFillPathBench(bool banded) : fBanded(banded) {}
+
+protected:
+    const char* onGetName() override {
+        return fBanded ? "bigpath_fill_banded" : "bigpath_fill";
+    }
+
+    SkIPoint onGetSize() override {
+        return SkIPoint::Make(1024, 1024);
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int contour = 0; contour < 64; ++contour) {
+            const SkPoint center = { rand.nextRangeF(128, 896), rand.nextRangeF(128, 896) };
+            const int kSegments = 4096;
+            for (int i = 0; i < kSegments; ++i) {
+                SkScalar angle  = 2 * SK_ScalarPI * i / kSegments,
+                         radius = rand.nextRangeF(96, 128);
+                SkPoint pt = center + SkPoint{ radius * SkScalarCos(angle),
+                                               radius * SkScalarSin(angle) };
+                if (i == 0) {
+                    fPath.moveTo(pt);
+                } else {
+                    fPath.lineTo(pt);
+                }
+            }
+            fPath.close();
+        }
+        if (fBanded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        this->setupPaint(&paint);
+
+        gSkAnalyticAAExecutor = fExecutor.get();
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPath(fPath, paint);
+        }
+        gSkAnalyticAAExecutor = nullptr;
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new BigFillPathBench(false); )
+DEF_BENCH( return new BigFillPathBench(true); )
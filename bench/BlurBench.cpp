@@ -31,12 +31,15 @@ static const char* gStyleName[] = {
 class BlurBench : public Benchmark {
     SkScalar    fRadius;
     SkBlurStyle fStyle;
+    SkScalar    fExtent;
     SkString    fName;
 
 public:
-    BlurBench(SkScalar rad, SkBlurStyle bs) {
+    // Draws ovals up to extent wide and high.
+    BlurBench(SkScalar rad, SkBlurStyle bs, SkScalar extent = 400) {
         fRadius = rad;
         fStyle = bs;
+        fExtent = extent;
         const char* name = rad > 0 ? gStyleName[bs] : "none";
         const char* quality = "high_quality";
         if (SkScalarFraction(rad) != 0) {
@@ -44,6 +47,9 @@ public:
         } else {
             fName.printf("blur_%d_%s_%s", SkScalarRoundToInt(rad), name, quality);
         }
+        if (extent != 400) {
+            fName.appendf("_%d", SkScalarRoundToInt(extent));
+        }
     }
 
 protected:
@@ -59,8 +65,8 @@ protected:
 
         SkRandom rand;
         for (int i = 0; i < loops; i++) {
-            SkRect r = SkRect::MakeWH(rand.nextUScalar1() * 400,
-                                      rand.nextUScalar1() * 400);
+            SkRect r = SkRect::MakeWH(rand.nextUScalar1() * fExtent,
+                                      rand.nextUScalar1() * fExtent);
             r.offset(fRadius, fRadius);
 
             if (fRadius > 0) {
@@ -101,3 +107,7 @@ DEF_BENCH(return new BlurBench(REAL, kOuter_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kInner_SkBlurStyle);)
 
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
+
+// Shadow-sized masks, where the vertical pass walks many rows.
+DEF_BENCH(return new BlurBench(BIG, kNormal_SkBlurStyle, 1600);)
+DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle, 1600);)
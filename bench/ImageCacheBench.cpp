@@ -6,7 +6,10 @@
  */
 
 #include "Benchmark.h"
+#include "SkExecutor.h"
 #include "SkResourceCache.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
 
 namespace {
 static void* gGlobalAddress;
@@ -72,6 +75,61 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Looks up keys in the global cache from several threads at once, mostly hits with some misses,
+// to measure contention on its locks.
+class ImageCacheMultiThreadBench : public Benchmark {
+    enum {
+        CACHE_COUNT = 500,
+        LOOKUPS_PER_TASK = 1000,
+    };
+public:
+    ImageCacheMultiThreadBench(int threads) : fThreads(threads) {
+        fName.printf("imagecache_mt_%dthreads", threads);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        // Other users of the global cache may have purged our recs; put back any that are gone.
+        for (int i = 0; i < CACHE_COUNT; ++i) {
+            if (!SkResourceCache::Find(TestKey(i), TestRec::Visitor, nullptr)) {
+                SkResourceCache::Add(new TestRec(TestKey(i), i));
+            }
+        }
+
+        for (int i = 0; i < loops; ++i) {
+            SkTaskGroup(*fExecutor).batch(4 * fThreads, [](int task) {
+                for (int j = 0; j < LOOKUPS_PER_TASK; ++j) {
+                    // Keys past CACHE_COUNT are misses.
+                    TestKey key((task * 7919 + j) % (CACHE_COUNT + CACHE_COUNT / 4));
+                    SkResourceCache::Find(key, TestRec::Visitor, nullptr);
+                }
+            });
+        }
+    }
+
+private:
+    const int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkString fName;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+DEF_BENCH( return new ImageCacheMultiThreadBench(1); )
+DEF_BENCH( return new ImageCacheMultiThreadBench(4); )
+DEF_BENCH( return new ImageCacheMultiThreadBench(8); )
@@ -10,9 +10,12 @@
 #include "SkBlurImageFilter.h"
 #include "SkCanvas.h"
 #include "SkDisplacementMapEffect.h"
+#include "SkExecutor.h"
 #include "SkImage.h"
 #include "SkMergeImageFilter.h"
+#include "SkMorphologyImageFilter.h"
 #include "SkOffsetImageFilter.h"
+#include "SkSpecialImage.h"
 #include "SkXfermodeImageFilter.h"
 
 // Exercise a blur filter connected to 5 inputs of the same merge filter.
@@ -144,7 +147,69 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Filters a DAG of independent branches on the CPU, optionally with an executor so that the
+// branches run concurrently and each blur or dilate is split into bands.
+class ImageFilterDAGExecutorBench : public Benchmark {
+public:
+    explicit ImageFilterDAGExecutorBench(bool threaded)
+        : fName(threaded ? "image_filter_dag_executor" : "image_filter_dag_serial")
+        , fThreaded(threaded) {}
+
+protected:
+    const char* onGetName() override { return fName; }
+    bool isSuitableFor(Backend backend) override { return kNonRendering_Backend == backend; }
+
+    void onDelayedSetup() override {
+        fImage = GetResourceAsImage("images/mandrill_512.png");
+        if (fThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+
+        sk_sp<SkImageFilter> inputs[kNumInputs];
+        for (int i = 0; i < kNumInputs; ++i) {
+            // Distinct filters, so that none are shared between branches.
+            auto blur = SkBlurImageFilter::Make(4.0f + 4*i, 8.0f, nullptr);
+            inputs[i] = i % 2 ? SkDilateImageFilter::Make(i, i, std::move(blur)) : blur;
+        }
+        fFilter = SkXfermodeImageFilter::Make(SkBlendMode::kSrcOver,
+                                              SkMergeImageFilter::Make(inputs, kNumInputs),
+                                              SkBlurImageFilter::Make(12.0f, 12.0f, nullptr),
+                                              nullptr);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkBitmap bitmap;
+        if (!fImage || !fImage->asLegacyBitmap(&bitmap)) {
+            return;
+        }
+        const SkIRect bounds = SkIRect::MakeWH(bitmap.width(), bitmap.height());
+        sk_sp<SkSpecialImage> src = SkSpecialImage::MakeFromRaster(bounds, bitmap);
+
+        SkImageFilter::OutputProperties outputProperties(kN32_SkColorType, nullptr);
+        SkImageFilter::Context ctx(SkMatrix::I(), bounds, nullptr, outputProperties,
+                                   fExecutor.get());
+        for (int j = 0; j < loops; j++) {
+            SkIPoint offset;
+            sk_sp<SkSpecialImage> result = fFilter->filterImage(src.get(), ctx, &offset);
+            SkASSERT(result);
+        }
+    }
+
+private:
+    static const int kNumInputs = 5;
+
+    const char*                 fName;
+    bool                        fThreaded;
+    sk_sp<SkImage>              fImage;
+    sk_sp<SkImageFilter>        fFilter;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
+DEF_BENCH(return new ImageFilterDAGExecutorBench(false);)
+DEF_BENCH(return new ImageFilterDAGExecutorBench(true);)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
 DEF_BENCH(return new ImageFilterXfermodeIn;)
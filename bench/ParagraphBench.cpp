@@ -0,0 +1,148 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+
+#if defined(SK_USING_SKPARAGRAPH)
+
+#include "SkExecutor.h"
+#include "SkParagraph.h"
+#include "SkParagraphBuilder.h"
+#include "SkString.h"
+
+#include <string.h>
+#include <vector>
+
+static const char kLine[] =
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt "
+    "ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation.\n";
+
+// Lays out a few paragraphs of text as an editor would while its pane is dragged to a new
+// width (kResize), or while someone types into it (kEdit). kRebuild lays out from scratch each
+// time, as a resize did before layout kept the shaped text.
+class ParagraphBench : public Benchmark {
+public:
+    enum class Mode { kResize, kRebuild, kEdit };
+
+    explicit ParagraphBench(Mode mode) : fMode(mode) {
+        static const char* kNames[] = { "resize", "resize_rebuild", "edit" };
+        fName.printf("paragraph_%s", kNames[(int)mode]);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        for (int i = 0; i < 10; ++i) {
+            fText += kLine;
+        }
+        fFontCollection = sk_make_sp<SkFontCollection>();
+        fParagraph = this->build();
+        fParagraph->layout(kWidth);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            // Drag back and forth over a hundred pixels.
+            double width = kWidth - (i % 25) * 4;
+            switch (fMode) {
+                case Mode::kResize:
+                    fParagraph->layout(width);
+                    break;
+                case Mode::kRebuild:
+                    this->build()->layout(width);
+                    break;
+                case Mode::kEdit: {
+                    // Type a letter into the middle of the fifth line, then delete it.
+                    size_t pos = 4 * strlen(kLine) + 40;
+                    if (i & 1) {
+                        fParagraph->updateText(pos, pos + 1, "");
+                    } else {
+                        fParagraph->updateText(pos, pos, "x");
+                    }
+                    fParagraph->layout(kWidth);
+                    break;
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr double kWidth = 500;
+
+    std::unique_ptr<SkParagraph> build() {
+        SkParagraphStyle paraStyle;
+        SkParagraphBuilder builder(paraStyle, fFontCollection);
+        builder.addText(fText);
+        return builder.Build();
+    }
+
+    SkString                     fName;
+    Mode                         fMode;
+    std::string                  fText;
+    sk_sp<SkFontCollection>      fFontCollection;
+    std::unique_ptr<SkParagraph> fParagraph;
+};
+
+// Builds and lays out a document's worth of short paragraphs, as when it is opened, laying them
+// out either one after another or over a thread pool.
+class ParagraphBatchBench : public Benchmark {
+public:
+    explicit ParagraphBatchBench(bool threaded) : fThreaded(threaded) {
+        fName.printf("paragraph_batch_%s", threaded ? "threaded" : "serial");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fFontCollection = sk_make_sp<SkFontCollection>();
+        if (fThreaded) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkExecutor& executor = fExecutor ? *fExecutor : SkExecutor::GetDefault();
+        for (int i = 0; i < loops; i++) {
+            std::vector<std::unique_ptr<SkParagraph>> paragraphs;
+            std::vector<SkParagraph*> batch;
+            for (int j = 0; j < kParagraphs; ++j) {
+                SkParagraphStyle paraStyle;
+                SkParagraphBuilder builder(paraStyle, fFontCollection);
+                builder.addText(kLine + j % 50);
+                paragraphs.push_back(builder.Build());
+                batch.push_back(paragraphs.back().get());
+            }
+            SkParagraph::LayoutAll(batch, 300, executor);
+        }
+    }
+
+private:
+    static constexpr int kParagraphs = 200;
+
+    SkString                     fName;
+    bool                         fThreaded;
+    sk_sp<SkFontCollection>      fFontCollection;
+    std::unique_ptr<SkExecutor>  fExecutor;
+};
+
+DEF_BENCH(return new ParagraphBench(ParagraphBench::Mode::kResize);)
+DEF_BENCH(return new ParagraphBench(ParagraphBench::Mode::kRebuild);)
+DEF_BENCH(return new ParagraphBench(ParagraphBench::Mode::kEdit);)
+DEF_BENCH(return new ParagraphBatchBench(false);)
+DEF_BENCH(return new ParagraphBatchBench(true);)
+
+#endif  // SK_USING_SKPARAGRAPH
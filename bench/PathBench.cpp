@@ -1242,3 +1242,46 @@ DEF_BENCH( return new CommonConvexBench(200, 16, false, false); )
 DEF_BENCH( return new CommonConvexBench(200, 16, true,  false); )
 DEF_BENCH( return new CommonConvexBench(200, 16, false, true); )
 DEF_BENCH( return new CommonConvexBench(200, 16, true,  true); )
+
+// A polygon drawn again and again at whole-pixel offsets, like static geometry in a scrolling or
+// animated scene. Its edges can be reused from one draw to the next.
+class TranslatedPolygonBench : public Benchmark {
+    SkString    fName;
+    SkPath      fPath;
+    const bool  fAA;
+
+public:
+    TranslatedPolygonBench(bool aa) : fAA(aa) {
+        fName.printf("translated_polygon_%d", aa);
+
+        SkRandom rand;
+        fPath.moveTo(100, 100);
+        for (int i = 1; i < 2000; ++i) {
+            fPath.lineTo(rand.nextRangeF(0, 200), rand.nextRangeF(0, 200));
+        }
+        fPath.close();
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(fAA);
+
+        for (int i = 0; i < loops; ++i) {
+            canvas->save();
+            canvas->translate(SkIntToScalar(i % 100), SkIntToScalar(i % 50));
+            canvas->drawPath(fPath, paint);
+            canvas->restore();
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new TranslatedPolygonBench(false); )
+DEF_BENCH( return new TranslatedPolygonBench(true); )
@@ -12,8 +12,13 @@
 #include "SkPictureRecorder.h"
 #include "SkPoint.h"
 #include "SkRandom.h"
+#include "SkRecord.h"
+#include "SkRecordDraw.h"
+#include "SkRecordOpts.h"
+#include "SkRecorder.h"
 #include "SkRect.h"
 #include "SkString.h"
+#include "SkSurface.h"
 
 // This is designed to emulate about 4 screens of textual content
 
@@ -95,3 +100,64 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+// Plays back a record with the kinds of waste SkRecordOptimize2 removes: rows scrolled out of
+// the cull rect, a page covered by an opaque sheet drawn over it, and a grid of image tiles.
+class OptimizedPlaybackBench : public Benchmark {
+public:
+    explicit OptimizedPlaybackBench(bool optimize) : fOptimize(optimize) {}
+
+    const char* onGetName() override {
+        return fOptimize ? "record_playback_optimized" : "record_playback_unoptimized";
+    }
+    SkIPoint onGetSize() override { return SkIPoint::Make(1024, 1024); }
+
+    void onDelayedSetup() override {
+        const SkRect cull = SkRect::MakeWH(1024, 1024);
+        SkRecorder recorder(&fRecord, cull);
+
+        SkRandom rand;
+        SkPaint paint;
+        // A long list, most of it scrolled off either end.
+        for (int y = -4096; y < 4096; y += 16) {
+            paint.setColor(rand.nextU() | 0xFF000000);
+            recorder.drawRect(SkRect::MakeXYWH(8, y, 1008, 14), paint);
+        }
+
+        // An opaque sheet over the top half of it.
+        paint.setColor(SK_ColorWHITE);
+        recorder.drawRect(SkRect::MakeWH(1024, 512), paint);
+
+        // Anti-aliased tiles of an image, as a compositor would draw them.
+        sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(256, 256);
+        surface->getCanvas()->clear(SK_ColorBLUE);
+        sk_sp<SkImage> image = surface->makeImageSnapshot();
+        SkPaint imagePaint;
+        imagePaint.setFilterQuality(kLow_SkFilterQuality);
+        imagePaint.setAntiAlias(true);
+        for (int y = 0; y < 512; y += 32) {
+            for (int x = 0; x < 1024; x += 32) {
+                SkRect src = SkRect::MakeXYWH(x % 256, y % 256, 32, 32);
+                recorder.drawImageRect(image, src, SkRect::MakeXYWH(x, 512 + y, 32, 32),
+                                       &imagePaint, SkCanvas::kFast_SrcRectConstraint);
+            }
+        }
+
+        if (fOptimize) {
+            SkRecordOptimize2(&fRecord, cull);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            SkRecordDraw(fRecord, canvas, nullptr, nullptr, 0, nullptr, nullptr);
+        }
+    }
+
+private:
+    bool     fOptimize;
+    SkRecord fRecord;
+};
+
+DEF_BENCH( return new OptimizedPlaybackBench(false); )
+DEF_BENCH( return new OptimizedPlaybackBench(true); )
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+
+#if defined(SK_USING_SKSHAPER)
+
+#include "SkFont.h"
+#include "SkShaper.h"
+#include "SkString.h"
+#include "SkTextBlob.h"
+
+#include <string.h>
+
+static const char kParagraph[] =
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt "
+    "ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco "
+    "laboris nisi ut aliquip ex ea commodo consequat. Duis aute irure dolor in reprehenderit in "
+    "voluptate velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint occaecat "
+    "cupidatat non proident, sunt in culpa qui officia deserunt mollit anim id est laborum.";
+
+// Shapes and wraps a paragraph, as a text layout would for each paragraph it lays out.
+// Repeated shaping finds every run in the shaped run cache; kUncached turns that off, and kCold
+// also drops the shared HarfBuzz faces and fonts each time, as if every paragraph used a typeface
+// or size not seen before.
+class ShaperBench : public Benchmark {
+public:
+    enum class Mode { kCached, kUncached, kCold };
+
+    ShaperBench(SkScalar textSize, Mode mode) : fTextSize(textSize), fMode(mode) {
+        static const char* kSuffixes[] = { "", "_uncached", "_cold" };
+        fName.printf("shaper_paragraph_%g%s", textSize, kSuffixes[(int)mode]);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fShaper = SkShaper::Make();
+        fFont.setSize(fTextSize);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const size_t length = strlen(kParagraph);
+#ifdef SK_SHAPER_HARFBUZZ_AVAILABLE
+        size_t limit = 0;
+        if (fMode == Mode::kUncached) {
+            limit = SkShaper::SetShapedRunCacheLimit(0);
+        }
+#endif
+        for (int i = 0; i < loops; i++) {
+#ifdef SK_SHAPER_HARFBUZZ_AVAILABLE
+            if (fMode == Mode::kCold) {
+                SkShaper::PurgeHarfBuzzCache();
+            }
+#endif
+            SkTextBlobBuilderRunHandler handler(kParagraph, {0, 0});
+            fShaper->shape(kParagraph, length, fFont, true, 400, &handler);
+            sk_sp<SkTextBlob> blob = handler.makeBlob();
+        }
+#ifdef SK_SHAPER_HARFBUZZ_AVAILABLE
+        if (fMode == Mode::kUncached) {
+            SkShaper::SetShapedRunCacheLimit(limit);
+        }
+#endif
+    }
+
+private:
+    SkString                  fName;
+    SkScalar                  fTextSize;
+    Mode                      fMode;
+    SkFont                    fFont;
+    std::unique_ptr<SkShaper> fShaper;
+};
+
+DEF_BENCH(return new ShaperBench(12, ShaperBench::Mode::kCached);)
+DEF_BENCH(return new ShaperBench(24, ShaperBench::Mode::kCached);)
+#ifdef SK_SHAPER_HARFBUZZ_AVAILABLE
+DEF_BENCH(return new ShaperBench(12, ShaperBench::Mode::kUncached);)
+DEF_BENCH(return new ShaperBench(12, ShaperBench::Mode::kCold);)
+#endif
+
+#endif  // SK_USING_SKSHAPER
@@ -10,12 +10,15 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkGraphics.h"
 #include "SkStrikeCache.h"
 #include "SkTaskGroup.h"
 #include "SkTypeface.h"
 #include "ToolUtils.h"
 
+#include <vector>
+
 static void do_font_stuff(SkFont* font) {
     SkPaint defaultPaint;
     for (SkScalar i = 8; i < 64; i++) {
@@ -110,7 +113,131 @@ private:
     SkString fName;
 };
 
+// Unlike SkGlyphCacheStressTest, which runs on whatever default executor the harness set up,
+// this always runs on its own pool, so that it measures contention on the strike cache.
+class SkGlyphCacheMultiThread : public Benchmark {
+public:
+    SkGlyphCacheMultiThread(int threads, size_t cacheSize)
+        : fThreads(threads), fCacheSize(cacheSize) { }
+
+protected:
+    const char* onGetName() override {
+        fName.printf("SkGlyphCacheMultiThread_%dthreads_%dK", fThreads, (int)(fCacheSize >> 10));
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        fTypefaces[0] = ToolUtils::create_portable_typeface("serif", SkFontStyle::Italic());
+        fTypefaces[1] = ToolUtils::create_portable_typeface("sans-serif", SkFontStyle::Italic());
+        fTypefaces[2] = ToolUtils::create_portable_typeface("serif", SkFontStyle::Normal());
+        fTypefaces[3] = ToolUtils::create_portable_typeface("sans-serif", SkFontStyle::Normal());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        size_t oldCacheLimitSize = SkGraphics::GetFontCacheLimit();
+        SkGraphics::SetFontCacheLimit(fCacheSize);
+
+        for (int work = 0; work < loops; work++) {
+            // A few tasks per thread, each on a mix of typefaces and edgings, so that threads
+            // look up a spread of strikes rather than all hammering the same one.
+            SkTaskGroup(*fExecutor).batch(4 * fThreads, [&](int task) {
+                SkFont font;
+                font.setEdging(task & 4 ? SkFont::Edging::kAlias : SkFont::Edging::kAntiAlias);
+                font.setSubpixel(true);
+                font.setTypeface(fTypefaces[task % SK_ARRAY_COUNT(fTypefaces)]);
+                do_font_stuff(&font);
+            });
+        }
+        SkGraphics::SetFontCacheLimit(oldCacheLimitSize);
+    }
+
+private:
+    typedef Benchmark INHERITED;
+    const int fThreads;
+    const size_t fCacheSize;
+    std::unique_ptr<SkExecutor> fExecutor;
+    sk_sp<SkTypeface> fTypefaces[4];
+    SkString fName;
+};
+
+// Rasterizes every glyph of a page of text into empty strikes, as the first paint of a new
+// document would, either lazily one glyph at a time, or with SkStrike::prefetchImages spread over
+// a pool of threads.
+class SkGlyphCacheFirstPaint : public Benchmark {
+public:
+    explicit SkGlyphCacheFirstPaint(int threads) : fThreads(threads) { }
+
+protected:
+    const char* onGetName() override {
+        if (fThreads > 0) {
+            fName.printf("SkGlyphCacheFirstPaint_prefetch_%dthreads", fThreads);
+        } else {
+            fName.set("SkGlyphCacheFirstPaint_lazy");
+        }
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+        fFont.setTypeface(ToolUtils::create_portable_typeface("serif", SkFontStyle::Normal()));
+        fFont.setEdging(SkFont::Edging::kAntiAlias);
+        fFont.setSubpixel(true);
+        for (int i = 0; i < 2000; ++i) {
+            fGlyphs.push_back(fFont.unicharToGlyph(' ' + i % 95));
+            fPositions.push_back({0.37f * i, 0});
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkSpan<const SkGlyphID> glyphs(fGlyphs.data(), fGlyphs.size());
+        SkSpan<const SkPoint> positions(fPositions.data(), fPositions.size());
+        for (int work = 0; work < loops; work++) {
+            for (SkScalar size : { 12, 16, 24 }) {
+                fFont.setSize(size);
+                auto strike = SkStrikeCache::FindOrCreateStrikeExclusive(
+                        fFont, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                        SkScalerContextFlags::kNone, SkMatrix::I());
+                if (fExecutor) {
+                    strike->prefetchImages(glyphs, positions, fExecutor.get());
+                }
+                for (size_t i = 0; i < fGlyphs.size(); ++i) {
+                    strike->findImage(strike->getGlyphMetrics(fGlyphs[i], fPositions[i]));
+                }
+            }
+            // Start from empty strikes next time around.
+            SkStrikeCache::GlobalStrikeCache()->purgeAll();
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+    const int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkFont fFont;
+    std::vector<SkGlyphID> fGlyphs;
+    std::vector<SkPoint> fPositions;
+    SkString fName;
+};
+
 DEF_BENCH( return new SkGlyphCacheBasic(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheMultiThread(4, 32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheMultiThread(16, 32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheMultiThread(32, 256 * 1024); )
+DEF_BENCH( return new SkGlyphCacheMultiThread(32, 32 * 1024 * 1024); )
+DEF_BENCH( return new SkGlyphCacheFirstPaint(0); )
+DEF_BENCH( return new SkGlyphCacheFirstPaint(4); )
+DEF_BENCH( return new SkGlyphCacheFirstPaint(8); )
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkRasterPipeline.h"
+#include "SkString.h"
+
+// Blends one row of pixels over another, to compare raster pipeline stages across SkOpts tiers.
+class SkRasterPipelineBench : public Benchmark {
+public:
+    enum Format { k8888, kF16, kF32 };
+
+    SkRasterPipelineBench(Format format, bool blend) : fFormat(format), fBlend(blend) {
+        static const char* kNames[] = { "8888", "f16", "f32" };
+        fName.printf("SkRasterPipeline_%s_%s", kNames[format], blend ? "srcover" : "copy");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        // 8888 pipelines run in lowp when the SkOpts tier has lowp stages; the others are highp.
+        SkRasterPipeline::StockStage load, load_dst, store;
+        switch (fFormat) {
+            case k8888: load     = SkRasterPipeline::load_8888;
+                        load_dst = SkRasterPipeline::load_8888_dst;
+                        store    = SkRasterPipeline::store_8888;  break;
+            case kF16:  load     = SkRasterPipeline::load_f16;
+                        load_dst = SkRasterPipeline::load_f16_dst;
+                        store    = SkRasterPipeline::store_f16;   break;
+            case kF32:  load     = SkRasterPipeline::load_f32;
+                        load_dst = SkRasterPipeline::load_f32_dst;
+                        store    = SkRasterPipeline::store_f32;   break;
+        }
+
+        SkRasterPipeline_MemoryCtx src = { fSrc, 0 },
+                                   dst = { fDst, 0 };
+        SkRasterPipeline_<256> p;
+        p.append(load, &src);
+        if (fBlend) {
+            p.append(load_dst, &dst);
+            p.append(SkRasterPipeline::srcover);
+        }
+        p.append(store, &dst);
+
+        auto run = p.compile();
+        while (loops --> 0) {
+            run(0,0, kWidth,1);
+        }
+    }
+
+private:
+    // Arbitrary, but nice to be a non-multiple of any stride to run through tails.
+    static constexpr int kWidth = 1023;
+
+    Format   fFormat;
+    bool     fBlend;
+    SkString fName;
+
+    // Big enough for kWidth f32 pixels. The contents don't matter.
+    float    fSrc[4*kWidth] = {0},
+             fDst[4*kWidth] = {0};
+};
+
+DEF_BENCH(return new SkRasterPipelineBench(SkRasterPipelineBench::k8888, false);)
+DEF_BENCH(return new SkRasterPipelineBench(SkRasterPipelineBench::k8888, true );)
+DEF_BENCH(return new SkRasterPipelineBench(SkRasterPipelineBench::kF16 , false);)
+DEF_BENCH(return new SkRasterPipelineBench(SkRasterPipelineBench::kF16 , true );)
+DEF_BENCH(return new SkRasterPipelineBench(SkRasterPipelineBench::kF32 , false);)
+DEF_BENCH(return new SkRasterPipelineBench(SkRasterPipelineBench::kF32 , true );)
@@ -437,6 +437,9 @@ public:
     const char* fileExtension() const override { return "png"; }
     SinkFlags flags() const override { return SinkFlags{ SinkFlags::kRaster, SinkFlags::kDirect }; }
 
+protected:
+    void allocPixels(const Src&, SkBitmap*) const;
+
 private:
     SkColorType         fColorType;
     sk_sp<SkColorSpace> fColorSpace;
@@ -26,6 +26,7 @@
 
 class SkColorSpace;
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkPngChunkReader;
 class SkSampler;
@@ -346,6 +347,39 @@ public:
         return this->getPixels(pm.info(), pm.writable_addr(), pm.rowBytes(), opts);
     }
 
+    /**
+     *  Like getPixels(), but if executor is not null and the codec supports it, splits the
+     *  image into bands of rows that are decoded in parallel on executor, each by its own
+     *  codec reading a duplicate of this codec's stream.
+     *
+     *  Band decoding is used for baseline JPEGs and non-interlaced PNGs that are tall enough to
+     *  be worth splitting, when decoding the whole first frame without a subset. Each band still
+     *  has to read (but not fully decode) the rows above it, so the speedup comes from the
+     *  per-row work: IDCT, color conversion and swizzling. Otherwise, or if any band fails,
+     *  this is equivalent to getPixels().
+     */
+    Result getPixelsInBands(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                            const Options* options, SkExecutor* executor);
+
+    /**
+     *  One image to decode with DecodeBatch().
+     */
+    struct BatchItem {
+        SkCodec*       fCodec;
+        SkImageInfo    fInfo;
+        void*          fPixels;
+        size_t         fRowBytes;
+        const Options* fOptions;     // May be null.
+        Result         fResult;      // Set by DecodeBatch().
+    };
+
+    /**
+     *  Calls getPixels() for each item, decoding the items in parallel on executor, or on
+     *  SkExecutor::GetDefault() if executor is null. Each item's codec must be distinct. A batch
+     *  of one item is decoded with getPixelsInBands().
+     */
+    static void DecodeBatch(BatchItem items[], int count, SkExecutor* executor = nullptr);
+
     /**
      *  If decoding to YUV is supported, this returns true.  Otherwise, this
      *  returns false and does not modify any of the parameters.
@@ -776,6 +810,13 @@ protected:
      */
     virtual SkScanlineOrder onGetScanlineOrder() const { return kTopDown_SkScanlineOrder; }
 
+    /**
+     *  Subclasses should return true if independent codecs, each skipping to a different
+     *  top-down band of rows of the same image, can decode it faster in parallel than one codec
+     *  decoding all of it. See getPixelsInBands().
+     */
+    virtual bool onCanDecodeInBands() const { return false; }
+
     const SkImageInfo& dstInfo() const { return fDstInfo; }
 
     const Options& options() const { return fOptions; }
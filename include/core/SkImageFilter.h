@@ -20,6 +20,7 @@
 
 class GrFragmentProcessor;
 class SkColorFilter;
+class SkExecutor;
 struct SkIPoint;
 class GrRecordingContext;
 class SkSpecialImage;
@@ -56,18 +57,25 @@ public:
 
     class Context {
     public:
+        /**
+         *  If executor is not null, filters on the CPU may use it to filter independent inputs
+         *  concurrently, and to split up large single-input filters (e.g. blur, morphology).
+         *  The results are the same either way.
+         */
         Context(const SkMatrix& ctm, const SkIRect& clipBounds, SkImageFilterCache* cache,
-                const OutputProperties& outputProperties)
+                const OutputProperties& outputProperties, SkExecutor* executor = nullptr)
             : fCTM(ctm)
             , fClipBounds(clipBounds)
             , fCache(cache)
             , fOutputProperties(outputProperties)
+            , fExecutor(executor)
         {}
 
         const SkMatrix& ctm() const { return fCTM; }
         const SkIRect& clipBounds() const { return fClipBounds; }
         SkImageFilterCache* cache() const { return fCache; }
         const OutputProperties& outputProperties() const { return fOutputProperties; }
+        SkExecutor* executor() const { return fExecutor; }
 
         /**
          *  Since a context can be build directly, its constructor has no chance to
@@ -84,6 +92,7 @@ public:
         SkIRect                fClipBounds;
         SkImageFilterCache*    fCache;
         OutputProperties       fOutputProperties;
+        SkExecutor*            fExecutor;
     };
 
     class CropRect {
@@ -379,6 +388,16 @@ protected:
                                       const Context&,
                                       SkIPoint* offset) const;
 
+    // Calls filterInput() for each of the first "count" inputs, storing the results in
+    // results[] and offsets[] (which should be initialized to zero). If the context has an
+    // executor and src is not texture-backed, the inputs are filtered concurrently. An input
+    // that appears more than once is only filtered once.
+    void filterInputs(int count,
+                      SkSpecialImage* src,
+                      const Context&,
+                      sk_sp<SkSpecialImage> results[],
+                      SkIPoint offsets[]) const;
+
     /**
      *  Return true (and return a ref'd colorfilter) if this node in the DAG is just a
      *  colorfilter w/o CropRect constraints.
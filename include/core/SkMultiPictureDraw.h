@@ -12,6 +12,7 @@
 #include "SkMatrix.h"
 
 class SkCanvas;
+class SkExecutor;
 class SkPaint;
 class SkPicture;
 
@@ -20,14 +21,22 @@ class SkPicture;
     The MultiPictureDraw object accepts several picture/canvas pairs and
     then attempts to optimally draw the pictures into the canvases, sharing
     as many resources as possible.
+
+    Pairs targeting CPU-backed canvases are drawn in parallel, one task per
+    distinct canvas. Pairs that share a canvas are drawn in the order they
+    were added, on the same task. GPU-backed canvases are always drawn on the
+    calling thread.
 */
 class SK_API SkMultiPictureDraw {
 public:
     /**
      *  Create an object to optimize the drawing of multiple pictures.
-     *  @param reserve Hint for the number of add calls expected to be issued
+     *  @param reserve  Hint for the number of add calls expected to be issued
+     *  @param executor Runs the draws into CPU-backed canvases. If null,
+     *                  SkExecutor::GetDefault() is used. Not owned; must
+     *                  outlive any call to draw().
      */
-    SkMultiPictureDraw(int reserve = 0);
+    SkMultiPictureDraw(int reserve = 0, SkExecutor* executor = nullptr);
     ~SkMultiPictureDraw() { this->reset(); }
 
     /**
@@ -46,7 +55,7 @@ public:
     /**
      *  Perform all the previously added draws. This will reset the state
      *  of this object. If flush is true, all canvases are flushed after
-     *  draw.
+     *  draw. Blocks until every draw has finished.
      */
     void draw(bool flush = false);
 
@@ -68,6 +77,7 @@ private:
         static void Reset(SkTDArray<DrawData>&);
     };
 
+    SkExecutor*         fExecutor;
     SkTDArray<DrawData> fThreadSafeDrawData;
     SkTDArray<DrawData> fGPUDrawData;
 };
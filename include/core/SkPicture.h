@@ -80,6 +80,23 @@ public:
     static sk_sp<SkPicture> MakeFromData(const void* data, size_t size,
                                          const SkDeserialProcs* procs = nullptr);
 
+    /** Recreates SkPicture that was serialized into data, reading it in place. Unlike
+        MakeFromData(), the op stream, the flattened paints and paths, and encoded images are not
+        copied: the returned SkPicture plays back directly from data and keeps a reference to it.
+        Images are decoded on first draw.
+
+        This is intended for data returned by SkData::MakeFromFD() or SkData::MakeFromFileName(),
+        where loading a large SKP then costs little more than mapping it. data must not change
+        while the returned SkPicture is alive. Sections that are not 4-byte aligned in data
+        (e.g. in SKPs written before version 69) are copied, as by MakeFromData().
+
+        @param data   container for serial data; must stay unchanged while the SkPicture lives
+        @param procs  custom serial data decoders; may be nullptr
+        @return       SkPicture constructed from data
+    */
+    static sk_sp<SkPicture> MakeFromMappedData(sk_sp<SkData> data,
+                                               const SkDeserialProcs* procs = nullptr);
+
     /** \class SkPicture::AbortCallback
         AbortCallback is an abstract class. An implementation of AbortCallback may
         passed as a parameter to SkPicture::playback, to stop it before all drawing
@@ -218,12 +235,15 @@ private:
     SkPicture();
     friend class SkBigPicture;
     friend class SkEmptyPicture;
+    friend class SkMappedPicture;
     friend class SkPicturePriv;
     template <typename> friend class SkMiniPicture;
 
     void serialize(SkWStream*, const SkSerialProcs*, class SkRefCntSet* typefaces) const;
+    // If mapping is not null, it holds the bytes behind stream, which is read in place.
     static sk_sp<SkPicture> MakeFromStream(SkStream*, const SkDeserialProcs*,
-                                           class SkTypefacePlayback*);
+                                           class SkTypefacePlayback*,
+                                           const SkData* mapping = nullptr);
     friend class SkPictureData;
 
     /** Return true if the SkStream/Buffer represents a serialized picture, and
@@ -277,10 +297,11 @@ private:
     // V66: Add saveBehind
     // V67: Blobs serialize fonts instead of paints
     // V68: Paint doesn't serialize font-related stuff
+    // V69: Stream sections may be preceded by padding, so they can be read in place
 
     // Only SKPs within the min/current picture version range (inclusive) can be read.
     static const uint32_t     MIN_PICTURE_VERSION = 56;     // august 2017
-    static const uint32_t CURRENT_PICTURE_VERSION = 68;
+    static const uint32_t CURRENT_PICTURE_VERSION = 69;
 
     static_assert(MIN_PICTURE_VERSION <= 62, "Remove kFontAxes_bad from SkFontDescriptor.cpp");
 
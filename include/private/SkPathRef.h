@@ -14,12 +14,14 @@
 #include "SkRRect.h"
 #include "SkRect.h"
 #include "SkRefCnt.h"
+#include "SkSpinlock.h"
 #include "SkTDArray.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 #include <atomic>
 #include <limits>
 
+class SkEdgeCache;
 class SkRBuffer;
 class SkWBuffer;
 
@@ -541,6 +543,11 @@ private:
 
     void callGenIDChangeListeners();
 
+    // The edges SkEdgeBuilder cached for this path ref, reffed, or null. Changing the genID drops
+    // them.
+    SkEdgeCache* refEdgeCache() const;
+    void setEdgeCache(SkEdgeCache* cache) const;
+
     enum {
         kMinSize = 256,
     };
@@ -563,6 +570,9 @@ private:
     SkMutex                         fGenIDChangeListenersMutex;
     SkTDArray<GenIDChangeListener*> fGenIDChangeListeners;  // pointers are reffed
 
+    mutable SkSpinlock   fEdgeCacheLock;
+    mutable SkEdgeCache* fEdgeCache = nullptr;  // reffed, guarded by fEdgeCacheLock
+
     mutable uint8_t  fBoundsIsDirty;
     mutable bool     fIsFinite;    // only meaningful if bounds are valid
 
@@ -8,17 +8,21 @@
 #ifndef Skottie_DEFINED
 #define Skottie_DEFINED
 
+#include "SkExecutor.h"
 #include "SkFontMgr.h"
 #include "SkRefCnt.h"
 #include "SkSize.h"
 #include "SkString.h"
 #include "SkTypes.h"
 
+#include <functional>
 #include <memory>
 
 class SkCanvas;
 class SkData;
 class SkImage;
+struct SkImageInfo;
+class SkPixmap;
 struct SkRect;
 class SkStream;
 
@@ -163,6 +167,12 @@ public:
          */
         Builder& setMarkerObserver(sk_sp<MarkerObserver>);
 
+        /**
+         * Keep the JSON, the ResourceProvider and the font manager alive in the animations this
+         * builds, so that Animation::renderFrames() can build copies of them. Off by default.
+         */
+        Builder& setRetainSource(bool);
+
         /**
          * Animation factories.
          */
@@ -171,12 +181,17 @@ public:
         sk_sp<Animation> makeFromFile(const char path[]);
 
     private:
+        friend class Animation;
+
+        sk_sp<Animation> makeFromData(sk_sp<SkData>);
+
         sk_sp<ResourceProvider> fResourceProvider;
         sk_sp<SkFontMgr>        fFontMgr;
         sk_sp<PropertyObserver> fPropertyObserver;
         sk_sp<Logger>           fLogger;
         sk_sp<MarkerObserver>   fMarkerObserver;
         Stats                   fStats;
+        bool                    fRetainSource = false;
     };
 
     /**
@@ -216,6 +231,41 @@ public:
      */
     void seek(SkScalar t);
 
+    /**
+     * A run of frames for renderFrames().
+     */
+    struct FrameSequence {
+        int   fFirstFrame   = 0;  // Frames are counted at fFps from the start of the animation.
+        int   fFrameCount   = 0;
+        float fFps          = 30;
+        int   fWorkers      = 1;  // Frames rendered at once, each by its own animation copies.
+        int   fFramesPerRun = 8;  // Consecutive frames each worker renders in turn.
+    };
+
+    /**
+     * Receives a rendered frame. Return false to stop the sequence.
+     */
+    using FrameProc = std::function<bool(int frame, const SkPixmap&)>;
+
+    /**
+     * Renders a sequence of frames into raster pixels described by info (scaled to fit, as
+     * render() with a destination rect), passing each to proc in order, on the calling thread.
+     *
+     * Each worker renders runs of fFramesPerRun frames on the executor, with two copies of the
+     * animation built again from its JSON: while one rasterizes frame N, the other seeks and
+     * revalidates frame N+1. Both run on the executor, so it needs 2 * fWorkers threads for
+     * seeking to overlap rasterizing; with fewer, a worker seeks after rasterizing instead.
+     * Up to fWorkers * fFramesPerRun frames are held in memory at once. The ResourceProvider's
+     * image assets may be used from several threads.
+     *
+     * This animation itself is not changed. It must have been built with
+     * Builder::setRetainSource(true).
+     *
+     * @return false if proc stopped the sequence, or the animation could not be copied.
+     */
+    bool renderFrames(const FrameSequence&, const SkImageInfo& info, const FrameProc& proc,
+                      SkExecutor& executor = SkExecutor::GetDefault()) const;
+
     /**
      * Returns the animation duration in seconds.
      */
@@ -234,6 +284,9 @@ private:
     Animation(std::unique_ptr<sksg::Scene>, SkString ver, const SkSize& size,
               SkScalar inPoint, SkScalar outPoint, SkScalar duration, uint32_t flags = 0);
 
+    // Seeks to a frame of a FrameSequence, and revalidates the scene ready to render.
+    void prepareFrame(int frame, float fps);
+
     std::unique_ptr<sksg::Scene> fScene;
     const SkString               fVersion;
     const SkSize                 fSize;
@@ -242,6 +295,12 @@ private:
                                  fDuration;
     const uint32_t               fFlags;
 
+    // What it takes to build copies of the animation, for renderFrames(). Only kept if the
+    // Builder was asked to retain them.
+    sk_sp<SkData>                fJson;
+    sk_sp<ResourceProvider>      fResourceProvider;
+    sk_sp<SkFontMgr>             fFontMgr;
+
     typedef SkNVRefCnt<Animation> INHERITED;
 };
 
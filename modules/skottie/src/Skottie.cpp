@@ -7,6 +7,7 @@
 
 #include "Skottie.h"
 
+#include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkData.h"
 #include "SkFontMgr.h"
@@ -22,7 +23,9 @@
 #include "SkSGScene.h"
 #include "SkSGTransform.h"
 #include "SkStream.h"
+#include "SkSurface.h"
 #include "SkTArray.h"
+#include "SkTaskGroup.h"
 #include "SkTo.h"
 #include "SkottieAdapter.h"
 #include "SkottieJson.h"
@@ -33,6 +36,7 @@
 
 #include <chrono>
 #include <cmath>
+#include <vector>
 
 #include "stdlib.h"
 
@@ -425,6 +429,11 @@ Animation::Builder& Animation::Builder::setLogger(sk_sp<Logger> logger) {
     return *this;
 }
 
+Animation::Builder& Animation::Builder::setRetainSource(bool retain) {
+    fRetainSource = retain;
+    return *this;
+}
+
 Animation::Builder& Animation::Builder::setMarkerObserver(sk_sp<MarkerObserver> mobserver) {
     fMarkerObserver = std::move(mobserver);
     return *this;
@@ -447,12 +456,21 @@ sk_sp<Animation> Animation::Builder::make(SkStream* stream) {
         return nullptr;
     }
 
-    return this->make(static_cast<const char*>(data->data()), data->size());
+    return this->makeFromData(std::move(data));
 }
 
 sk_sp<Animation> Animation::Builder::make(const char* data, size_t data_len) {
+    // Only copy the JSON if the animation is going to keep it.
+    return this->makeFromData(fRetainSource ? SkData::MakeWithCopy(data, data_len)
+                                            : SkData::MakeWithoutCopy(data, data_len));
+}
+
+sk_sp<Animation> Animation::Builder::makeFromData(sk_sp<SkData> json_data) {
     TRACE_EVENT0("skottie", TRACE_FUNC);
 
+    const auto* data     = static_cast<const char*>(json_data->data());
+    const size_t data_len = json_data->size();
+
     // Sanitize factory args.
     class NullResourceProvider final : public ResourceProvider {
         sk_sp<SkData> load(const char[], const char[]) const override { return nullptr; }
@@ -519,19 +537,26 @@ sk_sp<Animation> Animation::Builder::make(const char* data, size_t data_len) {
         flags |= Flags::kRequiresTopLevelIsolation;
     }
 
-    return sk_sp<Animation>(new Animation(std::move(scene),
-                                          std::move(version),
-                                          size,
-                                          inPoint,
-                                          outPoint,
-                                          duration,
-                                          flags));
+    sk_sp<Animation> animation(new Animation(std::move(scene),
+                                             std::move(version),
+                                             size,
+                                             inPoint,
+                                             outPoint,
+                                             duration,
+                                             flags));
+    if (fRetainSource) {
+        animation->fJson             = std::move(json_data);
+        animation->fResourceProvider = fResourceProvider;
+        animation->fFontMgr          = fFontMgr;
+    }
+
+    return animation;
 }
 
 sk_sp<Animation> Animation::Builder::makeFromFile(const char path[]) {
-    const auto data = SkData::MakeFromFileName(path);
+    auto data = SkData::MakeFromFileName(path);
 
-    return data ? this->make(static_cast<const char*>(data->data()), data->size())
+    return data ? this->makeFromData(std::move(data))
                 : nullptr;
 }
 
@@ -595,6 +620,102 @@ void Animation::seek(SkScalar t) {
     fScene->animate(fInPoint + SkTPin(t, 0.0f, 1.0f) * (fOutPoint - fInPoint));
 }
 
+void Animation::prepareFrame(int frame, float fps) {
+    this->seek(fDuration > 0 ? frame / (fps * fDuration) : 0);
+    if (fScene) {
+        fScene->revalidate();
+    }
+}
+
+bool Animation::renderFrames(const FrameSequence& sequence, const SkImageInfo& info,
+                             const FrameProc& proc, SkExecutor& executor) const {
+    TRACE_EVENT0("skottie", TRACE_FUNC);
+
+    if (sequence.fFrameCount <= 0) {
+        return true;
+    }
+    if (!fJson || sequence.fFps <= 0 || info.isEmpty()) {
+        return false;
+    }
+
+    const int workers      = SkTMax(sequence.fWorkers, 1),
+              framesPerRun = SkTMax(sequence.fFramesPerRun, 1),
+              framesPerPass = workers * framesPerRun,
+              endFrame     = sequence.fFirstFrame + sequence.fFrameCount;
+
+    // Two copies for each worker: one to rasterize, the other to seek ahead. Observers and
+    // loggers are left out; they have heard everything already from this animation.
+    std::vector<sk_sp<Animation>> copies(workers * 2);
+    SkTaskGroup tasks(executor);
+    tasks.batch(SkToInt(copies.size()), [this, &copies](int i) {
+        copies[i] = Builder().setResourceProvider(fResourceProvider)
+                             .setFontManager(fFontMgr)
+                             .makeFromData(fJson);
+    });
+    tasks.wait();
+    for (const auto& copy : copies) {
+        if (!copy || !copy->fScene) {
+            return false;
+        }
+    }
+
+    std::vector<SkBitmap> frames(framesPerPass);
+    std::vector<sk_sp<SkSurface>> surfaces(framesPerPass);
+    for (int i = 0; i < framesPerPass; ++i) {
+        if (!frames[i].tryAllocPixels(info)) {
+            return false;
+        }
+        const auto& pixmap = frames[i].pixmap();
+        surfaces[i] = SkSurface::MakeRasterDirect(pixmap.info(), pixmap.writable_addr(),
+                                                  pixmap.rowBytes());
+        if (!surfaces[i]) {
+            return false;
+        }
+    }
+
+    const auto dst = SkRect::MakeIWH(info.width(), info.height());
+    for (int passStart = sequence.fFirstFrame; passStart < endFrame; passStart += framesPerPass) {
+        tasks.batch(workers, [&](int worker) {
+            const int runStart = passStart + worker * framesPerRun,
+                      runEnd   = SkTMin(runStart + framesPerRun, endFrame);
+            if (runStart >= runEnd) {
+                return;
+            }
+
+            Animation* anims[2] = { copies[worker * 2].get(), copies[worker * 2 + 1].get() };
+            anims[0]->prepareFrame(runStart, sequence.fFps);
+
+            for (int frame = runStart; frame < runEnd; ++frame) {
+                Animation* current = anims[(frame - runStart) & 1];
+                Animation* next    = anims[(frame - runStart + 1) & 1];
+
+                SkTaskGroup ahead(executor);
+                if (frame + 1 < runEnd) {
+                    ahead.add([next, frame, &sequence]() {
+                        next->prepareFrame(frame + 1, sequence.fFps);
+                    });
+                }
+
+                SkCanvas* canvas = surfaces[frame - passStart]->getCanvas();
+                canvas->clear(SK_ColorTRANSPARENT);
+                current->render(canvas, &dst, RenderFlag::kSkipTopLevelIsolation);
+
+                ahead.wait();
+            }
+        });
+        tasks.wait();
+
+        const int passEnd = SkTMin(passStart + framesPerPass, endFrame);
+        for (int frame = passStart; frame < passEnd; ++frame) {
+            if (!proc(frame, frames[frame - passStart].pixmap())) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 sk_sp<Animation> Animation::Make(const char* data, size_t length) {
     return Builder().make(data, length);
 }
@@ -5,6 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkMatrix.h"
 #include "Skottie.h"
 #include "SkottieProperty.h"
@@ -281,3 +284,93 @@ DEF_TEST(Skottie_Shaper, reporter) {
         }
     }
 }
+
+DEF_TEST(Skottie_RenderFrames, reporter) {
+    static constexpr char json[] = R"({
+                                     "v": "5.2.1",
+                                     "w": 32,
+                                     "h": 32,
+                                     "fr": 10,
+                                     "ip": 0,
+                                     "op": 10,
+                                     "layers": [
+                                       {
+                                         "ty": 1,
+                                         "ip": 0,
+                                         "op": 10,
+                                         "sw": 32,
+                                         "sh": 32,
+                                         "sc": "#ff0000",
+                                         "ks": {
+                                           "o": {
+                                             "a": 1,
+                                             "k": [
+                                               {
+                                                 "t": 0, "s": [0], "e": [100],
+                                                 "i": { "x": [1], "y": [1] },
+                                                 "o": { "x": [0], "y": [0] }
+                                               },
+                                               { "t": 10 }
+                                             ]
+                                           }
+                                         }
+                                       }
+                                     ]
+                                   })";
+
+    // Animations don't keep their JSON unless asked to, and can't be copied without it.
+    const auto info = SkImageInfo::MakeN32Premul(16, 16);
+    auto unretained = Animation::Make(json, strlen(json));
+    REPORTER_ASSERT(reporter, unretained);
+    Animation::FrameSequence one;
+    one.fFrameCount = 1;
+    REPORTER_ASSERT(reporter, !unretained->renderFrames(one, info,
+        [](int, const SkPixmap&) { return true; }));
+
+    SkMemoryStream stream(json, strlen(json));
+    auto animation = Animation::Builder().setRetainSource(true).make(&stream);
+    REPORTER_ASSERT(reporter, animation);
+
+    const auto dst = SkRect::MakeIWH(info.width(), info.height());
+    static constexpr float kFps = 20;
+
+    Animation::FrameSequence sequence;
+    sequence.fFirstFrame   = 1;
+    sequence.fFrameCount   = 15;
+    sequence.fFps          = kFps;
+    sequence.fWorkers      = 2;
+    sequence.fFramesPerRun = 3;
+
+    // Every frame comes back once, in order, and matches seeking and rendering one at a time.
+    auto executor = SkExecutor::MakeFIFOThreadPool(2);
+    int expectedFrame = sequence.fFirstFrame;
+    const bool finished = animation->renderFrames(sequence, info,
+        [&](int frame, const SkPixmap& pixmap) {
+            REPORTER_ASSERT(reporter, frame == expectedFrame++);
+
+            SkBitmap expected;
+            expected.allocPixels(info);
+            SkCanvas canvas(expected);
+            canvas.clear(SK_ColorTRANSPARENT);
+            animation->seek(frame / (kFps * animation->duration()));
+            animation->render(&canvas, &dst, Animation::RenderFlag::kSkipTopLevelIsolation);
+
+            REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), pixmap.addr(),
+                                                  info.computeMinByteSize()),
+                            "frame %d", frame);
+            return true;
+        }, *executor);
+    REPORTER_ASSERT(reporter, finished);
+    REPORTER_ASSERT(reporter, expectedFrame == sequence.fFirstFrame + sequence.fFrameCount);
+
+    // Pixels that can't back a surface fail up front, without rendering anything.
+    REPORTER_ASSERT(reporter, !animation->renderFrames(sequence,
+        info.makeColorType(kUnknown_SkColorType),
+        [&](int, const SkPixmap&) { REPORTER_ASSERT(reporter, false); return true; }, *executor));
+
+    // The sequence stops when asked to.
+    int delivered = 0;
+    REPORTER_ASSERT(reporter, !animation->renderFrames(sequence, info,
+        [&](int, const SkPixmap&) { return ++delivered < 4; }));
+    REPORTER_ASSERT(reporter, delivered == 4);
+}
@@ -6,7 +6,9 @@
  */
 
 #include "CommandLineFlags.h"
+#include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkExecutor.h"
 #include "SkGraphics.h"
 #include "SkMakeUnique.h"
 #include "SkOSFile.h"
@@ -17,6 +19,8 @@
 #include "Skottie.h"
 #include "SkottieUtils.h"
 
+#include <chrono>
+#include <cmath>
 #include <vector>
 
 static DEFINE_string2(input    , i, nullptr, "Input .json file.");
@@ -30,6 +34,10 @@ static DEFINE_double(fps, 30, "Decode frames per second.");
 static DEFINE_int(width , 800, "Render width.");
 static DEFINE_int(height, 600, "Render height.");
 
+static DEFINE_int(workers, 0, "Render png frames this many at a time, on twice as many threads "
+                           "(0 renders them in turn).");
+static DEFINE_bool(bench, false, "Time rendering the frames, without writing them out.");
+
 namespace {
 
 class Sink {
@@ -160,7 +168,7 @@ int main(int argc, char** argv) {
     CommandLineFlags::Parse(argc, argv);
     SkAutoGraphics ag;
 
-    if (FLAGS_input.isEmpty() || FLAGS_writePath.isEmpty()) {
+    if (FLAGS_input.isEmpty() || (FLAGS_writePath.isEmpty() && !FLAGS_bench)) {
         SkDebugf("Missing required 'input' and 'writePath' args.\n");
         return 1;
     }
@@ -170,7 +178,12 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    if (!sk_mkdir(FLAGS_writePath[0])) {
+    if (!FLAGS_bench && !sk_mkdir(FLAGS_writePath[0])) {
+        return 1;
+    }
+
+    if (FLAGS_workers > 0 && 0 != strcmp(FLAGS_format[0], "png")) {
+        SkDebugf("Only png frames can be rendered on several threads.\n");
         return 1;
     }
 
@@ -188,6 +201,7 @@ int main(int argc, char** argv) {
 
     auto anim = skottie::Animation::Builder()
             .setLogger(logger)
+            .setRetainSource(FLAGS_workers > 0)
             .setResourceProvider(
                 skottie_utils::FileResourceProvider::Make(SkOSPath::Dirname(FLAGS_input[0])))
             .makeFromFile(FLAGS_input[0]);
@@ -203,10 +217,59 @@ int main(int argc, char** argv) {
                t1 = SkTPin(FLAGS_t1,  t0, 1.0),
                advance = 1 / std::min(anim->duration() * FLAGS_fps, kMaxFrames);
 
+    const auto start = std::chrono::steady_clock::now();
     size_t frame_index = 0;
-    for (auto t = t0; t <= t1; t += advance) {
-        anim->seek(t);
-        sink->handleFrame(anim, frame_index++);
+
+    if (FLAGS_workers > 0) {
+        skottie::Animation::FrameSequence sequence;
+        sequence.fFps        = static_cast<float>(1 / (advance * anim->duration()));
+        sequence.fFirstFrame = static_cast<int>(std::round(t0 / advance));
+        sequence.fFrameCount = static_cast<int>((t1 - t0) / advance) + 1;
+        sequence.fWorkers    = FLAGS_workers;
+
+        // A thread for each worker to rasterize, and another for it to seek ahead.
+        auto executor = SkExecutor::MakeFIFOThreadPool(FLAGS_workers * 2);
+        anim->renderFrames(sequence, SkImageInfo::MakeN32Premul(FLAGS_width, FLAGS_height),
+                           [&](int, const SkPixmap& pixmap) {
+            frame_index++;
+            if (FLAGS_bench) {
+                return true;
+            }
+
+            const auto frame_file = SkStringPrintf("0%06d.png", frame_index - 1);
+            SkFILEWStream stream(SkOSPath::Join(FLAGS_writePath[0], frame_file.c_str()).c_str());
+            SkBitmap bitmap;
+            bitmap.installPixels(pixmap);
+            auto png_data = SkImage::MakeFromBitmap(bitmap)->encodeToData();
+            if (!stream.isValid() || !png_data) {
+                SkDebugf("Could not write '%s/%s'.\n", FLAGS_writePath[0], frame_file.c_str());
+                return false;
+            }
+            return stream.write(png_data->data(), png_data->size());
+        }, *executor);
+    } else {
+        // Benchmarking renders to a surface of its own, as renderFrames() does, and skips encoding.
+        const auto dst = SkRect::MakeIWH(FLAGS_width, FLAGS_height);
+        auto surface = FLAGS_bench ? SkSurface::MakeRasterN32Premul(FLAGS_width, FLAGS_height)
+                                   : nullptr;
+        for (auto t = t0; t <= t1; t += advance) {
+            anim->seek(t);
+            if (surface) {
+                surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+                anim->render(surface->getCanvas(), &dst);
+            } else if (!FLAGS_bench) {
+                sink->handleFrame(anim, frame_index);
+            }
+            frame_index++;
+        }
+    }
+
+    if (FLAGS_bench) {
+        const std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start;
+        SkDebugf("Rendered %zu frames in %.1f ms (%.1f fps) on %d worker%s.\n",
+                 frame_index, elapsed.count(), frame_index * 1000 / elapsed.count(),
+                 FLAGS_workers, FLAGS_workers == 1 ? "" : "s");
     }
 
     return 0;
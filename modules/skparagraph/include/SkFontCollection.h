@@ -20,10 +20,13 @@
 #include <string>
 #include "../../include/private/SkTHash.h" // TODO: Figure out how to deal with it in Flutter engine
 #include "SkFontMgr.h"
+#include "SkMutex.h"
 #include "SkRefCnt.h"
 #include "SkTextStyle.h"
 #include "SkFontMgr.h"
 
+// Paragraphs laid out on several threads may share a font collection; set up its font
+// managers before then.
 class SkFontCollection : public SkRefCnt {
   public:
     SkFontCollection();
@@ -68,6 +71,7 @@ class SkFontCollection : public SkRefCnt {
     };
 
     bool fEnableFontFallback;
+    SkMutex fTypefacesMutex;
     SkTHashMap<FamilyKey, sk_sp<SkTypeface>, FamilyKey::Hasher> fTypefaces;
     sk_sp<SkFontMgr> fDefaultFontManager;
     sk_sp<SkFontMgr> fAssetFontManager;
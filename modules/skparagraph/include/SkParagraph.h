@@ -8,6 +8,7 @@
 #pragma once
 
 #include <vector>
+#include "SkExecutor.h"
 #include "SkTextStyle.h"
 #include "SkParagraphStyle.h"
 #include "SkFontCollection.h"
@@ -50,6 +51,18 @@ class SkParagraph {
 
   virtual bool layout(double width) = 0;
 
+  // Replaces the utf8 text between from and to with text, which takes the style of the first
+  // character it replaces, or when inserting, of the text it follows (or precedes, at 0). The
+  // next layout only reshapes the lines of text (between hard line breaks) that the edit touched.
+  virtual void updateText(size_t from, size_t to, const std::string& text) = 0;
+
+  // Lays out all the paragraphs at the same width, spread over the executor's threads, and
+  // returns when they are all done. Paragraphs are independent, and may share font collections;
+  // each one must appear only once.
+  static void LayoutAll(const std::vector<SkParagraph*>& paragraphs,
+                        double width,
+                        SkExecutor& executor = SkExecutor::GetDefault());
+
   virtual void paint(SkCanvas* canvas, double x, double y) = 0;
 
   // Returns a vector of bounding boxes that enclose all text between
@@ -105,9 +105,12 @@ sk_sp<SkTypeface> SkFontCollection::findTypeface(const std::string& familyName,
 
   // Look inside the font collections cache first
   FamilyKey familyKey(familyName, "en", fontStyle);
-  auto found = fTypefaces.find(familyKey);
-  if (found) {
-    return *found;
+  {
+    SkAutoMutexAcquire lock(fTypefacesMutex);
+    auto found = fTypefaces.find(familyKey);
+    if (found) {
+      return *found;
+    }
   }
 
   sk_sp<SkTypeface> typeface = nullptr;
@@ -138,6 +141,8 @@ sk_sp<SkTypeface> SkFontCollection::findTypeface(const std::string& familyName,
       return typeface;
   }
 
+  // Another thread may have found it too; either will do
+  SkAutoMutexAcquire lock(fTypefacesMutex);
   fTypefaces.set(familyKey, typeface);
 
   return typeface;
@@ -6,6 +6,7 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <unicode/brkiter.h>
 #include <SkBlurTypes.h>
 #include <SkFontMgr.h>
@@ -17,6 +18,7 @@
 #include "SkDiscretePathEffect.h"
 #include "SkCanvas.h"
 #include "SkMaskFilter.h"
+#include "SkTaskGroup.h"
 #include "SkUTF.h"
 
 namespace {
@@ -32,7 +34,7 @@ namespace {
   SkSpan<const char> operator*(const SkSpan<const char>& a, const SkSpan<const char>& b) {
     auto begin = SkTMax(a.begin(), b.begin());
     auto end = SkTMin(a.end(), b.end());
-    return SkSpan<const char>(begin, end - begin);
+    return SkSpan<const char>(begin, end > begin ? end - begin : 0);
   }
 
   static inline SkUnichar utf8_next(const char** ptr, const char* end) {
@@ -53,22 +55,38 @@ SkParagraph::SkParagraph(const std::u16string& utf16text, SkParagraphStyle style
   fUtf8 = SkSpan<const char>(str.data(), str.size());
 }
 
+void SkParagraph::LayoutAll(const std::vector<SkParagraph*>& paragraphs,
+                            double width,
+                            SkExecutor& executor) {
+
+  // A task for each paragraph would cost about as much as laying out a short one
+  constexpr size_t kParagraphsPerTask = 8;
+  size_t tasks = (paragraphs.size() + kParagraphsPerTask - 1) / kParagraphsPerTask;
+
+  SkTaskGroup taskGroup(executor);
+  taskGroup.batch(SkToInt(tasks), [&paragraphs, width](int task) {
+    size_t start = task * kParagraphsPerTask;
+    size_t end = SkTMin(start + kParagraphsPerTask, paragraphs.size());
+    for (size_t i = start; i < end; ++i) {
+      paragraphs[i]->layout(width);
+    }
+  });
+  taskGroup.wait();
+}
+
 SkParagraphImpl::~SkParagraphImpl() = default;
 
+// Resets everything that depends on the width; the shaped runs stay
 void SkParagraphImpl::resetContext() {
   
   fAlphabeticBaseline = 0;
   fHeight = 0;
   fWidth = 0;
   fIdeographicBaseline = 0;
-  fMaxIntrinsicWidth = 0;
   fMinIntrinsicWidth = 0;
   fMaxLineWidth = 0;
 
   fPicture = nullptr;
-  fRuns.reset();
-  fClusters.reset();
-  fIndexes.reset();
   fTextWrapper.reset();
 }
 
@@ -78,11 +96,20 @@ bool SkParagraphImpl::layout(double doubleWidth) {
 
   this->resetContext();
 
-  this->shapeTextIntoEndlessLine(fUtf8, SkSpan<SkBlock>(fTextStyles.begin(), fTextStyles.size()));
+  if (fSpans.empty() || fRunsJustified) {
+    // Shape all the text: the first time, or when justification has moved the glyphs
+    this->resetSpans();
+  }
+
+  // When only the width changed there is nothing to shape, and the clusters are still good
+  if (this->shapeDirtySpans()) {
 
-  this->buildClusterTable();
+    fClusters.reset();
+    fIndexes.reset();
+    this->buildClusterTable();
 
-  this->markClustersWithLineBreaks();
+    this->markClustersWithLineBreaks();
+  }
 
   this->breakShapedTextIntoLines(width);
 
@@ -94,6 +121,152 @@ bool SkParagraphImpl::layout(double doubleWidth) {
   return true;
 }
 
+void SkParagraphImpl::updateText(size_t from, size_t to, const std::string& text) {
+
+  from = SkTMin(from, fText.size());
+  to = SkTPin(to, from, fText.size());
+  ptrdiff_t delta = (ptrdiff_t)text.size() - (ptrdiff_t)(to - from);
+
+  // Style offsets before the text moves. Replaced text is cut out of the blocks, and the new
+  // text goes to the block of the first replaced character, or when inserting, to the block it
+  // follows (the first block at 0), so that the blocks still cover all the text
+  auto newStart = [from, to, delta, &text](size_t pos) {
+    return pos < from ? pos : pos >= to ? pos + delta : from + text.size();
+  };
+  auto newEnd = [from, to, delta](size_t pos) {
+    return pos <= from ? pos : pos >= to ? pos + delta : from;
+  };
+  std::vector<Block> blocks;
+  bool placed = false;
+  for (auto& block : fTextStyles) {
+    size_t oldStart = block.text().begin() - fUtf8.begin();
+    size_t oldEnd = block.text().end() - fUtf8.begin();
+    size_t start = newStart(oldStart);
+    size_t end = newEnd(oldEnd);
+    bool owner = from < to ? oldStart <= from && from < oldEnd
+                           : from == 0 ? oldStart == 0 : oldStart < from && from <= oldEnd;
+    if (owner && !placed) {
+      start = SkTMin(start, from);
+      end = SkTMax(end, from + text.size());
+      placed = true;
+    }
+    if (start < end) {
+      blocks.emplace_back(start, end, block.style());
+    }
+  }
+
+  // The spans from the one with from to the one with to (so that removing a line break joins
+  // two spans) have to be shaped again; the ones after just move
+  size_t first = 0;
+  size_t last = 0;
+  size_t regionStart = 0;
+  size_t regionEnd = 0;
+  if (!fSpans.empty()) {
+    first = this->findSpan(from);
+    last = this->findSpan(to);
+    regionStart = fSpans[first].fStart;
+    regionEnd = fSpans[last].fEnd + delta;
+    for (size_t i = last + 1; i < SkToSizeT(fSpans.count()); ++i) {
+      auto& span = fSpans[i];
+      span.fStart += delta;
+      span.fEnd += delta;
+      for (size_t r = span.fRunStart; r < span.fRunStart + span.fRunCount; ++r) {
+        fRuns[r].moveText(delta);
+      }
+    }
+  }
+
+  fText.replace(from, to - from, text);
+  fUtf8 = SkSpan<const char>(fText.data(), fText.size());
+
+  fTextStyles.reset();
+  for (auto& block : blocks) {
+    fTextStyles.emplace_back(SkSpan<const char>(fUtf8.begin() + block.fStart, block.fEnd - block.fStart),
+                             block.fStyle);
+  }
+
+  if (!fSpans.empty()) {
+    SkTArray<ShapedSpan, true> spans;
+    spans.push_back_n(first, fSpans.begin());
+    this->splitIntoSpans(regionStart, regionEnd, &spans);
+    spans.push_back_n(fSpans.count() - last - 1, fSpans.begin() + last + 1);
+    fSpans = std::move(spans);
+  }
+
+  // Clusters and lines point into the old text
+  fClusters.reset();
+  fIndexes.reset();
+  this->resetContext();
+}
+
+void SkParagraphImpl::resetSpans() {
+
+  fSpans.reset();
+  this->splitIntoSpans(0, fUtf8.size(), &fSpans);
+  fRunsJustified = false;
+
+  fRuns.reset();
+  fClusters.reset();
+  fIndexes.reset();
+  fMaxIntrinsicWidth = 0;
+}
+
+void SkParagraphImpl::splitIntoSpans(size_t start, size_t end, SkTArray<ShapedSpan, true>* spans) const {
+
+  while (start < end) {
+    auto lineBreak = static_cast<const char*>(memchr(fUtf8.begin() + start, '\n', end - start));
+    size_t spanEnd = lineBreak ? lineBreak - fUtf8.begin() + 1 : end;
+    spans->push_back({ start, spanEnd, 0, 0, 0, 0, true });
+    start = spanEnd;
+  }
+}
+
+size_t SkParagraphImpl::findSpan(size_t pos) const {
+
+  for (size_t i = 0; i < SkToSizeT(fSpans.count()); ++i) {
+    if (pos < fSpans[i].fEnd) {
+      return i;
+    }
+  }
+  return fSpans.count() - 1;
+}
+
+bool SkParagraphImpl::shapeDirtySpans() {
+
+  bool dirty = false;
+  for (auto& span : fSpans) {
+    dirty |= span.fDirty;
+  }
+  if (!dirty) {
+    return false;
+  }
+
+  // Shaped spans keep their runs, moved along to where the span starts now
+  SkTArray<SkRun> runs;
+  SkScalar offsetX = 0;
+  for (auto& span : fSpans) {
+    size_t runStart = runs.size();
+    if (span.fDirty) {
+      SkSpan<const char> text(fUtf8.begin() + span.fStart, span.fEnd - span.fStart);
+      span.fAdvance = this->shapeTextIntoEndlessLine(text, offsetX, &runs);
+      span.fDirty = false;
+    } else {
+      for (size_t r = span.fRunStart; r < span.fRunStart + span.fRunCount; ++r) {
+        auto& run = runs.emplace_back(std::move(fRuns[r]));
+        run.moveX(offsetX - span.fOffsetX);
+      }
+    }
+    span.fRunStart = runStart;
+    span.fRunCount = runs.size() - runStart;
+    span.fOffsetX = offsetX;
+    offsetX += span.fAdvance;
+  }
+
+  fRuns = std::move(runs);
+  fMaxIntrinsicWidth = offsetX;
+  return true;
+}
+
 void SkParagraphImpl::paint(SkCanvas* canvas, double x, double y) {
 
   if (fRuns.empty()) {
@@ -412,7 +585,7 @@ void SkParagraphImpl::buildClusterTable() {
   }
 }
 
-void SkParagraphImpl::shapeTextIntoEndlessLine(SkSpan<const char> text, SkSpan<SkBlock> styles) {
+SkScalar SkParagraphImpl::shapeTextIntoEndlessLine(SkSpan<const char> text, SkScalar offsetX, SkTArray<SkRun>* runs) {
 
  class MultipleFontRunIterator final : public SkShaper::FontRunIterator {
    public:
@@ -502,8 +675,10 @@ void SkParagraphImpl::shapeTextIntoEndlessLine(SkSpan<const char> text, SkSpan<S
   class ShapeHandler final : public SkShaper::RunHandler {
 
    public:
-    explicit ShapeHandler(SkParagraphImpl& paragraph)
-        : fParagraph(&paragraph)
+    ShapeHandler(SkTArray<SkRun>* runs, SkScalar offsetX, size_t utf8Offset)
+        : fRuns(runs)
+        , fOffsetX(offsetX)
+        , fUtf8Offset(utf8Offset)
         , fAdvance(SkVector::Make(0, 0)) {}
 
     inline SkVector advance() const { return fAdvance; }
@@ -518,16 +693,18 @@ void SkParagraphImpl::shapeTextIntoEndlessLine(SkSpan<const char> text, SkSpan<S
 
     Buffer runBuffer(const RunInfo& info) override {
 
-      auto& run = fParagraph->fRuns.emplace_back(info, fAdvance.fX);
+      auto& run = fRuns->emplace_back(info, fOffsetX + fAdvance.fX);
       return run.newRunBuffer();
     }
 
     void commitRunBuffer(const RunInfo&) override {
-      auto& run = fParagraph->fRuns.back();
+      auto& run = fRuns->back();
       if (run.size() == 0) {
-        fParagraph->fRuns.pop_back();
+        fRuns->pop_back();
         return;
       }
+      // The shaper only saw this span of the text
+      run.moveText(fUtf8Offset);
       // Carve out the line text out of the entire run text
       fAdvance.fX += run.advance().fX;
       fAdvance.fY = SkMaxScalar(fAdvance.fY, run.descent() + run.leading() - run.ascent());
@@ -535,18 +712,31 @@ void SkParagraphImpl::shapeTextIntoEndlessLine(SkSpan<const char> text, SkSpan<S
 
     void commitLine() override { }
 
-    SkParagraphImpl* fParagraph;
+    SkTArray<SkRun>* fRuns;
+    SkScalar fOffsetX;
+    size_t fUtf8Offset;
     SkVector fAdvance;
   };
 
+  if (text.empty() || fTextStyles.empty()) {
+    return 0;
+  }
+
+  // Start with the style the text starts in
+  auto style = fTextStyles.begin();
+  while (style + 1 < fTextStyles.end() && style->text().end() <= text.begin()) {
+    ++style;
+  }
+  SkSpan<SkBlock> styles(style, fTextStyles.end() - style);
+
   MultipleFontRunIterator font(text, styles, fFontCollection);
-  ShapeHandler handler(*this);
+  ShapeHandler handler(runs, offsetX, text.begin() - fUtf8.begin());
   std::unique_ptr<SkShaper> shaper = SkShaper::MakeShapeThenWrap();
 
-  auto bidi = SkShaper::MakeIcuBiDiRunIterator(fUtf8.begin(), fUtf8.size(),
+  auto bidi = SkShaper::MakeIcuBiDiRunIterator(text.begin(), text.size(),
                           fParagraphStyle.getTextDirection() == SkTextDirection::ltr ? 2 : 1);
-  auto script = SkShaper::MakeHbIcuScriptRunIterator(fUtf8.begin(), fUtf8.size());
-  auto lang = SkShaper::MakeStdLanguageRunIterator(fUtf8.begin(), fUtf8.size());
+  auto script = SkShaper::MakeHbIcuScriptRunIterator(text.begin(), text.size());
+  auto lang = SkShaper::MakeStdLanguageRunIterator(text.begin(), text.size());
 
   shaper->shape(text.begin(), text.size(),
                font,
@@ -556,7 +746,7 @@ void SkParagraphImpl::shapeTextIntoEndlessLine(SkSpan<const char> text, SkSpan<S
                std::numeric_limits<SkScalar>::max(),
                &handler);
 
-  fMaxIntrinsicWidth = handler.advance().fX;
+  return handler.advance().fX;
 }
 
 void SkParagraphImpl::markClustersWithLineBreaks() {
@@ -639,6 +829,7 @@ void SkParagraphImpl::formatLinesByWords(SkScalar maxWidth) {
 
         if (&line != fTextWrapper.getLastLine()) {
           justifyLine(line, maxWidth);
+          fRunsJustified = true;
         } else {
           line.fShift = 0;
         }
@@ -96,7 +96,9 @@ class SkParagraphImpl final: public SkParagraph {
                   SkParagraphStyle style,
                   std::vector<Block> blocks,
                   sk_sp<SkFontCollection> fonts)
-      : SkParagraph(text, style, std::move(fonts)) {
+      : SkParagraph(text, style, std::move(fonts))
+      , fText(text) {
+    fUtf8 = SkSpan<const char>(fText.data(), fText.size());
     fTextStyles.reserve(blocks.size());
     for (auto& block : blocks) {
       fTextStyles.emplace_back(SkSpan<const char>(fUtf8.begin() + block.fStart, block.fEnd - block.fStart),
@@ -109,6 +111,9 @@ class SkParagraphImpl final: public SkParagraph {
                   std::vector<Block> blocks,
                   sk_sp<SkFontCollection> fonts)
       : SkParagraph(utf16text, style, std::move(fonts)) {
+    icu::UnicodeString unicode((UChar*) utf16text.data(), SkToS32(utf16text.size()));
+    unicode.toUTF8String(fText);
+    fUtf8 = SkSpan<const char>(fText.data(), fText.size());
     fTextStyles.reserve(blocks.size());
     for (auto& block : blocks) {
       fTextStyles.emplace_back(SkSpan<const char>(fUtf8.begin() + block.fStart, block.fEnd - block.fStart),
@@ -119,6 +124,7 @@ class SkParagraphImpl final: public SkParagraph {
   ~SkParagraphImpl() override;
 
   bool layout(double width) override;
+  void updateText(size_t from, size_t to, const std::string& text) override;
   void paint(SkCanvas* canvas, double x, double y) override;
   std::vector<SkTextBox> getRectsForRange(
       unsigned start,
@@ -156,9 +162,25 @@ class SkParagraphImpl final: public SkParagraph {
   };
 
 
+  // The text between hard line breaks (or the ends of the text), shaped on its own so that
+  // an edit only has to shape again the spans it touches. Offsets are into fUtf8.
+  struct ShapedSpan {
+    size_t fStart;
+    size_t fEnd;
+    size_t fRunStart;   // The span's runs in fRuns
+    size_t fRunCount;
+    SkScalar fOffsetX;  // Where the span starts on the endless line
+    SkScalar fAdvance;
+    bool fDirty;        // Not shaped since the text changed
+  };
+
   void resetContext();
+  void resetSpans();
+  void splitIntoSpans(size_t start, size_t end, SkTArray<ShapedSpan, true>* spans) const;
+  size_t findSpan(size_t pos) const;
+  bool shapeDirtySpans();
   void buildClusterTable();
-  void shapeTextIntoEndlessLine(SkSpan<const char> text, SkSpan<SkBlock> styles);
+  SkScalar shapeTextIntoEndlessLine(SkSpan<const char> text, SkScalar offsetX, SkTArray<SkRun>* runs);
   void markClustersWithLineBreaks();
   void breakShapedTextIntoLines(SkScalar maxWidth);
   void formatLinesByText(SkScalar maxWidth);
@@ -203,12 +225,15 @@ class SkParagraphImpl final: public SkParagraph {
       std::function<bool(SkRun* run, size_t pos, size_t size, SkRect clip, SkScalar shift)> apply) const;
 
   // Input
+  std::string fText;
   SkTArray<SkBlock> fTextStyles;
 
   // Internal structures
+  SkTArray<ShapedSpan, true> fSpans;
+  bool fRunsJustified = false;  // Justification has moved glyphs; they must be shaped again
   SkTHashMap<const char*, size_t> fIndexes;
   SkTArray<SkCluster> fClusters;
-  SkTArray<SkRun, true> fRuns;
+  SkTArray<SkRun> fRuns;  // SkRun holds SkSTArrays, so it cannot be moved with memcpy
   SkTextWrapper fTextWrapper; // constains all the lines
 
   // Painting
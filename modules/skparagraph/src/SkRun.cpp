@@ -35,6 +35,20 @@ SkShaper::RunHandler::Buffer SkRun::newRunBuffer() {
     };
 }
 
+void SkRun::moveX(SkScalar shiftX) {
+  fOffset.fX += shiftX;
+  for (auto& position : fPositions) {
+    position.fX += shiftX;
+  }
+}
+
+void SkRun::moveText(ptrdiff_t utf8Shift) {
+  fUtf8Range = SkShaper::RunHandler::Range(fUtf8Range.begin() + utf8Shift, fUtf8Range.size());
+  for (auto& cluster : fClusters) {
+    cluster += utf8Shift;
+  }
+}
+
 SkScalar SkRun::calculateHeight() {
   // The height of the run, not the height of the entire text (fInfo)
   return fFontMetrics.fDescent - fFontMetrics.fAscent + fFontMetrics.fLeading;
@@ -140,6 +140,10 @@ class SkRun {
     fOffset.fX += shiftX;
     fOffset.fY += shiftY;
   }
+  // Moves the run and all its glyphs along the endless line
+  void moveX(SkScalar shiftX);
+  // Moves the run's text along the paragraph text
+  void moveText(ptrdiff_t utf8Shift);
   SkVector advance() const {
     return SkVector::Make(fAdvance.fX,
                           fFontMetrics.fDescent + fFontMetrics.fLeading - fFontMetrics.fAscent);
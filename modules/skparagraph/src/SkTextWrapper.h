@@ -98,7 +98,11 @@ class SkTextWrapper {
   inline SkScalar width() const { return fWidth; }
   inline SkScalar intrinsicWidth() const { return fMinIntrinsicWidth; }
 
-  void reset() { fLines.reset(); }
+  void reset() {
+    fLines.reset();
+    // Ellipsis runs are moved into place on the line that uses them
+    fEllipsisCache.reset();
+  }
 
  private:
 
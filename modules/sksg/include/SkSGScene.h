@@ -68,6 +68,10 @@ public:
 
     void render(SkCanvas*) const;
     void animate(float t);
+
+    // Brings the scene graph up to date after animate(), as render() otherwise would, so that
+    // the work can be done ahead of time (or on another thread).
+    void revalidate();
     const RenderNode* nodeAt(const SkPoint&) const;
 
     void setShowInval(bool show) { fShowInval = show; }
@@ -69,6 +69,10 @@ void Scene::animate(float t) {
     }
 }
 
+void Scene::revalidate() {
+    fRoot->revalidate(nullptr, SkMatrix::I());
+}
+
 const RenderNode* Scene::nodeAt(const SkPoint& p) const {
     return fRoot->nodeAt(p);
 }
@@ -31,6 +31,24 @@ public:
     #ifdef SK_SHAPER_HARFBUZZ_AVAILABLE
     static std::unique_ptr<SkShaper> MakeShaperDrivenWrapper();
     static std::unique_ptr<SkShaper> MakeShapeThenWrap();
+
+    /** Drops the HarfBuzz faces and fonts, and the shaped runs, all shapers share. They're made
+        again when needed. */
+    static void PurgeHarfBuzzCache();
+
+    /** Shaped runs are kept, keyed by their text, font, script, language and bidi level, so that
+        shaping the same text again only copies the glyphs. Sets the bytes the cache may use,
+        returning the previous limit. A limit of zero turns the cache off. */
+    static size_t SetShapedRunCacheLimit(size_t bytes);
+
+    struct ShapedRunCacheStats {
+        size_t   fBytesUsed;
+        size_t   fByteLimit;
+        int      fCount;
+        uint64_t fHits;
+        uint64_t fMisses;
+    };
+    static ShapedRunCacheStats GetShapedRunCacheStats();
     #endif
 
     static std::unique_ptr<SkShaper> Make();
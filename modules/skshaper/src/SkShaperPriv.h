@@ -0,0 +1,26 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkShaperPriv_DEFINED
+#define SkShaperPriv_DEFINED
+
+#include "SkShaper.h"
+
+#include <memory>
+
+class SkShaperPriv {
+public:
+    #ifdef SK_SHAPER_HARFBUZZ_AVAILABLE
+    /** For tests: a MakeShapeThenWrap() shaper that keeps its shaped runs in a cache of its own,
+        of up to bytes, rather than the one all shapers share. That cache's stats are copied to
+        *stats, if not null, each time a run is shaped. */
+    static std::unique_ptr<SkShaper> MakeShapeThenWrapWithOwnRunCache(
+            size_t bytes, SkShaper::ShapedRunCacheStats* stats);
+    #endif
+};
+
+#endif  // SkShaperPriv_DEFINED
@@ -11,18 +11,23 @@
 #include "SkFontMetrics.h"
 #include "SkFontMgr.h"
 #include "SkFontTypes.h"
+#include "SkLRUCache.h"
 #include "SkMakeUnique.h"
 #include "SkMalloc.h"
+#include "SkMutex.h"
 #include "SkPaint.h"
 #include "SkPoint.h"
 #include "SkRect.h"
 #include "SkRefCnt.h"
 #include "SkScalar.h"
 #include "SkShaper.h"
+#include "SkShaperPriv.h"
 #include "SkStream.h"
 #include "SkTArray.h"
 #include "SkTDPQueue.h"
 #include "SkTFitsIn.h"
+#include "SkTHash.h"
+#include "SkTInternalLList.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 #include "SkTypeface.h"
@@ -271,7 +276,9 @@ hb_blob_t* skhb_get_table(hb_face_t* face, hb_tag_t tag, void* user_data) {
                           HB_MEMORY_MODE_WRITABLE, buffer, sk_free);
 }
 
-HBFont create_hb_font(const SkFont& font) {
+// Makes a font from the typeface's face, with its variations applied and OpenType functions to
+// read everything else from the face. Everything that depends on the SkFont goes in a sub font.
+HBFont create_hb_typeface_font(const SkFont& font) {
     int index;
     std::unique_ptr<SkStreamAsset> typefaceAsset = font.getTypeface()->openStream(&index);
     HBFace face;
@@ -306,19 +313,101 @@ HBFont create_hb_font(const SkFont& font) {
                                    axis_count);
         }
     }
+    hb_font_make_immutable(otFont.get());
 
+    return otFont;
+}
+
+HBFont create_hb_font(const SkFont& font, hb_font_t* typefaceFont) {
     // Creating a sub font means that non-available functions
     // are found from the parent.
-    HBFont skFont(hb_font_create_sub_font(otFont.get()));
+    HBFont skFont(hb_font_create_sub_font(typefaceFont));
     hb_font_set_funcs(skFont.get(), skhb_get_font_funcs(),
                       reinterpret_cast<void *>(new SkFont(font)),
                       [](void* user_data){ delete reinterpret_cast<SkFont*>(user_data); });
     int scale = skhb_position(font.getSize());
     hb_font_set_scale(skFont.get(), scale, scale);
+    hb_font_make_immutable(skFont.get());
 
     return skFont;
 }
 
+// Everything about an SkFont that changes what its HarfBuzz font callbacks return.
+struct HBFontKey {
+    explicit HBFontKey(const SkFont& font)
+        : fTypefaceID(font.getTypeface()->uniqueID())
+        , fSize(font.getSize())
+        , fScaleX(font.getScaleX())
+        , fSkewX(font.getSkewX())
+        , fFlags((uint32_t)font.getEdging()                 |
+                 (uint32_t)font.getHinting()           << 2 |
+                 (uint32_t)font.isForceAutoHinting()   << 4 |
+                 (uint32_t)font.isEmbeddedBitmaps()    << 5 |
+                 (uint32_t)font.isSubpixel()           << 6 |
+                 (uint32_t)font.isLinearMetrics()      << 7 |
+                 (uint32_t)font.isEmbolden()           << 8) {}
+
+    bool operator==(const HBFontKey& that) const {
+        return 0 == memcmp(this, &that, sizeof(HBFontKey));
+    }
+
+    SkFontID fTypefaceID;
+    SkScalar fSize;
+    SkScalar fScaleX;
+    SkScalar fSkewX;
+    uint32_t fFlags;
+};
+
+// Making a face reads the whole font file, copying it unless the typeface's stream is already in
+// memory, so the fonts made for each typeface and SkFont are kept for every shaper to share.
+// HarfBuzz fonts are reference counted and safe to shape with from several threads once
+// immutable, so a font stays usable after it falls out of the cache.
+class HBFontCache {
+public:
+    static HBFontCache* Get() {
+        static HBFontCache* cache = new HBFontCache;
+        return cache;
+    }
+
+    HBFont find(const SkFont& font) {
+        SkASSERT(font.getTypeface());
+        HBFontKey key(font);
+
+        SkAutoMutexAcquire lock(fMutex);
+        if (HBFont* cached = fFonts.find(key)) {
+            return HBFont(hb_font_reference(cached->get()));
+        }
+
+        HBFont* typefaceFont = fTypefaceFonts.find(key.fTypefaceID);
+        if (!typefaceFont) {
+            HBFont made = create_hb_typeface_font(font);
+            if (!made) {
+                return nullptr;
+            }
+            typefaceFont = fTypefaceFonts.insert(key.fTypefaceID, std::move(made));
+        }
+
+        HBFont* hbFont = fFonts.insert(key, create_hb_font(font, typefaceFont->get()));
+        return HBFont(hb_font_reference(hbFont->get()));
+    }
+
+    void purge() {
+        SkAutoMutexAcquire lock(fMutex);
+        fFonts.reset();
+        fTypefaceFonts.reset();
+    }
+
+private:
+    // Each face may hold a whole font file, and there are usually few typefaces but several
+    // sizes of each in use.
+    static constexpr int kMaxTypefaceFonts = 16;
+    static constexpr int kMaxFonts = 64;
+
+    SkMutex                                   fMutex;
+    SkLRUCache<SkFontID, HBFont>              fTypefaceFonts{kMaxTypefaceFonts};
+    SkLRUCache<HBFontKey, HBFont, SkGoodHash> fFonts{kMaxFonts};
+};
+
 /** Replaces invalid utf-8 sequences with REPLACEMENT CHARACTER U+FFFD. */
 static inline SkUnichar utf8_next(const char** ptr, const char* end) {
     SkUnichar val = SkUTF::NextUTF8(ptr, end);
@@ -501,6 +590,181 @@ struct ShapedLine {
     SkVector fAdvance = { 0, 0 };
 };
 
+// Labels, list items and table cells are laid out again and again with the same text, so the
+// glyphs HarfBuzz makes for each run are kept, for every shaper to share, up to a byte budget.
+//
+// HarfBuzz looks at up to five code points either side of a run (HB_BUFFER_CONTEXT_LENGTH, which
+// it keeps private), so the key holds that much context, at most four bytes to a code point, as
+// well as the run's own text.
+// Clusters are kept relative to the start of the run, so the same run may be found anywhere in
+// any text. Only what HarfBuzz decides is kept; the break flags are set by the wrapper each time.
+class ShapedRunCache {
+public:
+    static ShapedRunCache* Get() {
+        static ShapedRunCache* cache = new ShapedRunCache(kDefaultByteLimit);
+        return cache;
+    }
+
+    explicit ShapedRunCache(size_t byteLimit) : fByteLimit(byteLimit) {}
+    ~ShapedRunCache() { this->purgeTo(0); }
+
+    static SkString MakeKey(const char* utf8, size_t utf8Bytes,
+                            const char* utf8Start, const char* utf8End,
+                            UBiDiLevel level, const char* language, SkFourByteTag script,
+                            const SkFont& font) {
+        constexpr size_t kContextBytes = 5 * 4;
+        const char* preStart = utf8Start - SkTMin<size_t>(utf8Start - utf8, kContextBytes);
+        const char* postEnd = utf8End + SkTMin<size_t>(utf8 + utf8Bytes - utf8End, kContextBytes);
+
+        Header header(font);
+        header.fScript = script;
+        header.fLevel = level;
+        header.fPreBytes = SkToU32(utf8Start - preStart);
+        header.fRunBytes = SkToU32(utf8End - utf8Start);
+        header.fPostBytes = SkToU32(postEnd - utf8End);
+        header.fLanguageBytes = SkToU32(strlen(language));
+
+        SkString key;
+        key.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        key.append(language, header.fLanguageBytes);
+        key.append(preStart, postEnd - preStart);
+        return key;
+    }
+
+    // Copies the glyphs for key, if any, into run, which already has its range, font and level.
+    bool find(const SkString& key, ShapedRun* run) {
+        SkAutoMutexAcquire lock(fMutex);
+        Entry** found = fMap.find(key);
+        if (!found) {
+            fMisses++;
+            return false;
+        }
+        fHits++;
+        Entry* entry = *found;
+        if (entry != fLRU.head()) {
+            fLRU.remove(entry);
+            fLRU.addToHead(entry);
+        }
+
+        if (entry->fNumGlyphs) {
+            run->fGlyphs.reset(new ShapedGlyph[entry->fNumGlyphs]);
+            memcpy(run->fGlyphs.get(), entry->fGlyphs.get(),
+                   entry->fNumGlyphs * sizeof(ShapedGlyph));
+            for (size_t i = 0; i < entry->fNumGlyphs; ++i) {
+                run->fGlyphs[i].fCluster += run->fUtf8Range.begin();
+            }
+        }
+        run->fNumGlyphs = entry->fNumGlyphs;
+        run->fAdvance = entry->fAdvance;
+        return true;
+    }
+
+    void add(const SkString& key, const ShapedRun& run) {
+        std::unique_ptr<Entry> entry(new Entry(key, run));
+        SkAutoMutexAcquire lock(fMutex);
+        if (entry->fBytes > fByteLimit || fMap.find(key)) {
+            // Too big to keep, or another thread shaped the same run first.
+            return;
+        }
+        fBytesUsed += entry->fBytes;
+        fLRU.addToHead(entry.get());
+        fMap.set(entry.release());
+        this->purgeTo(fByteLimit);
+    }
+
+    bool enabled() {
+        SkAutoMutexAcquire lock(fMutex);
+        return fByteLimit > 0;
+    }
+
+    size_t setByteLimit(size_t bytes) {
+        SkAutoMutexAcquire lock(fMutex);
+        size_t previous = fByteLimit;
+        fByteLimit = bytes;
+        this->purgeTo(fByteLimit);
+        return previous;
+    }
+
+    SkShaper::ShapedRunCacheStats stats() {
+        SkAutoMutexAcquire lock(fMutex);
+        SkShaper::ShapedRunCacheStats stats;
+        stats.fBytesUsed = fBytesUsed;
+        stats.fByteLimit = fByteLimit;
+        stats.fCount = fMap.count();
+        stats.fHits = fHits;
+        stats.fMisses = fMisses;
+        return stats;
+    }
+
+    void purge() {
+        SkAutoMutexAcquire lock(fMutex);
+        this->purgeTo(0);
+    }
+
+private:
+    static constexpr size_t kDefaultByteLimit = 2 * 1024 * 1024;
+
+    struct Header {
+        explicit Header(const SkFont& font) : fFont(font) {}
+
+        HBFontKey fFont;
+        uint32_t  fScript;
+        uint32_t  fLevel;
+        uint32_t  fPreBytes;
+        uint32_t  fRunBytes;
+        uint32_t  fPostBytes;
+        uint32_t  fLanguageBytes;
+    };
+    static_assert(sizeof(Header) == sizeof(HBFontKey) + 6 * sizeof(uint32_t),
+                  "ShapedRunCache keys must not hold padding");
+
+    struct Entry {
+        Entry(const SkString& key, const ShapedRun& run)
+            : fKey(key)
+            , fGlyphs(run.fNumGlyphs ? new ShapedGlyph[run.fNumGlyphs] : nullptr)
+            , fNumGlyphs(run.fNumGlyphs)
+            , fAdvance(run.fAdvance)
+            , fBytes(sizeof(Entry) + key.size() + run.fNumGlyphs * sizeof(ShapedGlyph)) {
+            for (size_t i = 0; i < fNumGlyphs; ++i) {
+                fGlyphs[i] = run.fGlyphs[i];
+                fGlyphs[i].fCluster -= run.fUtf8Range.begin();
+            }
+        }
+
+        SkString                       fKey;
+        std::unique_ptr<ShapedGlyph[]> fGlyphs;
+        size_t                         fNumGlyphs;
+        SkVector                       fAdvance;
+        size_t                         fBytes;
+
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+    };
+
+    struct Traits {
+        static const SkString& GetKey(Entry* e) { return e->fKey; }
+        static uint32_t Hash(const SkString& key) { return SkGoodHash()(key); }
+    };
+
+    void purgeTo(size_t bytes) {
+        while (fBytesUsed > bytes) {
+            Entry* entry = fLRU.tail();
+            SkASSERT(entry);
+            fLRU.remove(entry);
+            fMap.remove(entry->fKey);
+            fBytesUsed -= entry->fBytes;
+            delete entry;
+        }
+    }
+
+    SkMutex                                    fMutex;
+    SkTHashTable<Entry*, SkString, Traits>     fMap;
+    SkTInternalLList<Entry>                    fLRU;
+    size_t                                     fBytesUsed = 0;
+    size_t                                     fByteLimit;
+    uint64_t                                   fHits = 0;
+    uint64_t                                   fMisses = 0;
+};
+
 constexpr bool is_LTR(UBiDiLevel level) {
     return (level & 1) == 0;
 }
@@ -627,6 +891,13 @@ struct ShapedRunGlyphIterator {
 class ShaperHarfBuzz : public SkShaper {
 public:
     ShaperHarfBuzz(HBBuffer, ICUBrk line, ICUBrk grapheme);
+
+    // For tests: keeps shaped runs in a cache of this shaper's own, copying its stats to *stats
+    // after every run is shaped.
+    void useOwnRunCache(size_t bytes, ShapedRunCacheStats* stats) {
+        fOwnRunCache.reset(new ShapedRunCache(bytes));
+        fOwnRunCacheStats = stats;
+    }
 protected:
     ICUBrk fLineBreakIterator;
     ICUBrk fGraphemeBreakIterator;
@@ -640,6 +911,16 @@ protected:
                     const FontRunIterator&) const;
 private:
     HBBuffer fBuffer;
+    std::unique_ptr<ShapedRunCache> fOwnRunCache;    // Null to share ShapedRunCache::Get().
+    ShapedRunCacheStats* fOwnRunCacheStats = nullptr;
+
+    ShapedRun shapeUncached(const char* utf8, size_t utf8Bytes,
+                            const char* utf8Start,
+                            const char* utf8End,
+                            const BiDiRunIterator&,
+                            const LanguageRunIterator&,
+                            const ScriptRunIterator&,
+                            const FontRunIterator&) const;
 
     void shape(const char* utf8, size_t utf8Bytes,
                const SkFont&,
@@ -693,7 +974,7 @@ private:
               RunHandler*) const override;
 };
 
-static std::unique_ptr<SkShaper> MakeHarfBuzz(bool correct) {
+static std::unique_ptr<ShaperHarfBuzz> MakeHarfBuzz(bool correct) {
     #if defined(SK_USING_THIRD_PARTY_ICU)
     if (!SkLoadICU()) {
         SkDEBUGF("SkLoadICU() failed!\n");
@@ -1165,6 +1446,37 @@ ShapedRun ShaperHarfBuzz::shape(char const * const utf8,
                                   const LanguageRunIterator& language,
                                   const ScriptRunIterator& script,
                                   const FontRunIterator& font) const
+{
+    ShapedRunCache* cache = fOwnRunCache ? fOwnRunCache.get() : ShapedRunCache::Get();
+    if (!cache->enabled()) {
+        return this->shapeUncached(utf8, utf8Bytes, utf8Start, utf8End,
+                                   bidi, language, script, font);
+    }
+
+    SkString key = ShapedRunCache::MakeKey(utf8, utf8Bytes, utf8Start, utf8End,
+                                           bidi.currentLevel(), language.currentLanguage(),
+                                           script.currentScript(), font.currentFont());
+    ShapedRun run(RunHandler::Range(utf8Start - utf8, utf8End - utf8Start),
+                  font.currentFont(), bidi.currentLevel(), nullptr, 0);
+    if (!cache->find(key, &run)) {
+        run = this->shapeUncached(utf8, utf8Bytes, utf8Start, utf8End,
+                                  bidi, language, script, font);
+        cache->add(key, run);
+    }
+    if (fOwnRunCacheStats) {
+        *fOwnRunCacheStats = cache->stats();
+    }
+    return run;
+}
+
+ShapedRun ShaperHarfBuzz::shapeUncached(char const * const utf8,
+                                        size_t const utf8Bytes,
+                                        char const * const utf8Start,
+                                        char const *  const utf8End,
+                                        const BiDiRunIterator& bidi,
+                                        const LanguageRunIterator& language,
+                                        const ScriptRunIterator& script,
+                                        const FontRunIterator& font) const
 {
     size_t utf8runLength = utf8End - utf8Start;
     ShapedRun run(RunHandler::Range(utf8Start - utf8, utf8runLength),
@@ -1199,8 +1511,7 @@ ShapedRun ShaperHarfBuzz::shape(char const * const utf8,
     hb_buffer_guess_segment_properties(buffer);
     // TODO: features
 
-    // TODO: how to cache hbface (typeface) / hbfont (font)
-    HBFont hbFont(create_hb_font(font.currentFont()));
+    HBFont hbFont(HBFontCache::Get()->find(font.currentFont()));
     if (!hbFont) {
         return run;
     }
@@ -1301,9 +1612,30 @@ SkShaper::MakeHbIcuScriptRunIterator(const char* utf8, size_t utf8Bytes) {
     return skstd::make_unique<HbIcuScriptRunIterator>(utf8, utf8Bytes);
 }
 
+void SkShaper::PurgeHarfBuzzCache() {
+    ShapedRunCache::Get()->purge();
+    HBFontCache::Get()->purge();
+}
+
+size_t SkShaper::SetShapedRunCacheLimit(size_t bytes) {
+    return ShapedRunCache::Get()->setByteLimit(bytes);
+}
+
+SkShaper::ShapedRunCacheStats SkShaper::GetShapedRunCacheStats() {
+    return ShapedRunCache::Get()->stats();
+}
+
 std::unique_ptr<SkShaper> SkShaper::MakeShaperDrivenWrapper() {
     return MakeHarfBuzz(true);
 }
 std::unique_ptr<SkShaper> SkShaper::MakeShapeThenWrap() {
     return MakeHarfBuzz(false);
 }
+std::unique_ptr<SkShaper> SkShaperPriv::MakeShapeThenWrapWithOwnRunCache(
+        size_t bytes, SkShaper::ShapedRunCacheStats* stats) {
+    std::unique_ptr<ShaperHarfBuzz> shaper = MakeHarfBuzz(false);
+    if (shaper) {
+        shaper->useOwnRunCache(bytes, stats);
+    }
+    return std::move(shaper);
+}
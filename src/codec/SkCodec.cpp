@@ -10,6 +10,7 @@
 #include "SkCodecPriv.h"
 #include "SkColorSpace.h"
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkFrameHolder.h"
 #include "SkHalf.h"
 #ifdef SK_HAS_HEIF_LIBRARY
@@ -22,6 +23,7 @@
 #endif
 #include "SkRawCodec.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkWbmpCodec.h"
 #include "SkWebpCodec.h"
 #ifdef SK_HAS_WUFFS_LIBRARY
@@ -380,6 +382,90 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& dstInfo, void* pixels, siz
     return result;
 }
 
+// Bands smaller than this aren't worth a codec of their own.
+static constexpr int kMinRowsPerBand = 64;
+static constexpr int kMaxBands       = 8;
+
+SkCodec::Result SkCodec::getPixelsInBands(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                                          const Options* options, SkExecutor* executor) {
+    const int bandCount = executor ? SkTMin(kMaxBands, info.height() / kMinRowsPerBand) : 1;
+    if (bandCount < 2 || !this->onCanDecodeInBands() ||
+        (options && (options->fSubset || options->fFrameIndex != 0))) {
+        return this->getPixels(info, pixels, rowBytes, options);
+    }
+
+    // The first band is decoded by this codec, the rest by codecs of their own.
+    std::vector<std::unique_ptr<SkCodec>> codecs(bandCount);
+    for (int i = 1; i < bandCount; ++i) {
+        std::unique_ptr<SkStream> stream = fStream->duplicate();
+        if (stream) {
+            codecs[i] = MakeFromStream(std::move(stream));
+        }
+        if (!codecs[i] || codecs[i]->getEncodedFormat() != this->getEncodedFormat()
+                       || codecs[i]->dimensions() != this->dimensions()) {
+            return this->getPixels(info, pixels, rowBytes, options);
+        }
+    }
+
+    std::vector<Result> results(bandCount, kSuccess);
+    SkTaskGroup(*executor).batch(bandCount, [&](int i) {
+        SkCodec* codec = i == 0 ? this : codecs[i].get();
+        const int top    = info.height() *  i      / bandCount,
+                  bottom = info.height() * (i + 1) / bandCount;
+
+        void* dst = SkTAddOffset<void>(pixels, top * rowBytes);
+
+        // Prefer an incremental decode of just the band's rows, as SkAndroidCodec does, and fall
+        // back to scanlines for codecs that only support those.
+        const SkIRect band = SkIRect::MakeLTRB(0, top, info.width(), bottom);
+        Options bandOptions = options ? *options : Options();
+        bandOptions.fSubset = &band;
+        Result result = codec->startIncrementalDecode(info, dst, rowBytes, &bandOptions);
+        if (kSuccess == result) {
+            result = codec->incrementalDecode();
+        } else if (kUnimplemented == result) {
+            result = codec->startScanlineDecode(info, options);
+            if (kSuccess == result && codec->getScanlineOrder() != kTopDown_SkScanlineOrder) {
+                result = kUnimplemented;
+            }
+            if (kSuccess == result && top > 0 && !codec->skipScanlines(top)) {
+                result = kIncompleteInput;
+            }
+            if (kSuccess == result &&
+                codec->getScanlines(dst, bottom - top, rowBytes) != bottom - top) {
+                result = kIncompleteInput;
+            }
+        }
+        results[i] = result;
+    });
+
+    // Errors, and filling in incomplete images, are left to a regular decode.
+    for (Result result : results) {
+        if (kSuccess != result) {
+            return this->getPixels(info, pixels, rowBytes, options);
+        }
+    }
+    return kSuccess;
+}
+
+void SkCodec::DecodeBatch(BatchItem items[], int count, SkExecutor* executor) {
+    if (!executor) {
+        executor = &SkExecutor::GetDefault();
+    }
+    if (1 == count) {
+        BatchItem& item = items[0];
+        item.fResult = item.fCodec->getPixelsInBands(item.fInfo, item.fPixels, item.fRowBytes,
+                                                     item.fOptions, executor);
+        return;
+    }
+
+    SkTaskGroup(*executor).batch(count, [items](int i) {
+        BatchItem& item = items[i];
+        item.fResult = item.fCodec->getPixels(item.fInfo, item.fPixels, item.fRowBytes,
+                                              item.fOptions);
+    });
+}
+
 SkCodec::Result SkCodec::startIncrementalDecode(const SkImageInfo& dstInfo, void* pixels,
         size_t rowBytes, const SkCodec::Options* options) {
     fStartedIncrementalDecode = false;
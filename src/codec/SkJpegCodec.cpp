@@ -774,6 +774,12 @@ int SkJpegCodec::onGetScanlines(void* dst, int count, size_t dstRowBytes) {
     return rows;
 }
 
+bool SkJpegCodec::onCanDecodeInBands() const {
+    // jpeg_skip_scanlines() skips the IDCT of a baseline image's rows, but a progressive image
+    // has to be read in full before any row can be output.
+    return !fDecoderMgr->dinfo()->progressive_mode;
+}
+
 bool SkJpegCodec::onSkipScanlines(int count) {
     // Set the jump location for libjpeg errors
     skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
@@ -59,6 +59,8 @@ protected:
 
     bool conversionSupported(const SkImageInfo&, bool, bool) override;
 
+    bool onCanDecodeInBands() const override;
+
 private:
     /*
      * Allows SkRawCodec to communicate the color profile from the exif data.
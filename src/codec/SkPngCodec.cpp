@@ -502,6 +502,9 @@ public:
         , fLastRow(0)
     {}
 
+    // Each band inflates the rows above it, but only swizzles and color converts its own.
+    bool onCanDecodeInBands() const override { return true; }
+
     static void AllRowsCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum, int /*pass*/) {
         GetDecoder(png_ptr)->allRowsCallback(row, rowNum);
     }
@@ -6,6 +6,7 @@
  */
 
 #include "SkBBHFactory.h"
+#include "SkPackedRTree.h"
 #include "SkRect.h"
 #include "SkRTree.h"
 #include "SkScalar.h"
@@ -14,3 +15,7 @@ SkBBoxHierarchy* SkRTreeFactory::operator()(const SkRect& bounds) const {
     SkScalar aspectRatio = bounds.width() / bounds.height();
     return new SkRTree(aspectRatio);
 }
+
+SkBBoxHierarchy* SkPackedRTreeFactory::operator()(const SkRect&) const {
+    return new SkPackedRTree;
+}
@@ -615,7 +615,8 @@ void SkBitmapDevice::drawSpecial(SkSpecialImage* src, int x, int y, const SkPain
         const SkIRect clipBounds = fRCStack.rc().getBounds().makeOffset(-x, -y);
         sk_sp<SkImageFilterCache> cache(this->getImageFilterCache());
         SkImageFilter::OutputProperties outputProperties(fBitmap.colorType(), fBitmap.colorSpace());
-        SkImageFilter::Context ctx(matrix, clipBounds, cache.get(), outputProperties);
+        SkImageFilter::Context ctx(matrix, clipBounds, cache.get(), outputProperties,
+                                   this->imageFilterExecutor());
 
         filteredImage = filter->filterImage(src, ctx, &offset);
         if (!filteredImage) {
@@ -21,6 +21,7 @@
 #include "SkSize.h"
 #include "SkSurfaceProps.h"
 
+class SkExecutor;
 class SkImageFilterCache;
 class SkMatrix;
 class SkPaint;
@@ -136,6 +137,9 @@ protected:
     virtual void drawBitmap(const SkBitmap&, const SkMatrix&, const SkRect* dstOrNull,
                             const SkPaint&);
 
+    // If not null, image filters drawn by drawSpecial() may spread their work over this executor.
+    virtual SkExecutor* imageFilterExecutor() const { return nullptr; }
+
 private:
     friend class SkCanvas;
     friend struct DeviceCM; //for setMatrixClip
@@ -143,6 +147,7 @@ private:
     friend class SkDrawIter;
     friend class SkDrawTiler;
     friend class SkSurface_Raster;
+    friend class SkThreadedBMPDevice;
 
     class BDDraw;
 
@@ -403,7 +403,7 @@ public:
             };
             rec.fPipeline->append(SkRasterPipeline::callback, ctx);
         } else {
-            struct InterpreterCtx : public SkRasterPipeline_CallbackCtx {
+            struct InterpreterCtx : public SkRasterPipeline_InterpreterCtx {
                 SkSL::ByteCodeFunction* main;
                 std::unique_ptr<SkSL::Interpreter> interpreter;
                 const void* inputs;
@@ -422,15 +422,14 @@ public:
             std::unique_ptr<SkSL::ByteCode> byteCode = c.toByteCode(*prog);
             ctx->main = byteCode->fFunctions[0].get();
             ctx->interpreter.reset(new SkSL::Interpreter(std::move(prog), std::move(byteCode)));
-            ctx->fn = [](SkRasterPipeline_CallbackCtx* arg, int active_pixels) {
+            ctx->fn = [](SkRasterPipeline_InterpreterCtx* arg, int active_pixels) {
                 auto ctx = (InterpreterCtx*)arg;
-                for (int i = 0; i < active_pixels; i++) {
-                    ctx->interpreter->run(*ctx->main,
-                                          (SkSL::Interpreter::Value*) (ctx->rgba + i * 4),
-                                          (SkSL::Interpreter::Value*) ctx->inputs);
-                }
+                ctx->interpreter->runStriped(*ctx->main, active_pixels,
+                                             (SkSL::Interpreter::Value*) ctx->rgba,
+                                             SkRasterPipeline_kMaxStride,
+                                             (SkSL::Interpreter::Value*) ctx->inputs);
             };
-            rec.fPipeline->append(SkRasterPipeline::callback, ctx);
+            rec.fPipeline->append(SkRasterPipeline::interpreter, ctx);
         }
         return true;
     }
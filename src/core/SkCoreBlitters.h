@@ -165,8 +165,10 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 // Neither of these ever returns nullptr, but this first factory may return a SkNullBlitter.
+// Blit programs are shared with earlier blitters through a cache unless useProgramCache is false,
+// which is only for testing.
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap&, const SkPaint&, const SkMatrix& ctm,
-                                         SkArenaAlloc*);
+                                         SkArenaAlloc*, bool useProgramCache = true);
 // Use this if you've pre-baked a shader pipeline, including modulating with paint alpha.
 // This factory never returns an SkNullBlitter.
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap&, const SkPaint&,
@@ -15,6 +15,7 @@
 #include "SkColorData.h"
 #include "SkDevice.h"
 #include "SkDrawProcs.h"
+#include "SkEdgeBuilder.h"
 #include "SkMaskFilterBase.h"
 #include "SkMacros.h"
 #include "SkMatrix.h"
@@ -815,9 +816,49 @@ SkScalar SkDraw::ComputeResScaleForStroking(const SkMatrix& matrix) {
     return 1;
 }
 
+// Moves everything blitted through it by a whole number of pixels.
+class SkOffsetBlitter final : public SkBlitter {
+public:
+    SkOffsetBlitter(SkBlitter* blitter, SkIPoint offset)
+        : fBlitter(blitter), fDX(offset.fX), fDY(offset.fY) {}
+
+    void blitH(int x, int y, int width) override {
+        fBlitter->blitH(x + fDX, y + fDY, width);
+    }
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        fBlitter->blitAntiH(x + fDX, y + fDY, antialias, runs);
+    }
+    void blitV(int x, int y, int height, SkAlpha alpha) override {
+        fBlitter->blitV(x + fDX, y + fDY, height, alpha);
+    }
+    void blitRect(int x, int y, int width, int height) override {
+        fBlitter->blitRect(x + fDX, y + fDY, width, height);
+    }
+    void blitAntiRect(int x, int y, int width, int height,
+                      SkAlpha leftAlpha, SkAlpha rightAlpha) override {
+        fBlitter->blitAntiRect(x + fDX, y + fDY, width, height, leftAlpha, rightAlpha);
+    }
+    void blitMask(const SkMask& mask, const SkIRect& clip) override {
+        SkMask moved = mask;
+        moved.fBounds.offset(fDX, fDY);
+        fBlitter->blitMask(moved, clip.makeOffset(fDX, fDY));
+    }
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override {
+        fBlitter->blitAntiH2(x + fDX, y + fDY, a0, a1);
+    }
+    void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override {
+        fBlitter->blitAntiV2(x + fDX, y + fDY, a0, a1);
+    }
+
+private:
+    SkBlitter* fBlitter;
+    int        fDX, fDY;
+};
+
 void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawCoverage,
-                         SkBlitter* customBlitter, bool doFill) const {
-    if (SkPathPriv::TooBigForMath(devPath)) {
+                         SkBlitter* customBlitter, bool doFill, SkIPoint offset) const {
+    if (SkPathPriv::TooBigForMath(devPath.getBounds().makeOffset(SkIntToScalar(offset.fX),
+                                                                 SkIntToScalar(offset.fY)))) {
         return;
     }
     SkBlitter* blitter = nullptr;
@@ -829,6 +870,7 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
     }
 
     if (paint.getMaskFilter()) {
+        SkASSERT(offset.isZero());
         SkStrokeRec::InitStyle style = doFill ? SkStrokeRec::kFill_InitStyle
         : SkStrokeRec::kHairline_InitStyle;
         if (as_MFB(paint.getMaskFilter())->filterPath(devPath, *fMatrix, *fRC, blitter, style)) {
@@ -877,9 +919,47 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
         }
     }
 
+    if (!offset.isZero()) {
+        // Scan convert against the clip moved back by offset, and blit moved forward again.
+        SkRasterClip clip;
+        fRC->translate(-offset.fX, -offset.fY, &clip);
+        SkOffsetBlitter offsetBlitter(blitter, offset);
+        proc(devPath, clip, &offsetBlitter);
+        return;
+    }
     proc(devPath, *fRC, blitter);
 }
 
+// Whether path can be filled in its own coordinates and moved by offset, rather than transformed.
+// That lets SkEdgeBuilder reuse the edges it cached on the path's SkPathRef, even as the path
+// moves around from one frame to the next.
+static bool fill_at_offset(const SkPath& path, const SkMatrix& matrix, const SkPaint& paint,
+                           const SkRasterClip& rc, SkIPoint* offset) {
+    if (!matrix.isTranslate() || paint.getMaskFilter() || !rc.isBW() ||
+        !SkEdgeBuilder::CanCacheEdges(path)) {
+        return false;
+    }
+    const SkScalar tx = matrix.getTranslateX(),
+                   ty = matrix.getTranslateY();
+    const int dx = sk_float_saturate2int(tx),
+              dy = sk_float_saturate2int(ty);
+    if (dx != tx || dy != ty || (dx == 0 && dy == 0)) {
+        return false;
+    }
+    // The scan converters trim clips to +-16383 (SkFixed widths), and AA falls back to aliased
+    // fills past 8191 (supersampled shorts). Moving the path only draws the same if the path, the
+    // clip and the clip moved back by offset all stay within those limits.
+    const SkScalar limit = paint.isAntiAlias() ? 8191 : 16383;
+    const SkRect   limitR = SkRect::MakeLTRB(-limit, -limit, limit, limit);
+    const SkRect   clipBounds = SkRect::Make(rc.getBounds());
+    if (!limitR.contains(path.getBounds()) || !limitR.contains(clipBounds) ||
+        !limitR.contains(clipBounds.makeOffset(-tx, -ty))) {
+        return false;
+    }
+    offset->set(dx, dy);
+    return true;
+}
+
 void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
                       const SkMatrix* prePathMatrix, bool pathIsMutable,
                       bool drawCoverage, SkBlitter* customBlitter) const {
@@ -953,6 +1033,12 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         pathPtr = tmpPath;
     }
 
+    SkIPoint offset;
+    if (doFill && fill_at_offset(*pathPtr, *matrix, *paint, *fRC, &offset)) {
+        this->drawDevPath(*pathPtr, *paint, drawCoverage, customBlitter, doFill, offset);
+        return;
+    }
+
     // avoid possibly allocating a new path in transform if we can
     SkPath* devPathPtr = pathIsMutable ? pathPtr : tmpPath;
 
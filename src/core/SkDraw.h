@@ -138,11 +138,13 @@ private:
 
     void drawLine(const SkPoint[2], const SkPaint&) const;
 
+    // If offset is not zero, devPath is still in its own coordinates, and is drawn moved by offset.
     void drawDevPath(const SkPath& devPath,
                      const SkPaint& paint,
                      bool drawCoverage,
                      SkBlitter* customBlitter,
-                     bool doFill) const;
+                     bool doFill,
+                     SkIPoint offset = {0, 0}) const;
     /**
      *  Return the current clip bounds, in local coordinates, with slop to account
      *  for antialiasing or hairlines (i.e. device-bounds outset by 1, and then
@@ -418,11 +418,67 @@ int SkEdgeBuilder::build(const SkPath& path, const SkIRect* iclip, bool canCullT
     return is_finite ? fList.count() : 0;
 }
 
+// Smaller paths build their edges quickly enough, and bigger ones would hold on to too much.
+static constexpr int    kMinCachedEdgePoints = 256;
+static constexpr size_t kMaxCachedEdgeBytes  = 1 << 22;
+
+bool SkEdgeBuilder::CanCacheEdges(const SkPath& path) {
+    // Only polygons are cached: their edges are all the same size and hold no curve state.
+    return SkPath::kLine_SegmentMask == path.getSegmentMasks()
+        && !path.isVolatile()
+        && path.countPoints() >= kMinCachedEdgePoints;
+}
+
+int SkEdgeBuilder::copyCachedEdges(const SkEdgeCache& cache) {
+    size_t edgeSize;
+    char* edge = this->allocEdges(cache.fCount, &edgeSize);
+    SkASSERT(edgeSize == cache.fEdgeSize);
+    memcpy(edge, cache.fEdges.get(), cache.fCount * edgeSize);
+
+    char** edgePtr = fAlloc.makeArrayDefault<char*>(cache.fCount);
+    for (int i = 0; i < cache.fCount; ++i) {
+        edgePtr[i] = edge + i * edgeSize;
+    }
+    fEdgeList = (void**)edgePtr;
+    return cache.fCount;
+}
+
+sk_sp<SkEdgeCache> SkEdgeBuilder::makeEdgeCache(uint32_t genID, int count) {
+    auto cache = sk_make_sp<SkEdgeCache>(genID, this->edgeKind());
+    this->allocEdges(0, &cache->fEdgeSize);
+    if ((size_t)count > kMaxCachedEdgeBytes / cache->fEdgeSize) {
+        return cache;
+    }
+
+    // buildPoly() leaves gaps where it combined edges, so pack them in list order.
+    cache->fCount = count;
+    cache->fEdges.reset(count * cache->fEdgeSize);
+    for (int i = 0; i < count; ++i) {
+        memcpy(cache->fEdges.get() + i * cache->fEdgeSize, fEdgeList[i], cache->fEdgeSize);
+    }
+    return cache;
+}
+
 int SkEdgeBuilder::buildEdges(const SkPath& path,
                               const SkIRect* shiftedClip) {
     // If we're convex, then we need both edges, even if the right edge is past the clip.
     const bool canCullToTheRight = !path.isConvex();
 
+    // Unclipped polygons drawn over and over keep their edges on their SkPathRef. Clipped ones
+    // would need a cache per clip, so they are always built from scratch.
+    sk_sp<SkEdgeCache> cache;
+    const bool canCache = !shiftedClip && CanCacheEdges(path);
+    if (canCache) {
+        cache = SkPathPriv::EdgeCache(path);
+        if (cache && (cache->fGenID != path.getGenerationID() ||
+                      cache->fKind  != this->edgeKind())) {
+            cache = nullptr;
+        }
+        if (cache && cache->fEdges) {
+            return this->copyCachedEdges(*cache);
+        }
+    }
+
     // We can use our buildPoly() optimization if all the segments are lines.
     // (Edges are homogenous and stored contiguously in memory, no need for indirection.)
     const int count = SkPath::kLine_SegmentMask == path.getSegmentMasks()
@@ -431,6 +487,13 @@ int SkEdgeBuilder::buildEdges(const SkPath& path,
 
     SkASSERT(count >= 0);
 
+    if (canCache) {
+        // The first build only notes that it happened; the second keeps the edges.
+        SkPathPriv::SetEdgeCache(path, cache ? this->makeEdgeCache(cache->fGenID, count)
+                                             : sk_make_sp<SkEdgeCache>(path.getGenerationID(),
+                                                                       this->edgeKind()));
+    }
+
     // If we can't cull to the right, we should have count > 1 (or 0).
     if (!canCullToTheRight) {
         SkASSERT(count != 1);
@@ -11,15 +11,36 @@
 #include "SkArenaAlloc.h"
 #include "SkEdge.h"
 #include "SkRect.h"
+#include "SkRefCnt.h"
 #include "SkTDArray.h"
+#include "SkTemplates.h"
 
 class SkPath;
 
+/**
+ *  The edges built for an unclipped polygon, kept on its SkPathRef so that drawing it again skips
+ *  straight to copying them. A cache is first made empty, to note that the path has been built
+ *  once, and only holds edges once the same path is built a second time.
+ */
+class SkEdgeCache : public SkNVRefCnt<SkEdgeCache> {
+public:
+    SkEdgeCache(uint32_t genID, int kind) : fGenID(genID), fKind(kind) {}
+
+    const uint32_t       fGenID;     // Of the path the edges were built from.
+    const int            fKind;      // See SkEdgeBuilder::edgeKind().
+    int                  fCount    = 0;
+    size_t               fEdgeSize = 0;
+    SkAutoTMalloc<char>  fEdges;     // fCount edges of fEdgeSize bytes, or null if empty.
+};
+
 class SkEdgeBuilder {
 public:
     int buildEdges(const SkPath& path,
                    const SkIRect* shiftedClip);
 
+    // Whether buildEdges() may cache the edges of path on its SkPathRef when it is not clipped.
+    static bool CanCacheEdges(const SkPath& path);
+
 protected:
     SkEdgeBuilder() = default;
     virtual ~SkEdgeBuilder() = default;
@@ -40,6 +61,11 @@ private:
     int build    (const SkPath& path, const SkIRect* clip, bool clipToTheRight);
     int buildPoly(const SkPath& path, const SkIRect* clip, bool clipToTheRight);
 
+    int copyCachedEdges(const SkEdgeCache&);
+    sk_sp<SkEdgeCache> makeEdgeCache(uint32_t genID, int count);
+
+    // Builders of the same kind make the same edges from the same path.
+    virtual int edgeKind() const = 0;
     virtual char* allocEdges(size_t n, size_t* sizeof_edge) = 0;
     virtual SkRect recoverClip(const SkIRect&) const = 0;
 
@@ -58,6 +84,7 @@ public:
 private:
     Combine combineVertical(const SkEdge* edge, SkEdge* last);
 
+    int edgeKind() const override { return fClipShift; }
     char* allocEdges(size_t, size_t*) override;
     SkRect recoverClip(const SkIRect&) const override;
 
@@ -78,6 +105,7 @@ public:
 private:
     Combine combineVertical(const SkAnalyticEdge* edge, SkAnalyticEdge* last);
 
+    int edgeKind() const override { return -1; }
     char* allocEdges(size_t, size_t*) override;
     SkRect recoverClip(const SkIRect&) const override;
 
@@ -10,6 +10,7 @@
 #include "SkCanvas.h"
 #include "SkFuzzLogging.h"
 #include "SkImageFilterCache.h"
+#include "SkImageFilterPriv.h"
 #include "SkLocalMatrixImageFilter.h"
 #include "SkMatrixImageFilter.h"
 #include "SkReadBuffer.h"
@@ -17,6 +18,7 @@
 #include "SkSafe32.h"
 #include "SkSpecialImage.h"
 #include "SkSpecialSurface.h"
+#include "SkTaskGroup.h"
 #include "SkValidationUtils.h"
 #include "SkWriteBuffer.h"
 #if SK_SUPPORT_GPU
@@ -434,7 +436,7 @@ SkImageFilter::Context SkImageFilter::mapContext(const Context& ctx) const {
     SkIRect clipBounds = this->onFilterNodeBounds(ctx.clipBounds(), ctx.ctm(),
                                                   MapDirection::kReverse_MapDirection,
                                                   &ctx.clipBounds());
-    return Context(ctx.ctm(), clipBounds, ctx.cache(), ctx.outputProperties());
+    return Context(ctx.ctm(), clipBounds, ctx.cache(), ctx.outputProperties(), ctx.executor());
 }
 
 sk_sp<SkImageFilter> SkImageFilter::MakeMatrixFilter(const SkMatrix& matrix,
@@ -467,6 +469,75 @@ sk_sp<SkSpecialImage> SkImageFilter::filterInput(int index,
     return result;
 }
 
+void SkImageFilter::filterInputs(int count,
+                                 SkSpecialImage* src,
+                                 const Context& ctx,
+                                 sk_sp<SkSpecialImage> results[],
+                                 SkIPoint offsets[]) const {
+    SkASSERT(count <= this->countInputs());
+
+    // Filter each distinct input once; later copies of it just take its result.
+    SkSTArray<4, int, true> unique;
+    SkAutoSTMalloc<4, int> firstCopy(count);
+    for (int i = 0; i < count; ++i) {
+        firstCopy[i] = i;
+        for (int j : unique) {
+            if (this->getInput(j) == this->getInput(i)) {
+                firstCopy[i] = j;
+                break;
+            }
+        }
+        if (firstCopy[i] == i) {
+            unique.push_back(i);
+        }
+    }
+
+    auto filter = [&](int u) {
+        const int i = unique[u];
+        results[i] = this->filterInput(i, src, ctx, &offsets[i]);
+    };
+    if (ctx.executor() && unique.count() > 1 && !src->isTextureBacked()) {
+        SkTaskGroup tasks(*ctx.executor());
+        tasks.batch(unique.count(), filter);
+        tasks.wait();
+    } else {
+        for (int u = 0; u < unique.count(); ++u) {
+            filter(u);
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (firstCopy[i] != i) {
+            results[i] = results[firstCopy[i]];
+            offsets[i] = offsets[firstCopy[i]];
+        }
+    }
+}
+
+void SkImageFilterForBands(const SkImageFilter::Context& ctx, int lineCount, int lineCost,
+                           const std::function<void(int begin, int end)>& fn) {
+    // Below this many pixels per band, handing work to other threads costs more than it saves.
+    static constexpr int64_t kMinPixelsPerBand = 32 * 1024;
+    static constexpr int     kMaxBands         = 16;
+
+    int bands = 1;
+    if (ctx.executor() && lineCount > 1) {
+        int64_t pixels = (int64_t)lineCount * lineCost;
+        bands = (int)SkTMin<int64_t>(SkTMin(lineCount, kMaxBands), pixels / kMinPixelsPerBand);
+    }
+    if (bands <= 1) {
+        fn(0, lineCount);
+        return;
+    }
+
+    SkTaskGroup tasks(*ctx.executor());
+    tasks.batch(bands, [&](int band) {
+        fn((int)((int64_t)lineCount *  band      / bands),
+           (int)((int64_t)lineCount * (band + 1) / bands));
+    });
+    tasks.wait();
+}
+
 void SkImageFilter::PurgeCache() {
     SkImageFilterCache::Get()->purge();
 }
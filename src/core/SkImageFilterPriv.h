@@ -10,6 +10,8 @@
 
 #include "SkImageFilter.h"
 
+#include <functional>
+
 /**
  *  Helper to unflatten the common data, and return nullptr if we fail.
  */
@@ -21,4 +23,13 @@
         }                                                           \
     } while (0)
 
+/**
+ *  Calls fn(begin, end) to process lines [begin, end) of a CPU filter's output, where there are
+ *  lineCount independent lines, each costing about as much as touching lineCost pixels. If the
+ *  context has an executor and the lines are worth splitting up, fn is called concurrently on
+ *  bands of them. Otherwise this is just fn(0, lineCount).
+ */
+void SkImageFilterForBands(const SkImageFilter::Context& ctx, int lineCount, int lineCost,
+                           const std::function<void(int begin, int end)>& fn);
+
 #endif
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkMappedPicture.h"
+
+#include "SkPictureData.h"
+#include "SkPicturePlayback.h"
+#include "SkTextBlob.h"  // SkPictureData holds these.
+
+SkMappedPicture::SkMappedPicture(const SkRect& cull, std::unique_ptr<const SkPictureData> data)
+    : fCullRect(cull)
+    , fData(std::move(data))
+    , fOpCount(0) {
+    SkASSERT(fData && fData->opData());
+}
+
+SkMappedPicture::~SkMappedPicture() {}
+
+void SkMappedPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
+    SkASSERT(canvas);
+    // Each playback gets its own reader, so we may be drawn from several threads at once.
+    SkPicturePlayback(fData.get()).draw(canvas, callback, nullptr);
+}
+
+SkRect SkMappedPicture::cullRect() const { return fCullRect; }
+
+int SkMappedPicture::approximateOpCount() const {
+    fOpCountOnce([this] { fOpCount = SkPicturePlayback::CountOps(fData.get()); });
+    return fOpCount;
+}
+
+size_t SkMappedPicture::approximateBytesUsed() const {
+    // The op data lives in the mapping, which we don't own.
+    return sizeof(*this) + sizeof(SkPictureData);
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMappedPicture_DEFINED
+#define SkMappedPicture_DEFINED
+
+#include "SkOnce.h"
+#include "SkPicture.h"
+#include "SkRect.h"
+
+#include <memory>
+
+class SkPictureData;
+
+// An SkPicture that plays back straight from SkPictureData, instead of from an SkRecord.
+// SkPicture::MakeFromMappedData() returns these, so that the ops of a mapped SKP are read from
+// the mapping on every playback and never copied.
+class SkMappedPicture final : public SkPicture {
+public:
+    SkMappedPicture(const SkRect& cull, std::unique_ptr<const SkPictureData>);
+    ~SkMappedPicture() override;
+
+    void   playback(SkCanvas*, AbortCallback*) const override;
+    SkRect cullRect()             const override;
+    int    approximateOpCount()   const override;
+    size_t approximateBytesUsed() const override;
+
+private:
+    const SkRect                         fCullRect;
+    std::unique_ptr<const SkPictureData> fData;
+
+    // Counting walks every op, so we only do it if asked.
+    mutable SkOnce fOpCountOnce;
+    mutable int    fOpCount;
+};
+
+#endif//SkMappedPicture_DEFINED
@@ -12,6 +12,7 @@
 #include "SkGaussFilter.h"
 #include "SkMalloc.h"
 #include "SkNx.h"
+#include "SkOpts.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 
@@ -27,6 +28,7 @@ public:
         auto possibleWindow = static_cast<int>(floor(sigma * 3 * sqrt(2 * kPi) / 4 + 0.5));
         auto window = std::max(1, possibleWindow);
 
+        fWindow = window;
         fPass0Size = window - 1;
         fPass1Size = window - 1;
         fPass2Size = (window & 1) == 1 ? window - 1 : window;
@@ -226,7 +228,37 @@ public:
             buffer2, buffer2End);
     }
 
+    // Blurs the columns of src, width wide and srcH high, into dst, which is 2 * border() rows
+    // taller. This gives the same results as running a Scan down each column, but walks the
+    // image a row at a time; see SkOpts::box_blur_columns.
+    void blurColumns(const uint8_t* src, int width, int srcH,
+                     uint8_t* dst, size_t dstRB, int dstH) const {
+        SkASSERT(dstH == srcH + 2 * fBorder);
+        if (fWindow == 1) {
+            for (int y = 0; y < srcH; ++y) {
+                memcpy(dst + y * dstRB, src + y * width, width);
+            }
+            return;
+        }
+
+        // Like Scan, run down from the top through the source and as many rows past it as are
+        // still inside the window...
+        int noChangeCount = fSlidingWindow > srcH ? fSlidingWindow - srcH : 0;
+        int forwardH = std::min(srcH + noChangeCount, dstH);
+        SkOpts::box_blur_columns(src, width, 0, srcH,
+                                 dst, dstRB, forwardH,
+                                 width, fWindow, true);
+
+        // ... then fill in the rest running up from the bottom.
+        if (forwardH < dstH) {
+            SkOpts::box_blur_columns(src + (srcH - 1) * width, -width, 0, srcH,
+                                     dst + (dstH - 1) * dstRB, -(ptrdiff_t)dstRB, dstH - forwardH,
+                                     width, fWindow, true);
+        }
+    }
+
     uint64_t fWeight;
+    int      fWindow;
     int      fBorder;
     int      fSlidingWindow;
     int      fPass0Size;
@@ -986,12 +1018,12 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
     auto buffer = alloc.makeArrayDefault<uint32_t>(bufferSize);
 
     // Blur both directions.
-    int tmpW = srcH,
-        tmpH = dstW;
+    int tmpW = dstW,
+        tmpH = srcH;
 
     auto tmp = alloc.makeArrayDefault<uint8_t>(tmpW * tmpH);
 
-    // Blur horizontally, and transpose.
+    // Blur horizontally.
     const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, buffer);
     switch (src.fFormat) {
         case SkMask::kBW_Format: {
@@ -999,8 +1031,8 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
             auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
             auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
             for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                auto tmpStart = &tmp[y * tmpW];
+                scanW.blur(start, end, tmpStart, 1, tmpStart + tmpW);
             }
         } break;
         case SkMask::kA8_Format: {
@@ -1008,8 +1040,8 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
             auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
             auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
             for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                auto tmpStart = &tmp[y * tmpW];
+                scanW.blur(start, end, tmpStart, 1, tmpStart + tmpW);
             }
         } break;
         case SkMask::kARGB32_Format: {
@@ -1017,8 +1049,8 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
             auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
             auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
             for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                auto tmpStart = &tmp[y * tmpW];
+                scanW.blur(start, end, tmpStart, 1, tmpStart + tmpW);
             }
         } break;
         case SkMask::kLCD16_Format: {
@@ -1026,24 +1058,16 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
             auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
             auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
             for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                auto tmpStart = &tmp[y * tmpW];
+                scanW.blur(start, end, tmpStart, 1, tmpStart + tmpW);
             }
         } break;
         default:
             SK_ABORT("Unhandled format.");
     }
 
-    // Blur vertically (scan in memory order because of the transposition),
-    // and transpose back to the original orientation.
-    const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer);
-    for (int y = 0; y < tmpH; y++) {
-        auto tmpStart = &tmp[y * tmpW];
-        auto dstStart = &dst->fImage[y];
-
-        scanH.blur(tmpStart, tmpStart + tmpW,
-                   dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
-    }
+    // Blur vertically.
+    planH.blurColumns(tmp, tmpW, tmpH, dst->fImage, dst->fRowBytes, dstH);
 
     return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
 }
@@ -7,10 +7,14 @@
 
 #include "SkCanvas.h"
 #include "SkCanvasPriv.h"
+#include "SkExecutor.h"
 #include "SkMultiPictureDraw.h"
 #include "SkPicture.h"
 #include "SkTaskGroup.h"
 
+#include <algorithm>
+#include <functional>
+
 void SkMultiPictureDraw::DrawData::draw() {
     fCanvas->drawPicture(fPicture, &fMatrix, fPaint);
 }
@@ -41,7 +45,8 @@ void SkMultiPictureDraw::DrawData::Reset(SkTDArray<DrawData>& data) {
 
 //////////////////////////////////////////////////////////////////////////////////////
 
-SkMultiPictureDraw::SkMultiPictureDraw(int reserve) {
+SkMultiPictureDraw::SkMultiPictureDraw(int reserve, SkExecutor* executor)
+    : fExecutor(executor ? executor : &SkExecutor::GetDefault()) {
     if (reserve > 0) {
         fGPUDrawData.setReserve(reserve);
         fThreadSafeDrawData.setReserve(reserve);
@@ -78,14 +83,43 @@ public:
 void SkMultiPictureDraw::draw(bool flush) {
     AutoMPDReset mpdreset(this);
 
+    // A canvas is not thread safe, so group the draws by canvas, keeping the order in which they
+    // were added. Each group then becomes a single task.
+    const int threadSafeCount = fThreadSafeDrawData.count();
+    SkTDArray<int> order;
+    order.setCount(threadSafeCount);
+    for (int i = 0; i < threadSafeCount; ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return std::less<SkCanvas*>()(fThreadSafeDrawData[a].fCanvas,
+                                      fThreadSafeDrawData[b].fCanvas);
+    });
+
+    SkTDArray<int> groupStarts;
+    for (int i = 0; i < threadSafeCount; ++i) {
+        if (0 == i ||
+            fThreadSafeDrawData[order[i]].fCanvas != fThreadSafeDrawData[order[i - 1]].fCanvas) {
+            groupStarts.push_back(i);
+        }
+    }
+    groupStarts.push_back(threadSafeCount);
+
+    auto drawGroup = [&](int group) {
+        for (int i = groupStarts[group]; i < groupStarts[group + 1]; ++i) {
+            fThreadSafeDrawData[order[i]].draw();
+        }
+        if (flush) {
+            fThreadSafeDrawData[order[groupStarts[group]]].fCanvas->flush();
+        }
+    };
+
 #ifdef FORCE_SINGLE_THREAD_DRAWING_FOR_TESTING
-    for (int i = 0; i < fThreadSafeDrawData.count(); ++i) {
-        fThreadSafeDrawData[i].draw();
+    for (int group = 0; group < groupStarts.count() - 1; ++group) {
+        drawGroup(group);
     }
 #else
-    SkTaskGroup().batch(fThreadSafeDrawData.count(), [&](int i) {
-        fThreadSafeDrawData[i].draw();
-    });
+    SkTaskGroup(*fExecutor).batch(groupStarts.count() - 1, drawGroup);
 #endif
 
     // N.B. we could get going on any GPU work from this main thread while the CPU work runs.
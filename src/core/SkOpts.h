@@ -53,6 +53,13 @@ namespace SkOpts {
         return hash_fn(data, bytes, seed);
     }
 
+    // Blurs lanes bytes down the columns of src into dst with three box filters of width window.
+    // Used for the vertical passes of SkBlurImageFilter and SkMaskBlurFilter; see
+    // src/opts/SkBoxBlur_opts.h for the details.
+    extern void (*box_blur_columns)(const uint8_t* src, ptrdiff_t srcRB, int srcStart, int srcEnd,
+                                    uint8_t* dst, ptrdiff_t dstRB, int dstEnd,
+                                    int lanes, int window, bool roundProduct);
+
     // SkBitmapProcState optimized Shader, Sample, or Matrix procs.
     // This is the only one that can use anything past SSE2/NEON.
     extern void (*S32_alpha_D32_filter_DX)(const SkBitmapProcState&,
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPackedRTree.h"
+#include "SkTSort.h"
+
+#include <algorithm>
+#include <cstring>
+
+static constexpr uintptr_t kCacheLine = 64;
+
+static float area(const SkRect& r) {
+    return r.width() * r.height();
+}
+
+SkPackedRTree::SkPackedRTree()
+    : fCount(0)
+    , fNodeCount(0)
+    , fRootBounds(SkRect::MakeEmpty())
+    , fNodes(nullptr) {}
+
+SkRect SkPackedRTree::getRootBound() const {
+    return fRootBounds;
+}
+
+void SkPackedRTree::insert(const SkRect boundsArray[], int N) {
+    SkASSERT(0 == fCount);
+
+    SkTDArray<Item> items;
+    items.setReserve(N);
+    for (int i = 0; i < N; i++) {
+        if (!boundsArray[i].isEmpty()) {
+            items.push_back({boundsArray[i], i});
+        }
+    }
+
+    fCount = items.count();
+    if (0 == fCount) {
+        return;
+    }
+
+    // Each leaf holds at least one item and each interior node at least two children.
+    SkTDArray<Node> nodes;
+    SkTDArray<Children> children;
+    nodes.setReserve(SkTMax(1, 2 * fCount / kFanout));
+    children.setReserve(nodes.reserved());
+
+    SkAutoTMalloc<SkRect> scratch(fCount);
+    SkDEBUGCODE(int root =) this->build(&nodes, &children, items.begin(), scratch.get(),
+                                        0, fCount, &fRootBounds);
+    SkASSERT(0 == root);
+
+    // Copy the nodes into their final, cache-line-aligned home.
+    fNodeCount = nodes.count();
+    fStorage.reset(fNodeCount * sizeof(Node) + kCacheLine - 1);
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(fStorage.get()) + kCacheLine - 1)
+                      & ~(kCacheLine - 1);
+    memcpy(reinterpret_cast<void*>(aligned), nodes.begin(), fNodeCount * sizeof(Node));
+    fNodes = reinterpret_cast<const Node*>(aligned);
+
+    fChildren.reset(fNodeCount);
+    memcpy(fChildren.get(), children.begin(), fNodeCount * sizeof(Children));
+}
+
+int SkPackedRTree::build(SkTDArray<Node>* nodes, SkTDArray<Children>* children,
+                         Item items[], SkRect scratch[], int begin, int end,
+                         SkRect* bounds) {
+    SkASSERT(begin < end);
+
+    // Nodes are pushed in pre-order, so a node's first child directly follows it in memory.
+    const int index = nodes->count();
+    nodes->append();
+    children->append();
+
+    SkRect childBounds[kFanout];
+    int32_t slots[kFanout];
+    int childCount = 0;
+
+    if (end - begin <= kFanout) {
+        for (int i = begin; i < end; ++i) {
+            childBounds[childCount] = items[i].fBounds;
+            slots[childCount] = ~items[i].fIndex;
+            childCount++;
+        }
+    } else {
+        // Split in two, then split each half again if it won't fit in a single leaf.
+        int runs[kFanout + 1];
+        int runCount = 0;
+        const int mid = Split(items, scratch, begin, end);
+        for (int run : { begin, mid }) {
+            const int runEnd = run == begin ? mid : end;
+            runs[runCount++] = run;
+            if (runEnd - run > kFanout) {
+                runs[runCount++] = Split(items, scratch, run, runEnd);
+            }
+        }
+        runs[runCount] = end;
+
+        for (int i = 0; i < runCount; ++i) {
+            slots[childCount] = this->build(nodes, children, items, scratch,
+                                            runs[i], runs[i + 1], &childBounds[childCount]);
+            childCount++;
+        }
+    }
+
+    // Don't hold on to pointers into nodes across the recursive calls above; they may realloc.
+    Node& node = (*nodes)[index];
+    Children& links = (*children)[index];
+    bounds->setEmpty();
+    for (int i = 0; i < kFanout; ++i) {
+        if (i < childCount) {
+            node.fLeft  [i] = childBounds[i].fLeft;
+            node.fTop   [i] = childBounds[i].fTop;
+            node.fRight [i] = childBounds[i].fRight;
+            node.fBottom[i] = childBounds[i].fBottom;
+            links.fSlot [i] = slots[i];
+            bounds->join(childBounds[i]);
+        } else {
+            // An inverted box fails every intersection test, so unused slots are never visited.
+            node.fLeft  [i] = node.fTop   [i] = +SK_ScalarInfinity;
+            node.fRight [i] = node.fBottom[i] = -SK_ScalarInfinity;
+            links.fSlot [i] = slots[0];
+        }
+    }
+    return index;
+}
+
+int SkPackedRTree::SweepSplit(const Item items[], SkRect scratch[], int begin, int end,
+                              float* bestCost) {
+    const int count = end - begin;
+
+    // Keep at least an eighth of the items on each side. Without this, inputs like concentric
+    // rects would degenerate into a list, and the tree depth into the item count.
+    const int minSide = SkTMax(1, count / 8);
+
+    // scratch[i] holds the bounds of items [i, end).
+    scratch[end - 1] = items[end - 1].fBounds;
+    for (int i = end - 2; i >= begin; --i) {
+        scratch[i] = scratch[i + 1];
+        scratch[i].join(items[i].fBounds);
+    }
+
+    int best = begin + count / 2;
+    *bestCost = SK_ScalarInfinity;
+    SkRect prefix = items[begin].fBounds;   // Bounds of items [begin, split).
+    for (int split = begin + 1; split < end; ++split) {
+        const int left  = split - begin,
+                  right = end - split;
+        if (left >= minSide && right >= minSide) {
+            // Cost is counted in leaves rather than items, which favors full leaves.
+            const float cost = area(prefix)         * ((left  + kFanout - 1) / kFanout)
+                             + area(scratch[split]) * ((right + kFanout - 1) / kFanout);
+            // On ties prefer the more balanced split.
+            if (cost < *bestCost ||
+                (cost == *bestCost && SkTAbs(left - right) < SkTAbs(2 * best - begin - end))) {
+                best = split;
+                *bestCost = cost;
+            }
+        }
+        prefix.join(items[split].fBounds);
+    }
+    return best;
+}
+
+int SkPackedRTree::Split(Item items[], SkRect scratch[], int begin, int end) {
+    SkASSERT(end - begin >= 2);
+
+    auto byX = [](const Item& a, const Item& b) {
+        return a.fBounds.centerX() < b.fBounds.centerX();
+    };
+    auto byY = [](const Item& a, const Item& b) {
+        return a.fBounds.centerY() < b.fBounds.centerY();
+    };
+
+    // Try both axes. Sorting is stable so that equal centers keep their recording order.
+    float costX, costY;
+    std::stable_sort(items + begin, items + end, byX);
+    const int splitX = SweepSplit(items, scratch, begin, end, &costX);
+    std::stable_sort(items + begin, items + end, byY);
+    const int splitY = SweepSplit(items, scratch, begin, end, &costY);
+
+    if (costY <= costX) {
+        return splitY;
+    }
+    std::stable_sort(items + begin, items + end, byX);
+    return splitX;
+}
+
+void SkPackedRTree::search(const SkRect& query, SkTDArray<int>* results) const {
+    const int before = results->count();
+    this->visit(query, [results](int index) { results->push_back(index); });
+
+    // Playback expects hits in recording order.
+    if (results->count() - before > 1) {
+        SkTQSort(results->begin() + before, results->end() - 1);
+    }
+}
+
+size_t SkPackedRTree::bytesUsed() const {
+    size_t byteCount = sizeof(SkPackedRTree);
+
+    if (fNodeCount) {
+        byteCount += fNodeCount * sizeof(Node) + kCacheLine - 1;
+        byteCount += fNodeCount * sizeof(Children);
+    }
+
+    return byteCount;
+}
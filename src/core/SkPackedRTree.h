@@ -0,0 +1,143 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPackedRTree_DEFINED
+#define SkPackedRTree_DEFINED
+
+#include "SkBBoxHierarchy.h"
+#include "SkNx.h"
+#include "SkRect.h"
+#include "SkTArray.h"
+#include "SkTemplates.h"
+
+/**
+ * A bulk-loaded 4-ary bounding box hierarchy tuned for query speed on large pictures.
+ *
+ * Unlike SkRTree, nodes live in a single flat array, one 64-byte cache line per node. Each node
+ * stores the bounds of its four children in structure-of-arrays form, so all four children are
+ * tested against a query with a handful of Sk4f compares. Nodes are laid out in depth-first order,
+ * so a descent usually walks forward through memory.
+ *
+ * The tree is built top-down using the surface area heuristic (SAH): each run of boxes is sorted
+ * by center along x and along y, and split where the summed area of the two halves, weighted by
+ * their counts, is smallest. This is slower to build than SkRTree's STR bulk load, but does not
+ * depend on the boxes arriving in a spatially coherent order.
+ */
+class SkPackedRTree : public SkBBoxHierarchy {
+public:
+    SkPackedRTree();
+    ~SkPackedRTree() override {}
+
+    void insert(const SkRect[], int N) override;
+    void search(const SkRect& query, SkTDArray<int>* results) const override;
+    size_t bytesUsed() const override;
+    SkRect getRootBound() const override;
+
+    /**
+     * Calls visitor(int index) for every inserted box that intersects query, without
+     * materializing a result array. Unlike search(), hits are not reported in index order.
+     */
+    template <typename Visitor>
+    void visit(const SkRect& query, Visitor&& visitor) const;
+
+    // Methods and constants below here are only public for tests.
+
+    // Insertion count of non-empty boxes (not the node count).
+    int getCount() const { return fCount; }
+    int getNodeCount() const { return fNodeCount; }
+
+    static constexpr int kFanout = 4;
+
+private:
+    // Exactly one cache line. Unused slots hold an inverted (never intersecting) box.
+    struct Node {
+        float fLeft  [kFanout],
+              fTop   [kFanout],
+              fRight [kFanout],
+              fBottom[kFanout];
+    };
+    static_assert(sizeof(Node) == 64, "Node should fill one cache line.");
+
+    // For each child slot: a node index if >= 0, or ~index of an inserted box if < 0.
+    struct Children {
+        int32_t fSlot[kFanout];
+    };
+
+    struct Item {
+        SkRect fBounds;
+        int    fIndex;
+    };
+
+    // Builds the subtree for items [begin, end), returning its node index and its bounds.
+    // Reorders items within that range.
+    int build(SkTDArray<Node>* nodes, SkTDArray<Children>* children,
+              Item items[], SkRect scratch[], int begin, int end, SkRect* bounds);
+
+    // Sorts items [begin, end) along the better axis, returning the SAH split point in that order.
+    // There is always at least one item on each side.
+    static int Split(Item items[], SkRect scratch[], int begin, int end);
+
+    // Returns the cheapest split point of items [begin, end) in their current order.
+    static int SweepSplit(const Item items[], SkRect scratch[], int begin, int end, float* cost);
+
+    int                      fCount;
+    int                      fNodeCount;
+    SkRect                   fRootBounds;
+    SkAutoTMalloc<char>      fStorage;     // fNodes points into this, aligned to 64 bytes.
+    const Node*              fNodes;
+    SkAutoTMalloc<Children>  fChildren;
+
+    typedef SkBBoxHierarchy INHERITED;
+};
+
+template <typename Visitor>
+void SkPackedRTree::visit(const SkRect& query, Visitor&& visitor) const {
+    if (0 == fCount || !SkRect::Intersects(fRootBounds, query)) {
+        return;
+    }
+
+    const Sk4f qL(query.fLeft), qT(query.fTop), qR(query.fRight), qB(query.fBottom),
+               zero(0.0f);
+
+    SkSTArray<64, int, true> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const int index = stack.back();
+        stack.pop_back();
+
+        // Same test as SkRect::Intersects(), for all four children at once. Each compare yields
+        // a lane mask; thenElse() ANDs them together.
+        const Node& node = fNodes[index];
+        Sk4f hit = (Sk4f::Load(node.fLeft) < qR).thenElse(qL < Sk4f::Load(node.fRight), zero);
+        hit = (Sk4f::Load(node.fTop) < qB).thenElse(hit, zero);
+        hit = (qT < Sk4f::Load(node.fBottom)).thenElse(hit, zero);
+        if (!hit.anyTrue()) {
+            continue;
+        }
+
+        int32_t mask[kFanout];
+        hit.store(mask);
+        const int32_t* slots = fChildren[index].fSlot;
+        if (slots[0] < 0) {
+            // A leaf: every slot is an inserted box.
+            for (int i = 0; i < kFanout; ++i) {
+                if (mask[i]) {
+                    visitor(~slots[i]);
+                }
+            }
+        } else {
+            // Push in reverse so that children are visited left to right, in memory order.
+            for (int i = kFanout - 1; i >= 0; --i) {
+                if (mask[i]) {
+                    stack.push_back(slots[i]);
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -10,6 +10,7 @@
 #include "SkBuffer.h"
 #include "SkCubicClipper.h"
 #include "SkData.h"
+#include "SkEdgeBuilder.h"
 #include "SkGeometry.h"
 #include "SkMacros.h"
 #include "SkMath.h"
@@ -3681,6 +3682,14 @@ int SkPath::ConvertConicToQuads(const SkPoint& p0, const SkPoint& p1, const SkPo
     return conic.chopIntoQuadsPOW2(pts, pow2);
 }
 
+sk_sp<SkEdgeCache> SkPathPriv::EdgeCache(const SkPath& path) {
+    return sk_sp<SkEdgeCache>(path.fPathRef->refEdgeCache());
+}
+
+void SkPathPriv::SetEdgeCache(const SkPath& path, sk_sp<SkEdgeCache> cache) {
+    path.fPathRef->setEdgeCache(cache.release());
+}
+
 bool SkPathPriv::IsSimpleClosedRect(const SkPath& path, SkRect* rect, SkPath::Direction* direction,
                                     unsigned* start) {
     if (path.getSegmentMasks() != SkPath::kLine_SegmentMask) {
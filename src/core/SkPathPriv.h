@@ -10,6 +10,8 @@
 
 #include "SkPath.h"
 
+class SkEdgeCache;
+
 #define SK_TREAT_COLINEAR_DIAGONAL_POINTS_AS_CONCAVE 0
 
 #if SK_TREAT_COLINEAR_DIAGONAL_POINTS_AS_CONCAVE
@@ -107,6 +109,13 @@ public:
     static bool IsSimpleClosedRect(const SkPath& path, SkRect* rect, SkPath::Direction* direction,
                                    unsigned* start);
 
+    /**
+     *  The edges SkEdgeBuilder cached on path's SkPathRef, or null. They may have been built from
+     *  an earlier generation of the path, and are dropped when its genID changes.
+     */
+    static sk_sp<SkEdgeCache> EdgeCache(const SkPath& path);
+    static void SetEdgeCache(const SkPath& path, sk_sp<SkEdgeCache> cache);
+
     /**
      * Creates a path from arc params using the semantics of SkCanvas::drawArc. This function
      * assumes empty ovals and zero sweeps have already been filtered out.
@@ -8,6 +8,7 @@
 #include "SkPathRef.h"
 
 #include "SkBuffer.h"
+#include "SkEdgeBuilder.h"
 #include "SkNx.h"
 #include "SkOnce.h"
 #include "SkPath.h"
@@ -739,6 +740,23 @@ void SkPathRef::callGenIDChangeListeners() {
     }
 
     fGenIDChangeListeners.reset();
+
+    this->setEdgeCache(nullptr);
+}
+
+SkEdgeCache* SkPathRef::refEdgeCache() const {
+    SkAutoExclusive lock(fEdgeCacheLock);
+    return SkSafeRef(fEdgeCache);
+}
+
+void SkPathRef::setEdgeCache(SkEdgeCache* cache) const {
+    SkEdgeCache* old;
+    {
+        SkAutoExclusive lock(fEdgeCacheLock);
+        old = fEdgeCache;
+        fEdgeCache = cache;
+    }
+    SkSafeUnref(old);
 }
 
 SkRRect SkPathRef::getRRect() const {
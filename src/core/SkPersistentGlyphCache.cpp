@@ -0,0 +1,635 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPersistentGlyphCache.h"
+
+#include "SkAutoMalloc.h"
+#include "SkOpts.h"
+#include "SkPath.h"
+#include "SkScalerContext.h"
+#include "SkStream.h"
+#include "SkTo.h"
+#include "SkTypeface.h"
+
+#include <algorithm>
+
+// The file is a FileHeader followed by fStrikeCount strikes. Each strike is a StrikeHeader, its
+// key descriptor, fGlyphCount Records sorted by packed ID, and then fBlobSize bytes of images
+// and paths. Record offsets are from the start of the file. Everything is 4-byte aligned.
+namespace {
+
+static constexpr uint32_t kMagic   = SkSetFourByteTag('s', 'k', 'g', 'c');
+static constexpr uint32_t kVersion = 1;
+
+struct FileHeader {
+    uint32_t fMagic;
+    uint32_t fVersion;
+    uint32_t fStrikeCount;
+    uint32_t fUnused;
+};
+
+struct StrikeHeader {
+    uint32_t      fKeySize;
+    uint32_t      fGlyphCount;
+    uint32_t      fBlobSize;
+    uint32_t      fHasFontMetrics;
+    SkFontMetrics fFontMetrics;
+};
+
+static_assert(sizeof(FileHeader)   % 4 == 0, "");
+static_assert(sizeof(StrikeHeader) % 4 == 0, "");
+
+// Reads consecutive 4-byte aligned chunks from data, never past its end.
+class Reader {
+public:
+    Reader(const uint8_t* base, size_t size) : fBase(base), fSize(size), fOffset(0) {}
+
+    const void* read(size_t size) {
+        if (size > fSize - fOffset || !SkIsAlign4(size)) {
+            return nullptr;
+        }
+        const uint8_t* ptr = fBase + fOffset;
+        fOffset += size;
+        return ptr;
+    }
+
+    size_t offset() const { return fOffset; }
+    bool eof() const { return fOffset == fSize; }
+
+private:
+    const uint8_t* fBase;
+    size_t         fSize;
+    size_t         fOffset;
+};
+
+}  // namespace
+
+using Record = SkPersistentGlyphCache::Strike::Record;
+
+static void record_to_glyph(const Record& rec, SkGlyph* glyph) {
+    glyph->fAdvanceX   = rec.fAdvanceX;
+    glyph->fAdvanceY   = rec.fAdvanceY;
+    glyph->fWidth      = rec.fWidth;
+    glyph->fHeight     = rec.fHeight;
+    glyph->fTop        = rec.fTop;
+    glyph->fLeft       = rec.fLeft;
+    glyph->fForceBW    = rec.fForceBW;
+    glyph->fMaskFormat = rec.fMaskFormat;
+}
+
+static void copy_metrics(const Record& src, Record* dst) {
+    dst->fAdvanceX   = src.fAdvanceX;
+    dst->fAdvanceY   = src.fAdvanceY;
+    dst->fWidth      = src.fWidth;
+    dst->fHeight     = src.fHeight;
+    dst->fTop        = src.fTop;
+    dst->fLeft       = src.fLeft;
+    dst->fForceBW    = src.fForceBW;
+    dst->fMaskFormat = src.fMaskFormat;
+    dst->fFlags     |= Record::kMetrics_Flag;
+}
+
+static void glyph_to_record(const SkGlyph& glyph, Record* rec) {
+    rec->fAdvanceX   = glyph.fAdvanceX;
+    rec->fAdvanceY   = glyph.fAdvanceY;
+    rec->fWidth      = glyph.fWidth;
+    rec->fHeight     = glyph.fHeight;
+    rec->fTop        = glyph.fTop;
+    rec->fLeft       = glyph.fLeft;
+    rec->fForceBW    = glyph.fForceBW;
+    rec->fMaskFormat = glyph.fMaskFormat;
+    rec->fFlags     |= Record::kMetrics_Flag;
+}
+
+static bool same_image_metrics(const Record& rec, const SkGlyph& glyph) {
+    return rec.fWidth      == glyph.fWidth
+        && rec.fHeight     == glyph.fHeight
+        && rec.fMaskFormat == glyph.fMaskFormat;
+}
+
+static size_t image_size(const Record& rec) {
+    SkGlyph glyph{SkPackedGlyphID()};
+    record_to_glyph(rec, &glyph);
+    return glyph.computeImageSize();
+}
+
+// Glyphs this wide or tall are never given images, so their metrics are not kept, and a file
+// with them is corrupt.
+static bool recordable_metrics(int width, int height) {
+    return width < kMaxGlyphWidth && height < kMaxGlyphWidth;
+}
+
+static bool valid_metrics(const Record& rec) {
+    return SkMask::IsValidFormat(rec.fMaskFormat) &&
+           recordable_metrics(rec.fWidth, rec.fHeight) &&
+           SkTFitsIn<uint32_t>(image_size(rec));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+SkPersistentGlyphCache::Strike::Strike(const SkDescriptor& key, SkPersistentGlyphCache* owner)
+    : fKey(key)
+    , fOwner(owner) {}
+
+const Record* SkPersistentGlyphCache::Strike::findRecord(uint32_t packedID) const {
+    const Record* end = fRecords + fRecordCount;
+    const Record* rec = std::lower_bound(fRecords, end, packedID,
+                                         [](const Record& r, uint32_t v) {
+                                             return r.fPackedID < v;
+                                         });
+    return rec != end && rec->fPackedID == packedID ? rec : nullptr;
+}
+
+auto SkPersistentGlyphCache::Strike::findOrAddGlyph(SkPackedGlyphID id) -> AddedGlyph* {
+    if (AddedGlyph* glyph = fAdded.find(id.value())) {
+        return glyph;
+    }
+    if (!fOwner->reserveAddedBytes(sizeof(AddedGlyph))) {
+        return nullptr;
+    }
+    AddedGlyph glyph;
+    memset(&glyph.fRecord, 0, sizeof(Record));
+    glyph.fRecord.fPackedID = id.value();
+    return fAdded.set(id.value(), std::move(glyph));
+}
+
+bool SkPersistentGlyphCache::Strike::findFontMetrics(SkFontMetrics* metrics) const {
+    SkAutoExclusive lock(fLock);
+    if (fHasFontMetrics) {
+        *metrics = fFontMetrics;
+    }
+    return fHasFontMetrics;
+}
+
+void SkPersistentGlyphCache::Strike::addFontMetrics(const SkFontMetrics& metrics) {
+    SkAutoExclusive lock(fLock);
+    fFontMetrics = metrics;
+    fHasFontMetrics = true;
+}
+
+bool SkPersistentGlyphCache::Strike::findMetrics(SkGlyph* glyph) const {
+    // Records never change, so they can be read without the lock.
+    const Record* rec = this->findRecord(glyph->getPackedID().value());
+    if (rec && (rec->fFlags & Record::kMetrics_Flag)) {
+        record_to_glyph(*rec, glyph);
+        return true;
+    }
+
+    SkAutoExclusive lock(fLock);
+    const AddedGlyph* added = fAdded.find(glyph->getPackedID().value());
+    if (added && (added->fRecord.fFlags & Record::kMetrics_Flag)) {
+        record_to_glyph(added->fRecord, glyph);
+        return true;
+    }
+    return false;
+}
+
+void SkPersistentGlyphCache::Strike::addMetrics(const SkGlyph& glyph) {
+    if (!glyph.isFullMetrics() || !recordable_metrics(glyph.fWidth, glyph.fHeight)) {
+        return;
+    }
+    const Record* rec = this->findRecord(glyph.getPackedID().value());
+    if (rec && (rec->fFlags & Record::kMetrics_Flag)) {
+        return;
+    }
+
+    SkAutoExclusive lock(fLock);
+    AddedGlyph* added = this->findOrAddGlyph(glyph.getPackedID());
+    if (added && !(added->fRecord.fFlags & Record::kMetrics_Flag)) {
+        glyph_to_record(glyph, &added->fRecord);
+    }
+}
+
+const void* SkPersistentGlyphCache::Strike::findImage(const SkGlyph& glyph) const {
+    const Record* rec = this->findRecord(glyph.getPackedID().value());
+    if (rec && (rec->fFlags & Record::kImage_Flag) && same_image_metrics(*rec, glyph)) {
+        return fBase + rec->fImageOffset;
+    }
+
+    SkAutoExclusive lock(fLock);
+    const AddedGlyph* added = fAdded.find(glyph.getPackedID().value());
+    if (added && added->fImage && same_image_metrics(added->fRecord, glyph)) {
+        // The SkData is never replaced or freed while this strike lives.
+        return added->fImage->data();
+    }
+    return nullptr;
+}
+
+void SkPersistentGlyphCache::Strike::addImage(const SkGlyph& glyph) {
+    if (!glyph.fImage || !glyph.isFullMetrics() ||
+        !recordable_metrics(glyph.fWidth, glyph.fHeight)) {
+        return;
+    }
+    const Record* rec = this->findRecord(glyph.getPackedID().value());
+    if (rec && (rec->fFlags & Record::kImage_Flag)) {
+        return;
+    }
+
+    SkAutoExclusive lock(fLock);
+    AddedGlyph* added = this->findOrAddGlyph(glyph.getPackedID());
+    if (added && !added->fImage && fOwner->reserveAddedBytes(glyph.computeImageSize())) {
+        // Keep the metrics that go with the image.
+        glyph_to_record(glyph, &added->fRecord);
+        added->fImage = SkData::MakeWithCopy(glyph.fImage, glyph.computeImageSize());
+        added->fRecord.fFlags |= Record::kImage_Flag;
+    }
+}
+
+bool SkPersistentGlyphCache::Strike::findPath(SkPackedGlyphID id, SkPath* path,
+                                              bool* hasPath) const {
+    const Record* rec = this->findRecord(id.value());
+    if (rec && (rec->fFlags & Record::kPath_Flag)) {
+        *hasPath = rec->fPathSize > 0;
+        return !*hasPath || path->readFromMemory(fBase + rec->fPathOffset, rec->fPathSize) != 0;
+    }
+
+    SkAutoExclusive lock(fLock);
+    const AddedGlyph* added = fAdded.find(id.value());
+    if (added && (added->fRecord.fFlags & Record::kPath_Flag)) {
+        *hasPath = added->fPath != nullptr;
+        return !*hasPath || path->readFromMemory(added->fPath->data(), added->fPath->size()) != 0;
+    }
+    return false;
+}
+
+void SkPersistentGlyphCache::Strike::addPath(SkPackedGlyphID id, const SkPath* path) {
+    const Record* rec = this->findRecord(id.value());
+    if (rec && (rec->fFlags & Record::kPath_Flag)) {
+        return;
+    }
+
+    sk_sp<SkData> data;
+    if (path) {
+        data = SkData::MakeUninitialized(path->writeToMemory(nullptr));
+        path->writeToMemory(data->writable_data());
+    }
+
+    SkAutoExclusive lock(fLock);
+    AddedGlyph* added = this->findOrAddGlyph(id);
+    if (added && !(added->fRecord.fFlags & Record::kPath_Flag) &&
+        fOwner->reserveAddedBytes(data ? data->size() : 0)) {
+        added->fPath = std::move(data);
+        added->fRecord.fFlags |= Record::kPath_Flag;
+    }
+}
+
+int SkPersistentGlyphCache::Strike::countGlyphs() const {
+    SkAutoExclusive lock(fLock);
+    int count = fRecordCount;
+    fAdded.foreach([&](uint32_t id, const AddedGlyph&) {
+        count += this->findRecord(id) ? 0 : 1;
+    });
+    return count;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+sk_sp<SkPersistentGlyphCache> SkPersistentGlyphCache::Make(sk_sp<SkData> data) {
+    sk_sp<SkPersistentGlyphCache> cache(new SkPersistentGlyphCache(std::move(data)));
+    if (!cache->parse()) {
+        cache.reset(new SkPersistentGlyphCache(nullptr));
+    }
+    return cache;
+}
+
+sk_sp<SkPersistentGlyphCache> SkPersistentGlyphCache::MakeFromFile(const char path[]) {
+    return Make(SkData::MakeFromFileName(path));
+}
+
+SkPersistentGlyphCache::SkPersistentGlyphCache(sk_sp<SkData> data) : fData(std::move(data)) {}
+
+SkPersistentGlyphCache::~SkPersistentGlyphCache() {}
+
+// Checks that the descriptor is well formed and fills exactly size bytes.
+static bool valid_key(const SkDescriptor* desc, size_t size) {
+    if (size < sizeof(SkDescriptor) || desc->getLength() != size) {
+        return false;
+    }
+    const char* base = reinterpret_cast<const char*>(desc);
+    size_t offset = sizeof(SkDescriptor);
+    while (offset < size) {
+        if (size - offset < sizeof(SkDescriptor::Entry)) {
+            return false;
+        }
+        const auto* entry = reinterpret_cast<const SkDescriptor::Entry*>(base + offset);
+        offset += sizeof(SkDescriptor::Entry);
+        if (entry->fLen > size - offset || !SkIsAlign4(entry->fLen)) {
+            return false;
+        }
+        offset += entry->fLen;
+    }
+    if (!desc->isValid()) {
+        return false;
+    }
+
+    SkAutoDescriptor copy(*desc);
+    copy.getDesc()->computeChecksum();
+    return copy.getDesc()->getChecksum() == desc->getChecksum();
+}
+
+bool SkPersistentGlyphCache::parse() {
+    if (!fData) {
+        return true;
+    }
+    const uint8_t* base = fData->bytes();
+    if (!SkIsAlign4(reinterpret_cast<uintptr_t>(base))) {
+        return false;
+    }
+    Reader reader(base, fData->size());
+
+    const auto* header = static_cast<const FileHeader*>(reader.read(sizeof(FileHeader)));
+    if (!header || header->fMagic != kMagic || header->fVersion != kVersion) {
+        return false;
+    }
+
+    SkAutoMutexAcquire lock(fMutex);
+    for (uint32_t i = 0; i < header->fStrikeCount; ++i) {
+        const auto* strikeHeader =
+                static_cast<const StrikeHeader*>(reader.read(sizeof(StrikeHeader)));
+        if (!strikeHeader) {
+            return false;
+        }
+        const auto* key = static_cast<const SkDescriptor*>(reader.read(strikeHeader->fKeySize));
+        if (!key || !valid_key(key, strikeHeader->fKeySize)) {
+            return false;
+        }
+        const uint32_t glyphCount = strikeHeader->fGlyphCount;
+        if (glyphCount > fData->size() / sizeof(Record)) {
+            return false;
+        }
+        const auto* records = static_cast<const Record*>(reader.read(glyphCount * sizeof(Record)));
+        const size_t blobStart = reader.offset();
+        if (!records || !reader.read(strikeHeader->fBlobSize)) {
+            return false;
+        }
+        const size_t blobEnd = reader.offset();
+
+        auto inBlobs = [&](uint32_t offset, uint32_t size) {
+            return SkIsAlign4(offset) && offset >= blobStart && offset <= blobEnd &&
+                   size <= blobEnd - offset;
+        };
+        for (uint32_t g = 0; g < glyphCount; ++g) {
+            const Record& rec = records[g];
+            if (g > 0 && rec.fPackedID <= records[g - 1].fPackedID) {
+                return false;
+            }
+            if ((rec.fFlags & Record::kMetrics_Flag) && !valid_metrics(rec)) {
+                return false;
+            }
+            if (rec.fFlags & Record::kImage_Flag) {
+                if (!(rec.fFlags & Record::kMetrics_Flag) ||
+                    rec.fImageSize != image_size(rec) ||
+                    !inBlobs(rec.fImageOffset, rec.fImageSize)) {
+                    return false;
+                }
+            }
+            if ((rec.fFlags & Record::kPath_Flag) && !inBlobs(rec.fPathOffset, rec.fPathSize)) {
+                return false;
+            }
+        }
+
+        if (this->findStrike(*key)) {
+            continue;   // Keep the first copy of a duplicated strike.
+        }
+        Strike* strike = this->addStrike(*key);
+        strike->fRecords = records;
+        strike->fRecordCount = SkToInt(glyphCount);
+        strike->fBase = base;
+        if (strikeHeader->fHasFontMetrics) {
+            strike->fFontMetrics = strikeHeader->fFontMetrics;
+            strike->fHasFontMetrics = true;
+        }
+    }
+    return reader.eof();
+}
+
+auto SkPersistentGlyphCache::findStrike(const SkDescriptor& key) const -> Strike* {
+    Strike* const* head = fStrikesByChecksum.find(key.getChecksum());
+    for (Strike* strike = head ? *head : nullptr; strike; strike = strike->fNext) {
+        if (*strike->fKey.getDesc() == key) {
+            return strike;
+        }
+    }
+    return nullptr;
+}
+
+auto SkPersistentGlyphCache::addStrike(const SkDescriptor& key) -> Strike* {
+    std::unique_ptr<Strike> strike(new Strike(key, this));
+    Strike* const* head = fStrikesByChecksum.find(key.getChecksum());
+    strike->fNext = head ? *head : nullptr;
+    fStrikesByChecksum.set(key.getChecksum(), strike.get());
+    fStrikes.push_back(std::move(strike));
+    return fStrikes.back().get();
+}
+
+uint32_t SkPersistentGlyphCache::typefaceKey(const SkTypeface& typeface) {
+    if (uint32_t* key = fTypefaceKeys.find(typeface.uniqueID())) {
+        return *key;
+    }
+
+    // The names and style identify the font, and the 'head' table its version.
+    uint32_t key = 0;
+    if (sk_sp<SkData> desc = typeface.serialize(SkTypeface::SerializeBehavior::kDontIncludeData)) {
+        key = SkOpts::hash(desc->data(), desc->size());
+    }
+    const SkFontTableTag headTag = SkSetFourByteTag('h', 'e', 'a', 'd');
+    if (size_t size = typeface.getTableSize(headTag)) {
+        SkAutoMalloc head(size);
+        if (typeface.getTableData(headTag, 0, size, head.get()) == size) {
+            key = SkOpts::hash(head.get(), size, key);
+        }
+    }
+    fTypefaceKeys.set(typeface.uniqueID(), key);
+    return key;
+}
+
+auto SkPersistentGlyphCache::findOrCreateStrike(const SkDescriptor& desc,
+                                                const SkTypeface& typeface) -> Strike* {
+    SkAutoDescriptor key(desc);
+    uint32_t recSize;
+    auto* rec = (SkScalerContextRec*)key.getDesc()->findEntry(kRec_SkDescriptorTag, &recSize);
+    if (!rec || recSize != sizeof(SkScalerContextRec)) {
+        return nullptr;
+    }
+
+    SkAutoMutexAcquire lock(fMutex);
+    rec->fFontID = this->typefaceKey(typeface);
+    key.getDesc()->computeChecksum();
+
+    if (Strike* strike = this->findStrike(*key.getDesc())) {
+        return strike;
+    }
+    return this->addStrike(*key.getDesc());
+}
+
+int SkPersistentGlyphCache::countStrikes() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return SkToInt(fStrikes.size());
+}
+
+size_t SkPersistentGlyphCache::getAddedByteLimit() const {
+    return fAddedByteLimit.load(std::memory_order_relaxed);
+}
+
+size_t SkPersistentGlyphCache::setAddedByteLimit(size_t bytes) {
+    return fAddedByteLimit.exchange(bytes, std::memory_order_relaxed);
+}
+
+size_t SkPersistentGlyphCache::getAddedBytesUsed() const {
+    return fAddedBytesUsed.load(std::memory_order_relaxed);
+}
+
+bool SkPersistentGlyphCache::reserveAddedBytes(size_t bytes) {
+    const size_t limit = fAddedByteLimit.load(std::memory_order_relaxed);
+    size_t used = fAddedBytesUsed.load(std::memory_order_relaxed);
+    do {
+        if (used > limit || bytes > limit - used) {
+            return false;
+        }
+    } while (!fAddedBytesUsed.compare_exchange_weak(used, used + bytes,
+                                                    std::memory_order_relaxed));
+    return true;
+}
+
+namespace {
+
+struct OutGlyph {
+    Record      fRecord;
+    const void* fImage;
+    const void* fPath;
+};
+
+class Writer {
+public:
+    explicit Writer(SkWStream* stream) : fStream(stream), fOffset(0), fOk(true) {}
+
+    void write(const void* data, size_t size) {
+        fOk = fOk && fStream->write(data, size);
+        fOffset += size;
+    }
+
+    void writePadded(const void* data, size_t size) {
+        static const uint32_t kZero = 0;
+        this->write(data, size);
+        this->write(&kZero, SkAlign4(size) - size);
+    }
+
+    size_t offset() const { return fOffset; }
+    bool ok() const { return fOk && SkTFitsIn<uint32_t>(fOffset); }
+
+private:
+    SkWStream* fStream;
+    size_t     fOffset;
+    bool       fOk;
+};
+
+}  // namespace
+
+bool SkPersistentGlyphCache::write(SkWStream* stream) const {
+    SkAutoMutexAcquire lock(fMutex);
+
+    Writer writer(stream);
+    const FileHeader header = { kMagic, kVersion, SkToU32(fStrikes.size()), 0 };
+    writer.write(&header, sizeof(header));
+
+    for (const auto& strike : fStrikes) {
+        StrikeHeader strikeHeader;
+        memset(&strikeHeader, 0, sizeof(strikeHeader));
+        std::vector<OutGlyph> glyphs;
+        {
+            SkAutoExclusive strikeLock(strike->fLock);
+            for (int i = 0; i < strike->fRecordCount; ++i) {
+                const Record& rec = strike->fRecords[i];
+                const uint8_t* base = strike->fBase;
+                glyphs.push_back({rec,
+                                  rec.fFlags & Record::kImage_Flag ? base + rec.fImageOffset
+                                                                   : nullptr,
+                                  rec.fFlags & Record::kPath_Flag ? base + rec.fPathOffset
+                                                                  : nullptr});
+            }
+            const auto& addedGlyphs = strike->fAdded;
+            addedGlyphs.foreach([&](uint32_t id, const Strike::AddedGlyph& added) {
+                const Record* rec = strike->findRecord(id);
+                OutGlyph* out = nullptr;
+                if (rec) {
+                    out = &glyphs[rec - strike->fRecords];
+                } else {
+                    glyphs.push_back({added.fRecord, nullptr, nullptr});
+                    out = &glyphs.back();
+                    out->fRecord.fFlags = 0;
+                }
+                // Take whatever was learned since the file was read.
+                // Only the metrics, since a record read from the file may have a path.
+                if (added.fRecord.fFlags & Record::kMetrics_Flag) {
+                    copy_metrics(added.fRecord, &out->fRecord);
+                }
+                if (added.fImage && !(out->fRecord.fFlags & Record::kImage_Flag)) {
+                    out->fImage = added.fImage->data();
+                    out->fRecord.fImageSize = SkToU32(added.fImage->size());
+                    out->fRecord.fFlags |= Record::kImage_Flag;
+                }
+                if ((added.fRecord.fFlags & Record::kPath_Flag) &&
+                    !(out->fRecord.fFlags & Record::kPath_Flag)) {
+                    out->fPath = added.fPath ? added.fPath->data() : nullptr;
+                    out->fRecord.fPathSize = added.fPath ? SkToU32(added.fPath->size()) : 0;
+                    out->fRecord.fFlags |= Record::kPath_Flag;
+                }
+            });
+            strikeHeader.fHasFontMetrics = strike->fHasFontMetrics;
+            if (strike->fHasFontMetrics) {
+                strikeHeader.fFontMetrics = strike->fFontMetrics;
+            }
+
+            std::sort(glyphs.begin(), glyphs.end(), [](const OutGlyph& a, const OutGlyph& b) {
+                return a.fRecord.fPackedID < b.fRecord.fPackedID;
+            });
+
+            const SkDescriptor* key = strike->fKey.getDesc();
+            strikeHeader.fKeySize = key->getLength();
+            strikeHeader.fGlyphCount = SkToU32(glyphs.size());
+
+            // Lay out the blobs after the records.
+            size_t blobOffset = writer.offset() + sizeof(StrikeHeader) + key->getLength()
+                              + glyphs.size() * sizeof(Record);
+            const size_t blobStart = blobOffset;
+            for (OutGlyph& glyph : glyphs) {
+                Record& rec = glyph.fRecord;
+                if (rec.fFlags & Record::kImage_Flag) {
+                    rec.fImageOffset = SkToU32(blobOffset);
+                    blobOffset += SkAlign4(rec.fImageSize);
+                }
+                if (rec.fFlags & Record::kPath_Flag) {
+                    rec.fPathOffset = SkToU32(blobOffset);
+                    blobOffset += SkAlign4(rec.fPathSize);
+                }
+            }
+            if (!SkTFitsIn<uint32_t>(blobOffset)) {
+                return false;
+            }
+            strikeHeader.fBlobSize = SkToU32(blobOffset - blobStart);
+
+            writer.write(&strikeHeader, sizeof(strikeHeader));
+            writer.write(key, key->getLength());
+            for (const OutGlyph& glyph : glyphs) {
+                writer.write(&glyph.fRecord, sizeof(Record));
+            }
+            for (const OutGlyph& glyph : glyphs) {
+                const Record& rec = glyph.fRecord;
+                if (rec.fFlags & Record::kImage_Flag) {
+                    writer.writePadded(glyph.fImage, rec.fImageSize);
+                }
+                if (rec.fFlags & Record::kPath_Flag) {
+                    writer.writePadded(glyph.fPath, rec.fPathSize);
+                }
+            }
+        }
+        if (!writer.ok()) {
+            return false;
+        }
+    }
+    return writer.ok();
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPersistentGlyphCache_DEFINED
+#define SkPersistentGlyphCache_DEFINED
+
+#include "SkData.h"
+#include "SkDescriptor.h"
+#include "SkFontMetrics.h"
+#include "SkGlyph.h"
+#include "SkMutex.h"
+#include "SkRefCnt.h"
+#include "SkSpinlock.h"
+#include "SkTHash.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class SkPath;
+class SkTypeface;
+class SkWStream;
+
+#ifndef SK_DEFAULT_PERSISTENT_GLYPH_CACHE_LIMIT
+    #define SK_DEFAULT_PERSISTENT_GLYPH_CACHE_LIMIT (8 * 1024 * 1024)
+#endif
+
+/**
+ *  A cache of scaler context output (font metrics, glyph metrics, images and paths) that outlives
+ *  the process. SkStrikeCache consults it before asking a scaler context for anything, and adds
+ *  to it whatever the scaler contexts produce, so that a later run can skip rasterizing glyphs
+ *  it has already seen.
+ *
+ *  Strikes are keyed by their SkDescriptor, with the typeface's process-local ID replaced by a
+ *  hash of the typeface's names, style and 'head' table. The file is laid out so that it can be
+ *  mapped and used in place: glyph records are searched where they lie, and strikes copy glyph
+ *  images and paths straight out of the mapping without any parsing step.
+ *
+ *  What is added after the file is read is kept in memory until the next write(), up to a byte
+ *  limit; past that, new glyphs are still rasterized but no longer recorded.
+ *
+ *  The cache does not check that the fonts or the rasterizer are the same as when the file was
+ *  written beyond that hash; a client updating either should start from an empty cache.
+ */
+class SkPersistentGlyphCache : public SkRefCnt {
+public:
+    /**
+     *  Reads a cache written by write(). The data is used in place, so it is usually from
+     *  SkData::MakeFromFileName(). If data is null or not a valid cache, returns an empty cache.
+     */
+    static sk_sp<SkPersistentGlyphCache> Make(sk_sp<SkData> data);
+
+    // Equivalent to Make(SkData::MakeFromFileName(path)).
+    static sk_sp<SkPersistentGlyphCache> MakeFromFile(const char path[]);
+
+    class Strike;
+
+    /**
+     *  Returns the entry for the strike described by desc, creating an empty one if needed. The
+     *  entry lives as long as this cache. Thread safe.
+     */
+    Strike* findOrCreateStrike(const SkDescriptor& desc, const SkTypeface& typeface);
+
+    /**
+     *  Writes every strike, both those read and those added, as a new cache. Thread safe. This
+     *  should not overwrite the file this cache was read from while that file is still mapped.
+     */
+    bool write(SkWStream*) const;
+
+    int countStrikes() const;
+
+    /**
+     *  The most memory, in bytes, used to record glyphs added since the file was read. Defaults
+     *  to SK_DEFAULT_PERSISTENT_GLYPH_CACHE_LIMIT. Lowering it does not drop what is recorded.
+     *  The setter returns the previous limit.
+     */
+    size_t getAddedByteLimit() const;
+    size_t setAddedByteLimit(size_t bytes);
+    size_t getAddedBytesUsed() const;
+
+    // All of a Strike's methods are thread safe.
+    class Strike {
+    public:
+        bool findFontMetrics(SkFontMetrics*) const;
+        void addFontMetrics(const SkFontMetrics&);
+
+        // Fills in all the metrics of glyph, found by its packed ID.
+        bool findMetrics(SkGlyph* glyph) const;
+        void addMetrics(const SkGlyph&);
+
+        // Returns the image of a glyph with the same ID and metrics as glyph, or null. The
+        // returned memory may be read-only.
+        const void* findImage(const SkGlyph& glyph) const;
+        void addImage(const SkGlyph&);
+
+        // Returns false if the path of the glyph is unknown. Otherwise sets hasPath, and if it is
+        // true, path.
+        bool findPath(SkPackedGlyphID, SkPath* path, bool* hasPath) const;
+        void addPath(SkPackedGlyphID, const SkPath* pathOrNull);
+
+        int countGlyphs() const;
+
+        // How a glyph is stored in the file. Only public for the reader and writer.
+        struct Record {
+            enum Flags : uint8_t {
+                kMetrics_Flag = 1 << 0,
+                kImage_Flag   = 1 << 1,    // fImageOffset and fImageSize are valid.
+                kPath_Flag    = 1 << 2,    // The path is known; fPathSize is 0 if there is none.
+            };
+
+            uint32_t fPackedID;
+            float    fAdvanceX, fAdvanceY;
+            uint16_t fWidth, fHeight;
+            int16_t  fTop, fLeft;
+            int8_t   fForceBW;
+            uint8_t  fMaskFormat;
+            uint8_t  fFlags;
+            uint8_t  fUnused;
+            uint32_t fImageOffset, fImageSize;
+            uint32_t fPathOffset,  fPathSize;
+        };
+
+    private:
+        friend class SkPersistentGlyphCache;
+
+        // A glyph added since the file was read. Offsets in fRecord are not used.
+        struct AddedGlyph {
+            Record        fRecord;
+            sk_sp<SkData> fImage;
+            sk_sp<SkData> fPath;
+        };
+
+        Strike(const SkDescriptor& key, SkPersistentGlyphCache* owner);
+
+        // Searches the records read from the file.
+        const Record* findRecord(uint32_t packedID) const;
+        // Returns null if a new glyph would go over the owner's byte limit.
+        AddedGlyph* findOrAddGlyph(SkPackedGlyphID);
+
+        const SkAutoDescriptor fKey;
+        SkPersistentGlyphCache* const fOwner;
+        Strike*                fNext = nullptr;    // Next strike with the same checksum.
+
+        // Read from the file, sorted by packed ID, and never changed.
+        const Record*          fRecords = nullptr;
+        int                    fRecordCount = 0;
+        const uint8_t*         fBase = nullptr;    // Record offsets are relative to this.
+
+        mutable SkSpinlock     fLock;              // Guards everything below.
+        bool                   fHasFontMetrics = false;
+        SkFontMetrics          fFontMetrics;
+        SkTHashMap<uint32_t, AddedGlyph> fAdded;
+    };
+
+    ~SkPersistentGlyphCache() override;
+
+private:
+    explicit SkPersistentGlyphCache(sk_sp<SkData> data);
+
+    // Returns false, leaving the cache partially read, if fData is not a valid cache.
+    bool parse();
+
+    // Must be called with fMutex held.
+    Strike* findStrike(const SkDescriptor& key) const;
+    Strike* addStrike(const SkDescriptor& key);
+
+    uint32_t typefaceKey(const SkTypeface&);
+
+    // Counts bytes against the added byte limit, or returns false if they don't fit.
+    bool reserveAddedBytes(size_t bytes);
+
+    sk_sp<SkData>                        fData;
+    std::atomic<size_t>                  fAddedByteLimit{SK_DEFAULT_PERSISTENT_GLYPH_CACHE_LIMIT};
+    std::atomic<size_t>                  fAddedBytesUsed{0};
+
+    mutable SkMutex                      fMutex;    // Guards everything below.
+    std::vector<std::unique_ptr<Strike>> fStrikes;
+    SkTHashMap<uint32_t, Strike*>        fStrikesByChecksum;
+    SkTHashMap<uint32_t, uint32_t>       fTypefaceKeys;    // Unique ID -> stable key.
+};
+
+#endif  // SkPersistentGlyphCache_DEFINED
@@ -93,6 +93,16 @@ static void write_tag_size(SkWStream* stream, uint32_t tag, size_t size) {
     stream->write32(SkToU32(size));
 }
 
+void SkPictureData::WriteAlignment(SkWStream* stream) {
+    // The tag and size are 8 bytes, so they don't change the alignment of what follows.
+    size_t padding = (0 - stream->bytesWritten()) & 3;
+    if (padding) {
+        write_tag_size(stream, SK_PICT_ALIGN_TAG, padding);
+        const uint8_t zeros[3] = { 0, 0, 0 };
+        stream->write(zeros, padding);
+    }
+}
+
 void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     int count = rec.count();
 
@@ -199,6 +209,8 @@ static SkSerialProcs skip_typeface_proc(const SkSerialProcs& procs) {
 void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
                               SkRefCntSet* topLevelTypeFaceSet) const {
     // This can happen at pretty much any time, so might as well do it first.
+    // The op data and the buffer are aligned so that a reader may use them in place.
+    WriteAlignment(stream);
     write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
     stream->write(fOpData->bytes(), fOpData->size());
 
@@ -238,6 +250,7 @@ void SkPictureData::serialize(SkWStream* stream, const SkSerialProcs& procs,
     }
 
     // Write the buffer.
+    WriteAlignment(stream);
     write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
     buffer.writeToStream(stream);
 
@@ -277,15 +290,45 @@ void SkPictureData::flatten(SkWriteBuffer& buffer) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+const void* SkPictureData::peekMapped(SkStream* stream, size_t size) const {
+    // Only pictures written with alignment padding can have their sections read in place.
+    if (fInfo.getVersion() < SkReadBuffer::kAlignedPictureData_Version) {
+        return nullptr;
+    }
+    if (!fMapping || !stream->hasPosition() || stream->getMemoryBase() != fMapping->data()) {
+        return nullptr;
+    }
+    size_t offset = stream->getPosition();
+    if (offset > fMapping->size() || size > fMapping->size() - offset) {
+        return nullptr;
+    }
+    const uint8_t* ptr = fMapping->bytes() + offset;
+    return SkIsAlign4((uintptr_t)ptr) ? ptr : nullptr;
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
                                    const SkDeserialProcs& procs,
                                    SkTypefacePlayback* topLevelTFPlayback) {
     switch (tag) {
+        case SK_PICT_ALIGN_TAG:
+            if (fInfo.getVersion() < SkReadBuffer::kAlignedPictureData_Version ||
+                size > 3 || stream->skip(size) != size) {
+                return false;
+            }
+            break;
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            if (const void* ops = this->peekMapped(stream, size)) {
+                fOpData = SkData::MakeSubset(fMapping.get(),
+                                             (const uint8_t*)ops - fMapping->bytes(), size);
+                if (stream->skip(size) != size) {
+                    return false;
+                }
+            } else {
+                fOpData = SkData::MakeFromStream(stream, size);
+            }
             if (!fOpData) {
                 return false;
             }
@@ -321,7 +364,8 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             fPictures.reserve(SkToInt(size));
 
             for (uint32_t i = 0; i < size; i++) {
-                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback);
+                auto pic = SkPicture::MakeFromStream(stream, &procs, topLevelTFPlayback,
+                                                     fMapping.get());
                 if (!pic) {
                     return false;
                 }
@@ -329,13 +373,26 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
-                return false;
+            SkAutoMalloc storage;
+            const void* bytes = this->peekMapped(stream, size);
+            if (bytes) {
+                if (stream->skip(size) != size) {
+                    return false;
+                }
+            } else {
+                storage.reset(size);
+                if (stream->read(storage.get(), size) != size) {
+                    return false;
+                }
+                bytes = storage.get();
             }
 
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(bytes, size);
             buffer.setVersion(fInfo.getVersion());
+            if (bytes != storage.get()) {
+                // Let images reference their encoded bytes rather than copy them.
+                buffer.setBackingData(fMapping);
+            }
 
             if (!fFactoryPlayback) {
                 return false;
@@ -467,15 +524,21 @@ void SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                const SkDeserialProcs& procs,
-                                               SkTypefacePlayback* topLevelTFPlayback) {
+                                               SkTypefacePlayback* topLevelTFPlayback,
+                                               const SkData* mapping) {
     std::unique_ptr<SkPictureData> data(new SkPictureData(info));
     if (!topLevelTFPlayback) {
         topLevelTFPlayback = &data->fTFPlayback;
     }
+    data->fMapping = sk_ref_sp(mapping);
 
     if (!data->parseStream(stream, procs, topLevelTFPlayback)) {
         return nullptr;
     }
+    if (mapping) {
+        // We'll be played back directly, possibly from several threads at once.
+        data->initForPlayback();
+    }
     return data.release();
 }
 
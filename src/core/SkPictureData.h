@@ -65,6 +65,9 @@ public:
 #define SK_PICT_VERTICES_BUFFER_TAG SkSetFourByteTag('v', 'e', 'r', 't')
 #define SK_PICT_IMAGE_BUFFER_TAG    SkSetFourByteTag('i', 'm', 'a', 'g')
 
+// Zero to three bytes of padding, so that the next tag's payload is 4-byte aligned in the stream.
+#define SK_PICT_ALIGN_TAG   SkSetFourByteTag('a', 'l', 'g', 'n')
+
 // Always write this guy last (with no length field afterwards)
 #define SK_PICT_EOF_TAG     SkSetFourByteTag('e', 'o', 'f', ' ')
 
@@ -78,10 +81,13 @@ class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&);
     // Does not affect ownership of SkStream.
+    // If mapping is not null, it holds the bytes behind the stream, and aligned sections are
+    // referenced from it rather than copied.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            const SkDeserialProcs&,
-                                           SkTypefacePlayback*);
+                                           SkTypefacePlayback*,
+                                           const SkData* mapping = nullptr);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
 
     void serialize(SkWStream*, const SkSerialProcs&, SkRefCntSet*) const;
@@ -142,10 +148,15 @@ private:
     void parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
     void flattenToBuffer(SkWriteBuffer&) const;
 
+    // Returns the next size bytes of stream in place, or null if they are not in fMapping or
+    // are not 4-byte aligned.
+    const void* peekMapped(SkStream*, size_t size) const;
+
     SkTArray<SkPaint>  fPaints;
     SkTArray<SkPath>   fPaths;
 
     sk_sp<SkData>   fOpData;    // opcodes and parameters
+    sk_sp<SkData>   fMapping;   // the serialized picture, if we're reading it in place
 
     const SkPath    fEmptyPath;
     const SkBitmap  fEmptyBitmap;
@@ -161,6 +172,7 @@ private:
 
     const SkPictInfo fInfo;
 
+    static void WriteAlignment(SkWStream* stream);
     static void WriteFactories(SkWStream* stream, const SkFactorySet& rec);
     static void WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec, const SkSerialProcs&);
 
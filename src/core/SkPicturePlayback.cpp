@@ -59,6 +59,24 @@ DrawType SkPicturePlayback::ReadOpAndSize(SkReadBuffer* reader, uint32_t* size)
 }
 
 
+int SkPicturePlayback::CountOps(const SkPictureData* data) {
+    SkReadBuffer reader(data->opData()->bytes(), data->opData()->size());
+
+    int count = 0;
+    while (!reader.eof() && reader.isValid()) {
+        const size_t start = reader.offset();
+        uint32_t size;
+        (void)ReadOpAndSize(&reader, &size);
+        const size_t headerSize = reader.offset() - start;
+        if (!reader.validate(size >= headerSize)) {
+            break;
+        }
+        reader.skip(size - headerSize);
+        count++;
+    }
+    return count;
+}
+
 static const SkRect* get_rect_ptr(SkReadBuffer* reader, SkRect* storage) {
     if (reader->readBool()) {
         reader->readRect(storage);
@@ -319,3 +319,65 @@ std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile()
         start_pipeline(x,y,x+w,y+h, program);
     };
 }
+
+bool SkRasterPipeline::getStages(StockStage stages[], void* ctxs[]) const {
+    int i = fNumStages;
+    for (const StageList* st = fStages; st; st = st->prev) {
+        if (st->rawFunction) {
+            return false;
+        }
+        --i;
+        stages[i] = (StockStage)st->stage;
+        ctxs  [i] = st->ctx;
+    }
+    SkASSERT(i == 0);
+    return true;
+}
+
+bool SkRasterPipeline::compileProgram(void* const ctxs[], int count, Program* program) const {
+    SkAutoSTMalloc<32, StockStage> stages(fNumStages);
+    SkAutoSTMalloc<32, void*>      stageCtxs(fNumStages);
+    if (!this->getStages(stages.get(), stageCtxs.get())) {
+        return false;
+    }
+
+    program->fSlotsNeeded = fSlotsNeeded;
+    program->fProgram.reset(fSlotsNeeded);
+    program->fHoles.reset();
+    program->fStartPipeline = this->build_pipeline(program->fProgram.get() + fSlotsNeeded);
+
+    // Lowp and highp programs share a layout: each stage's function, then its context if any.
+    int slot = 0;
+    for (int i = 0; i < fNumStages; i++) {
+        slot++;
+        if (void* ctx = stageCtxs[i]) {
+            SkASSERT(program->fProgram[slot] == ctx);
+            int index = 0;
+            while (index < count && ctxs[index] != ctx) {
+                index++;
+            }
+            if (index == count) {
+                return false;
+            }
+            program->fProgram[slot] = nullptr;
+            program->fHoles.push_back({slot, index});
+            slot++;
+        }
+    }
+    SkASSERT(slot == fSlotsNeeded - 1);  // Just the final just_return() left.
+    return true;
+}
+
+std::function<void(size_t, size_t, size_t, size_t)>
+SkRasterPipeline::Program::instantiate(SkArenaAlloc* alloc, void* const ctxs[]) const {
+    void** program = alloc->makeArrayDefault<void*>(fSlotsNeeded);
+    memcpy(program, fProgram.get(), fSlotsNeeded * sizeof(void*));
+    for (const Hole& hole : fHoles) {
+        program[hole.fSlot] = ctxs[hole.fContext];
+    }
+
+    auto start_pipeline = fStartPipeline;
+    return [=](size_t x, size_t y, size_t w, size_t h) {
+        start_pipeline(x,y,x+w,y+h, program);
+    };
+}
@@ -12,7 +12,8 @@
 #include "SkColor.h"
 #include "SkImageInfo.h"
 #include "SkNx.h"
-#include "SkTArray.h" // TODO: unused
+#include "SkTArray.h"
+#include "SkTemplates.h"
 #include "SkTypes.h"
 #include <functional>
 #include <vector>  // TODO: unused
@@ -33,7 +34,7 @@
  */
 
 #define SK_RASTER_PIPELINE_STAGES(M)                               \
-    M(callback)                                                    \
+    M(callback) M(interpreter)                                     \
     M(move_src_dst) M(move_dst_src)                                \
     M(clamp_0) M(clamp_1) M(clamp_a) M(clamp_gamut)                \
     M(unpremul) M(premul) M(premul_dst)                            \
@@ -142,6 +143,15 @@ struct SkRasterPipeline_CallbackCtx {
     float* read_from = rgba;
 };
 
+struct SkRasterPipeline_InterpreterCtx {
+    void (*fn)(SkRasterPipeline_InterpreterCtx* self, int active_pixels/*<= SkRasterPipeline_kMaxStride*/);
+
+    // Like SkRasterPipeline_CallbackCtx, but our active pixels are stored planar: all of the
+    // r values, then all of g, b and a, each channel SkRasterPipeline_kMaxStride floats apart.
+    // When fn() returns, the pipeline reads them back from the same place.
+    float rgba[4*SkRasterPipeline_kMaxStride];
+};
+
 struct SkRasterPipeline_GradientCtx {
     size_t stopCount;
     float* fs[4];
@@ -206,6 +216,21 @@ public:
     // Allocates a thunk which amortizes run() setup cost in alloc.
     std::function<void(size_t, size_t, size_t, size_t)> compile() const;
 
+    // A compiled program with holes where its contexts go, reusable by any pipeline with the
+    // same stages but different contexts.  See compileProgram().
+    class Program;
+
+    // Compiles this pipeline into program.  Each stage's context must be one of ctxs[0..count);
+    // its hole remembers which, to be filled from the same index by Program::instantiate().
+    // Returns false if some stage is a raw function or has a context not found in ctxs.
+    bool compileProgram(void* const ctxs[], int count, Program* program) const;
+
+    // Writes each stage and its context (or nullptr) into stages[] and ctxs[], which must each
+    // have room for numStages() entries, in the order the stages run.  Returns false if some
+    // stage is a raw function.
+    bool getStages(StockStage stages[], void* ctxs[]) const;
+    int numStages() const { return fNumStages; }
+
     void dump() const;
 
     // Appends a stage for the specified matrix.
@@ -256,6 +281,26 @@ private:
     int           fSlotsNeeded;
 };
 
+class SkRasterPipeline::Program {
+public:
+    // Allocates a thunk in alloc like compile(), with each hole filled in from ctxs.
+    std::function<void(size_t, size_t, size_t, size_t)> instantiate(SkArenaAlloc* alloc,
+                                                                     void* const ctxs[]) const;
+
+private:
+    friend class SkRasterPipeline;
+
+    struct Hole {
+        int fSlot;      // Index into fProgram.
+        int fContext;   // Index into the ctxs passed to instantiate().
+    };
+
+    StartPipelineFn      fStartPipeline = nullptr;
+    int                  fSlotsNeeded   = 0;
+    SkAutoTMalloc<void*> fProgram;   // Stage functions, with nullptr in each hole.
+    SkTArray<Hole, true> fHoles;
+};
+
 template <size_t bytes>
 class SkRasterPipeline_ : public SkRasterPipeline {
 public:
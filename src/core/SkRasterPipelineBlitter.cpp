@@ -12,11 +12,14 @@
 #include "SkColorFilter.h"
 #include "SkColorSpacePriv.h"
 #include "SkColorSpaceXformSteps.h"
+#include "SkLRUCache.h"
+#include "SkMutex.h"
 #include "SkOpts.h"
 #include "SkPaint.h"
 #include "SkRasterPipeline.h"
 #include "SkShader.h"
 #include "SkShaderBase.h"
+#include "SkSpinlock.h"
 #include "SkTo.h"
 #include "SkUtils.h"
 
@@ -25,15 +28,17 @@ public:
     // This is our common entrypoint for creating the blitter once we've sorted out shaders.
     static SkBlitter* Create(const SkPixmap&, const SkPaint&, SkArenaAlloc*,
                              const SkRasterPipeline& shaderPipeline,
-                             bool is_opaque, bool is_constant);
+                             bool is_opaque, bool is_constant, bool useProgramCache = true);
 
     SkRasterPipelineBlitter(SkPixmap dst,
                             SkBlendMode blend,
-                            SkArenaAlloc* alloc)
+                            SkArenaAlloc* alloc,
+                            bool useProgramCache)
         : fDst(dst)
         , fBlend(blend)
         , fAlloc(alloc)
         , fColorPipeline(alloc)
+        , fUseProgramCache(useProgramCache)
     {}
 
     void blitH     (int x, int y, int w)                            override;
@@ -45,13 +50,23 @@ public:
     void blitV     (int x, int y, int height, SkAlpha alpha)        override;
 
 private:
+    enum class Blit { kRect, kAntiH, kMaskA8, kMaskLCD16, kMask3D };
+
     void append_load_dst      (SkRasterPipeline*) const;
     void append_store         (SkRasterPipeline*) const;
 
+    // Appends everything a blit pipeline needs after fColorPipeline.
+    void append_blit          (Blit, SkRasterPipeline*) const;
+
+    // Builds a blit pipeline, reusing the program compiled for any earlier blitter with the
+    // same stages.  Only the contexts (paint colors, shader matrices, etc.) differ between them.
+    std::function<void(size_t, size_t, size_t, size_t)> compile_blit(Blit);
+
     SkPixmap               fDst;
     SkBlendMode            fBlend;
     SkArenaAlloc*          fAlloc;
     SkRasterPipeline       fColorPipeline;
+    bool                   fUseProgramCache;
 
     SkRasterPipeline_MemoryCtx
         fDstPtr       = {nullptr,0},  // Always points to the top-left of fDst.
@@ -80,7 +95,8 @@ private:
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
                                          const SkPaint& paint,
                                          const SkMatrix& ctm,
-                                         SkArenaAlloc* alloc) {
+                                         SkArenaAlloc* alloc,
+                                         bool useProgramCache) {
     // For legacy to keep working, we need to sometimes still distinguish null dstCS from sRGB.
 #if 0
     SkColorSpace* dstCS = dst.colorSpace() ? dst.colorSpace()
@@ -101,8 +117,8 @@ SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
         shaderPipeline.append_constant_color(alloc, paintColor.premul().vec());
         bool is_opaque    = paintColor.fA == 1.0f,
              is_constant  = true;
-        return SkRasterPipelineBlitter::Create(dst, paint, alloc,
-                                               shaderPipeline, is_opaque, is_constant);
+        return SkRasterPipelineBlitter::Create(dst, paint, alloc, shaderPipeline,
+                                               is_opaque, is_constant, useProgramCache);
     }
 
     bool is_opaque    = shader->isOpaque() && paintColor.fA == 1.0f;
@@ -113,8 +129,8 @@ SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
             shaderPipeline.append(SkRasterPipeline::scale_1_float,
                                   alloc->make<float>(paintColor.fA));
         }
-        return SkRasterPipelineBlitter::Create(dst, paint, alloc,
-                                               shaderPipeline, is_opaque, is_constant);
+        return SkRasterPipelineBlitter::Create(dst, paint, alloc, shaderPipeline,
+                                               is_opaque, is_constant, useProgramCache);
     }
 
     // The shader has opted out of drawing anything.
@@ -136,10 +152,12 @@ SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
                                            SkArenaAlloc* alloc,
                                            const SkRasterPipeline& shaderPipeline,
                                            bool is_opaque,
-                                           bool is_constant) {
+                                           bool is_constant,
+                                           bool useProgramCache) {
     auto blitter = alloc->make<SkRasterPipelineBlitter>(dst,
                                                         paint.getBlendMode(),
-                                                        alloc);
+                                                        alloc,
+                                                        useProgramCache);
 
     // Our job in this factory is to fill out the blitter's color pipeline.
     // This is the common front of the full blit pipelines, each constructed lazily on first use.
@@ -276,6 +294,163 @@ void SkRasterPipelineBlitter::append_store(SkRasterPipeline* p) const {
     p->append_store(fDst.info().colorType(), &fDstPtr);
 }
 
+void SkRasterPipelineBlitter::append_blit(Blit blit, SkRasterPipeline* p) const {
+    switch (blit) {
+        case Blit::kRect:
+            p->append_gamut_clamp_if_normalized(fDst.info());
+            if (fBlend == SkBlendMode::kSrcOver
+                    && (fDst.info().colorType() == kRGBA_8888_SkColorType ||
+                        fDst.info().colorType() == kBGRA_8888_SkColorType)
+                    && !fDst.colorSpace()
+                    && fDst.info().alphaType() != kUnpremul_SkAlphaType
+                    && fDitherRate == 0.0f) {
+                if (fDst.info().colorType() == kBGRA_8888_SkColorType) {
+                    p->append(SkRasterPipeline::swap_rb);
+                }
+                p->append(SkRasterPipeline::srcover_rgba_8888, &fDstPtr);
+                return;
+            }
+            if (fBlend != SkBlendMode::kSrc) {
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+            }
+            break;
+
+        case Blit::kAntiH:
+            p->append_gamut_clamp_if_normalized(fDst.info());
+            if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
+                p->append(SkRasterPipeline::scale_1_float, &fCurrentCoverage);
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+            } else {
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+                p->append(SkRasterPipeline::lerp_1_float, &fCurrentCoverage);
+            }
+            break;
+
+        case Blit::kMask3D:
+            // This bit is where we differ from kA8_Format:
+            p->append(SkRasterPipeline::emboss, &fEmbossCtx);
+            // Now onward just as kA8.  (fallthrough)
+        case Blit::kMaskA8:
+            p->append_gamut_clamp_if_normalized(fDst.info());
+            if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
+                p->append(SkRasterPipeline::scale_u8, &fMaskPtr);
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+            } else {
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+                p->append(SkRasterPipeline::lerp_u8, &fMaskPtr);
+            }
+            break;
+
+        case Blit::kMaskLCD16:
+            p->append_gamut_clamp_if_normalized(fDst.info());
+            if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/true)) {
+                // Somewhat unusually, scale_565 needs dst loaded first.
+                this->append_load_dst(p);
+                p->append(SkRasterPipeline::scale_565, &fMaskPtr);
+                SkBlendMode_AppendStages(fBlend, p);
+            } else {
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+                p->append(SkRasterPipeline::lerp_565, &fMaskPtr);
+            }
+            break;
+    }
+    this->append_store(p);
+}
+
+namespace {
+    // Identifies a blit pipeline by the blitter state that shapes append_blit(), then each stage
+    // of the color pipeline and which hole, if any, holds its context.  Two blitters with equal
+    // keys build pipelines that differ only in their contexts.
+    struct BlitProgramKey {
+        SkSTArray<32, uint32_t, true> fWords;
+
+        bool operator==(const BlitProgramKey& that) const { return fWords == that.fWords; }
+    };
+
+    struct BlitProgramKeyHash {
+        uint32_t operator()(const BlitProgramKey& key) const {
+            return SkOpts::hash(key.fWords.begin(), key.fWords.count() * sizeof(uint32_t));
+        }
+    };
+
+    using BlitProgramCache =
+            SkLRUCache<BlitProgramKey, SkRasterPipeline::Program, BlitProgramKeyHash>;
+
+    // Enough for the handful of paints a typical frame uses, in each of their blit flavors.
+    static constexpr int kBlitProgramCacheCount = 256;
+
+    SkSpinlock gBlitProgramCacheLock;
+
+    BlitProgramCache* blit_program_cache() {
+        static auto* cache = new BlitProgramCache(kBlitProgramCacheCount);
+        return cache;
+    }
+}
+
+std::function<void(size_t, size_t, size_t, size_t)>
+SkRasterPipelineBlitter::compile_blit(Blit blit) {
+    // Every context a blit pipeline can use: our own fields, then the color pipeline's contexts.
+    const int n = fColorPipeline.numStages();
+    SkAutoSTMalloc<32, SkRasterPipeline::StockStage> stages(n);
+    SkAutoSTMalloc<32 + 5, void*> ctxs(n + 5);
+    ctxs[0] = &fDstPtr;
+    ctxs[1] = &fMaskPtr;
+    ctxs[2] = &fEmbossCtx;
+    ctxs[3] = &fCurrentCoverage;
+    ctxs[4] = &fDitherRate;
+    const bool cacheable = fUseProgramCache
+                        && fColorPipeline.getStages(stages.get(), ctxs.get() + 5);
+
+    BlitProgramKey key;
+    if (cacheable) {
+        key.fWords.push_back((uint32_t)blit);
+        key.fWords.push_back((uint32_t)fBlend);
+        key.fWords.push_back((uint32_t)fDst.info().colorType());
+        key.fWords.push_back((uint32_t)fDst.info().alphaType());
+        key.fWords.push_back((fDst.colorSpace() ? 1 : 0) | (fDitherRate > 0.0f ? 2 : 0));
+        for (int i = 0; i < n; i++) {
+            // compileProgram() fills a hole from the first matching context, so stages sharing
+            // a context share a hole.
+            uint32_t hole = 0;
+            if (void* ctx = ctxs[5 + i]) {
+                while (ctxs[hole] != ctx) {
+                    hole++;
+                }
+                hole++;
+            }
+            key.fWords.push_back((uint32_t)stages[i]);
+            key.fWords.push_back(hole);
+        }
+
+        SkAutoExclusive lock(gBlitProgramCacheLock);
+        if (const SkRasterPipeline::Program* program = blit_program_cache()->find(key)) {
+            return program->instantiate(fAlloc, ctxs.get());
+        }
+    }
+
+    SkRasterPipeline p(fAlloc);
+    p.extend(fColorPipeline);
+    this->append_blit(blit, &p);
+
+    SkRasterPipeline::Program program;
+    if (!cacheable || !p.compileProgram(ctxs.get(), n + 5, &program)) {
+        return p.compile();
+    }
+    auto fn = program.instantiate(fAlloc, ctxs.get());
+
+    SkAutoExclusive lock(gBlitProgramCacheLock);
+    if (!blit_program_cache()->find(key)) {  // Another thread may have beaten us here.
+        blit_program_cache()->insert(key, std::move(program));
+    }
+    return fn;
+}
+
 void SkRasterPipelineBlitter::blitH(int x, int y, int w) {
     this->blitRect(x,y,w,1);
 }
@@ -287,27 +462,7 @@ void SkRasterPipelineBlitter::blitRect(int x, int y, int w, int h) {
     }
 
     if (!fBlitRect) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (fBlend == SkBlendMode::kSrcOver
-                && (fDst.info().colorType() == kRGBA_8888_SkColorType ||
-                    fDst.info().colorType() == kBGRA_8888_SkColorType)
-                && !fDst.colorSpace()
-                && fDst.info().alphaType() != kUnpremul_SkAlphaType
-                && fDitherRate == 0.0f) {
-            if (fDst.info().colorType() == kBGRA_8888_SkColorType) {
-                p.append(SkRasterPipeline::swap_rb);
-            }
-            p.append(SkRasterPipeline::srcover_rgba_8888, &fDstPtr);
-        } else {
-            if (fBlend != SkBlendMode::kSrc) {
-                this->append_load_dst(&p);
-                SkBlendMode_AppendStages(fBlend, &p);
-            }
-            this->append_store(&p);
-        }
-        fBlitRect = p.compile();
+        fBlitRect = this->compile_blit(Blit::kRect);
     }
 
     fBlitRect(x,y,w,h);
@@ -315,21 +470,7 @@ void SkRasterPipelineBlitter::blitRect(int x, int y, int w, int h) {
 
 void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) {
     if (!fBlitAntiH) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
-            p.append(SkRasterPipeline::scale_1_float, &fCurrentCoverage);
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-        } else {
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-            p.append(SkRasterPipeline::lerp_1_float, &fCurrentCoverage);
-        }
-
-        this->append_store(&p);
-        fBlitAntiH = p.compile();
+        fBlitAntiH = this->compile_blit(Blit::kAntiH);
     }
 
     for (int16_t run = *runs; run > 0; run = *runs) {
@@ -420,56 +561,13 @@ void SkRasterPipelineBlitter::blitMask(const SkMask& mask, const SkIRect& clip)
 
     // Lazily build whichever pipeline we need, specialized for each mask format.
     if (mask.fFormat == SkMask::kA8_Format && !fBlitMaskA8) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
-            p.append(SkRasterPipeline::scale_u8, &fMaskPtr);
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-        } else {
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-            p.append(SkRasterPipeline::lerp_u8, &fMaskPtr);
-        }
-        this->append_store(&p);
-        fBlitMaskA8 = p.compile();
+        fBlitMaskA8 = this->compile_blit(Blit::kMaskA8);
     }
     if (mask.fFormat == SkMask::kLCD16_Format && !fBlitMaskLCD16) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/true)) {
-            // Somewhat unusually, scale_565 needs dst loaded first.
-            this->append_load_dst(&p);
-            p.append(SkRasterPipeline::scale_565, &fMaskPtr);
-            SkBlendMode_AppendStages(fBlend, &p);
-        } else {
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-            p.append(SkRasterPipeline::lerp_565, &fMaskPtr);
-        }
-        this->append_store(&p);
-        fBlitMaskLCD16 = p.compile();
+        fBlitMaskLCD16 = this->compile_blit(Blit::kMaskLCD16);
     }
     if (mask.fFormat == SkMask::k3D_Format && !fBlitMask3D) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        // This bit is where we differ from kA8_Format:
-        p.append(SkRasterPipeline::emboss, &fEmbossCtx);
-        // Now onward just as kA8.
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
-            p.append(SkRasterPipeline::scale_u8, &fMaskPtr);
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-        } else {
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-            p.append(SkRasterPipeline::lerp_u8, &fMaskPtr);
-        }
-        this->append_store(&p);
-        fBlitMask3D = p.compile();
+        fBlitMask3D = this->compile_blit(Blit::kMask3D);
     }
 
     std::function<void(size_t,size_t,size_t,size_t)>* blitter = nullptr;
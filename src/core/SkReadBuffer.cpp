@@ -328,10 +328,24 @@ sk_sp<SkImage> SkReadBuffer::readImage() {
         return nullptr;
     }
 
-    sk_sp<SkData> data = SkData::MakeUninitialized(size);
-    if (!this->readPad32(data->writable_data(), size)) {
-        this->validate(false);
-        return nullptr;
+    sk_sp<SkData> data;
+    if (fBackingData) {
+        const uint8_t* bytes = (const uint8_t*)this->skip(size);
+        if (!bytes) {
+            return nullptr;
+        }
+        const uint8_t* base = fBackingData->bytes();
+        if (bytes >= base && bytes + size <= base + fBackingData->size()) {
+            data = SkData::MakeSubset(fBackingData.get(), bytes - base, size);
+        } else {
+            data = SkData::MakeWithCopy(bytes, size);
+        }
+    } else {
+        data = SkData::MakeUninitialized(size);
+        if (!this->readPad32(data->writable_data(), size)) {
+            this->validate(false);
+            return nullptr;
+        }
     }
     if (this->isVersionLT(kDontNegateImageSize_Version)) {
         (void)this->read32();   // originX
@@ -9,6 +9,7 @@
 #define SkReadBuffer_DEFINED
 
 #include "SkColorFilter.h"
+#include "SkData.h"
 #include "SkSerialProcs.h"
 #include "SkDrawLooper.h"
 #include "SkFont.h"
@@ -24,7 +25,6 @@
 #include "SkShaderBase.h"
 #include "SkWriteBuffer.h"
 
-class SkData;
 class SkImage;
 
 #ifndef SK_DISABLE_READBUFFER
@@ -48,6 +48,7 @@ public:
         kSaveBehind_Version                = 66,
         kSerializeFonts_Version            = 67,
         kPaintDoesntSerializeFonts_Version = 68,
+        kAlignedPictureData_Version        = 69,
     };
 
     /**
@@ -169,6 +170,12 @@ public:
     void setDeserialProcs(const SkDeserialProcs& procs);
     const SkDeserialProcs& getDeserialProcs() const { return fProcs; }
 
+    /**
+     *  Tells the buffer that the memory it reads lies inside data, which outlives anything read
+     *  from it. Encoded images then reference data instead of copying their bytes.
+     */
+    void setBackingData(sk_sp<SkData> data) { fBackingData = std::move(data); }
+
     /**
      *  If isValid is false, sets the buffer to be "invalid". Returns true if the buffer
      *  is still valid.
@@ -229,6 +236,7 @@ private:
     int                     fFactoryCount;
 
     SkDeserialProcs fProcs;
+    sk_sp<SkData>   fBackingData;
 
     static bool IsPtrAlign4(const void* ptr) {
         return SkIsAlign4((uintptr_t)ptr);
@@ -258,6 +266,7 @@ public:
         kSaveBehind_Version                = 66,
         kSerializeFonts_Version            = 67,
         kPaintDoesntSerializeFonts_Version = 68,
+        kAlignedPictureData_Version        = 69,
     };
 
     bool isVersionLT(Version) const { return false; }
@@ -343,6 +352,7 @@ public:
     void setTypefaceArray(sk_sp<SkTypeface>[], int)        {}
     void setFactoryPlayback(SkFlattenable::Factory[], int) {}
     void setDeserialProcs(const SkDeserialProcs&)          {}
+    void setBackingData(sk_sp<SkData>)                     {}
 
     const SkDeserialProcs& getDeserialProcs() const {
         static const SkDeserialProcs procs;
@@ -8,8 +8,11 @@
 #include "SkRecordOpts.h"
 
 #include "SkCanvasPriv.h"
+#include "SkRecordDraw.h"
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
+#include "SkRectPriv.h"
+#include "SkShader.h"
 #include "SkTDArray.h"
 
 using namespace SkRecords;
@@ -289,6 +292,273 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// The passes below walk the record op by op instead of matching patterns: what they look for
+// depends on the matrix and clip, and on draws an arbitrary distance apart.
+
+void SkRecordNoopCulledDraws(SkRecord* record, const SkRect& cullRect) {
+    // These are the bounds a BBH would be built from; a draw with empty bounds is never drawn
+    // when the picture is played back through one.
+    SkAutoTMalloc<SkRect> bounds(record->count());
+    SkRecordFillBounds(cullRect, *record, bounds);
+
+    for (int i = 0; i < record->count(); i++) {
+        IsDraw isDraw;
+        if (bounds[i].isEmpty() && record->mutate(i, isDraw)) {
+            record->replace<NoOp>(i);
+        }
+    }
+}
+
+// Returns true if a fill with this paint leaves every pixel it fully covers opaque, whatever was
+// there before. sourceIsOpaque says whether what the draw samples (its color, shader or image) is.
+static bool paint_overwrites_opaque(const SkPaint* paint, bool sourceIsOpaque) {
+    if (!paint) {
+        return sourceIsOpaque;
+    }
+    if (paint->getAlpha() != 0xFF          ||
+        paint->getColorFilter()            ||
+        paint->getMaskFilter()             ||
+        paint->getImageFilter()            ||
+        paint->getPathEffect()             ||
+        paint->getLooper()                 ||
+        paint->getStyle() != SkPaint::kFill_Style) {
+        return false;
+    }
+    if (paint->getBlendMode() != SkBlendMode::kSrcOver &&
+        paint->getBlendMode() != SkBlendMode::kSrc) {
+        return false;
+    }
+    return sourceIsOpaque;
+}
+
+// Follows the matrix, and whether an anti-aliased clip is in effect, through the record, and sorts
+// each op into one of the kinds below. Draws that cover what they draw over are occluders.
+class OcclusionVisitor {
+public:
+    enum Kind {
+        kNoOp,
+        kMatrix,      // Changes the matrix but not the clip.
+        kDraw,
+        kOccluder,    // A draw; covered() is what it overwrites.
+        kOther,       // Might change the clip, layer or anything else.
+    };
+
+    OcclusionVisitor() { fAAClip.push_back(false); }
+
+    // For the last kOccluder, what it overwrites in identity space. Unbounded for DrawPaint.
+    const SkRect& covered() const { return fCovered; }
+    bool coversEverything() const { return fCoversEverything; }
+
+    Kind operator()(const NoOp&)           { return kNoOp; }
+
+    Kind operator()(const SetMatrix& op)   { fCTM = op.matrix;                  return kMatrix; }
+    Kind operator()(const Concat& op)      { fCTM.preConcat(op.matrix);         return kMatrix; }
+    Kind operator()(const Translate& op)   { fCTM.preTranslate(op.dx, op.dy);   return kMatrix; }
+
+    Kind operator()(const Save&)           { return this->save(); }
+    Kind operator()(const SaveLayer&)      { return this->save(); }
+    Kind operator()(const SaveBehind&)     { return this->save(); }
+    Kind operator()(const Restore& op) {
+        fCTM = op.matrix;
+        if (fAAClip.count() > 1) {
+            fAAClip.pop();
+        }
+        return kOther;
+    }
+
+    Kind operator()(const ClipRect& op)    { return this->clip(op.opAA.aa()); }
+    Kind operator()(const ClipRRect& op)   { return this->clip(op.opAA.aa()); }
+    Kind operator()(const ClipPath& op)    { return this->clip(op.opAA.aa()); }
+    Kind operator()(const ClipRegion&)     { return this->clip(false); }
+
+    Kind operator()(const DrawPaint& op) {
+        if (fAAClip.top() || !paint_overwrites_opaque(&op.paint, shader_is_opaque(op.paint))) {
+            return kDraw;
+        }
+        fCoversEverything = true;
+        return kOccluder;
+    }
+    Kind operator()(const DrawRect& op) {
+        return this->occluder(op.rect, &op.paint, shader_is_opaque(op.paint));
+    }
+    Kind operator()(const DrawImageRect& op) {
+        // Devices clip a src reaching outside the image to its bounds and shrink dst to match,
+        // leaving the rest of dst untouched.
+        if (op.src && !SkRect::Make(op.image->bounds()).contains(*op.src)) {
+            return kDraw;
+        }
+        return this->occluder(op.dst, op.paint, op.image->isOpaque());
+    }
+
+    template <typename T>
+    SK_WHEN(T::kTags & kDraw_Tag, Kind) operator()(const T&) { return kDraw; }
+
+    template <typename T>
+    SK_WHEN(!(T::kTags & kDraw_Tag), Kind) operator()(const T&) { return kOther; }
+
+private:
+    static bool shader_is_opaque(const SkPaint& paint) {
+        return !paint.getShader() || paint.getShader()->isOpaque();
+    }
+
+    Kind save() {
+        fAAClip.push_back(fAAClip.top());
+        return kOther;
+    }
+
+    Kind clip(bool aa) {
+        fAAClip.top() |= aa;
+        return kOther;
+    }
+
+    Kind occluder(SkRect rect, const SkPaint* paint, bool sourceIsOpaque) {
+        // An anti-aliased clip only partly covers the pixels along its edge, so what was drawn
+        // there before always shows through.
+        if (fAAClip.top() || !fCTM.rectStaysRect() ||
+            !paint_overwrites_opaque(paint, sourceIsOpaque)) {
+            return kDraw;
+        }
+        rect.sort();
+        fCovered = fCTM.mapRect(rect);
+        fCoversEverything = false;
+        return kOccluder;
+    }
+
+    SkMatrix       fCTM = SkMatrix::I();
+    SkTDArray<bool> fAAClip;    // For each save, whether any clip in effect is anti-aliased.
+    SkRect         fCovered = SkRect::MakeEmpty();
+    bool           fCoversEverything = false;
+};
+
+void SkRecordNoopOccludedDraws(SkRecord* record) {
+    // Conservative identity space bounds for every op. Culling against the largest rect we can
+    // map safely, rather than the picture's cull rect, keeps draws that reach outside the cull
+    // from looking covered when the picture is played back without a BBH.
+    SkAutoTMalloc<SkRect> bounds(record->count());
+    SkRecordFillBounds(SkRectPriv::MakeLargeS32(), *record, bounds);
+
+    // Anti-aliased edges reach into pixels the bounds only partly overlap. An occluder fully
+    // covers only whole pixels inside it, so a draw must be a pixel clear of its edge.
+    const SkScalar kMargin = 1;
+
+    // Looking back further than this turns long runs of draws quadratic, and rarely finds more.
+    const int kMaxCandidates = 64;
+
+    OcclusionVisitor visitor;
+    SkTDArray<int> candidates;    // Draws since the clip last changed, not yet covered.
+    for (int i = 0; i < record->count(); i++) {
+        switch (record->visit(i, visitor)) {
+            case OcclusionVisitor::kNoOp:
+            case OcclusionVisitor::kMatrix:
+                break;
+            case OcclusionVisitor::kOther:
+                candidates.rewind();
+                break;
+            case OcclusionVisitor::kOccluder: {
+                int kept = 0;
+                for (int candidate : candidates) {
+                    if (visitor.coversEverything() ||
+                        visitor.covered().contains(bounds[candidate].makeOutset(kMargin,
+                                                                                kMargin))) {
+                        record->replace<NoOp>(candidate);
+                    } else {
+                        candidates[kept++] = candidate;
+                    }
+                }
+                candidates.setCount(kept);
+                // The occluder may itself be covered later.
+                candidates.push_back(i);
+                break;
+            }
+            case OcclusionVisitor::kDraw:
+                if (candidates.count() == kMaxCandidates) {
+                    candidates.remove(0);
+                }
+                candidates.push_back(i);
+                break;
+        }
+    }
+}
+
+// DrawEdgeAAImageSet applies the paint's image filter and looper to the set as a whole, and both
+// devices send sets with a mask filter down slower paths than DrawImageRect takes. The GPU device
+// also always draws sets with GrAA::kYes, which turns on MSAA even for entries without AA flags,
+// so only anti-aliased DrawImageRects are batched. With none of those it draws each entry just as
+// a DrawImageRect would, and on the GPU it draws entries from compatible textures as one op.
+static bool batchable_image_rect(const DrawImageRect& op) {
+    if (op.src && !op.src->isSorted()) {
+        return false;
+    }
+    const SkPaint* paint = op.paint;
+    return paint                     &&
+           paint->isAntiAlias()      &&
+           !paint->getImageFilter()  &&
+           !paint->getLooper()       &&
+           !paint->getMaskFilter()   &&
+           !paint->getPathEffect()   &&
+           paint->getStyle() == SkPaint::kFill_Style;
+}
+
+static bool same_paint(const SkPaint* a, const SkPaint* b) {
+    return a == b || (a && b && *a == *b);
+}
+
+static DrawImageRect* as_image_rect(SkRecord* record, int i) {
+    Is<DrawImageRect> is;
+    return record->mutate(i, is) ? is.get() : nullptr;
+}
+
+void SkRecordBatchImageRects(SkRecord* record) {
+    SkTDArray<int> batch;
+    for (int begin = 0; begin < record->count();) {
+        DrawImageRect* first = as_image_rect(record, begin);
+        if (!first || !batchable_image_rect(*first)) {
+            begin++;
+            continue;
+        }
+
+        // Gather the DrawImageRects that follow with the same paint, skipping NoOps.
+        batch.rewind();
+        batch.push_back(begin);
+        int end = begin + 1;
+        for (; end < record->count(); end++) {
+            Is<NoOp> isNoOp;
+            if (record->mutate(end, isNoOp)) {
+                continue;
+            }
+            DrawImageRect* next = as_image_rect(record, end);
+            if (!next || !batchable_image_rect(*next) || next->constraint != first->constraint ||
+                !same_paint(next->paint, first->paint)) {
+                break;
+            }
+            batch.push_back(end);
+        }
+
+        if (batch.count() > 1) {
+            SkAutoTArray<SkCanvas::ImageSetEntry> set(batch.count());
+            for (int j = 0; j < batch.count(); j++) {
+                const DrawImageRect* op = as_image_rect(record, batch[j]);
+                SkRect src = op->src ? *op->src : SkRect::Make(op->image->bounds());
+                set[j] = SkCanvas::ImageSetEntry(op->image, src, op->dst, 1,
+                                                 SkCanvas::kAll_QuadAAFlags);
+            }
+
+            SkPaint* paint = new (record->alloc<SkPaint>()) SkPaint(*first->paint);
+            const SkCanvas::SrcRectConstraint constraint = first->constraint;
+            const int count = batch.count();
+
+            for (int j = 1; j < count; j++) {
+                record->replace<NoOp>(batch[j]);
+            }
+            new (record->replace<DrawEdgeAAImageSet>(begin))
+                    DrawEdgeAAImageSet{paint, std::move(set), count, nullptr, nullptr, constraint};
+        }
+        begin = end;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkRecordOptimize(SkRecord* record) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
@@ -310,14 +580,17 @@ void SkRecordOptimize(SkRecord* record) {
     record->defrag();
 }
 
-void SkRecordOptimize2(SkRecord* record) {
+void SkRecordOptimize2(SkRecord* record, const SkRect& cullRect) {
     multiple_set_matrices(record);
+    SkRecordNoopCulledDraws(record, cullRect);
+    SkRecordNoopOccludedDraws(record);
     SkRecordNoopSaveRestores(record);
     // See why we turn this off in SkRecordOptimize above.
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
     SkRecordNoopSaveLayerDrawRestores(record);
 #endif
     SkRecordMergeSvgOpacityAndFilterLayers(record);
+    SkRecordBatchImageRects(record);
 
     record->defrag();
 }
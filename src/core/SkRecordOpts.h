@@ -26,7 +26,19 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// No-ops draws whose bounds miss cullRect, the draws a BBH built with that cull rect would skip.
+void SkRecordNoopCulledDraws(SkRecord*, const SkRect& cullRect);
+
+// No-ops draws completely overwritten by a later opaque DrawRect, DrawImageRect or DrawPaint under
+// the same clip. This assumes the record is not played back into an anti-aliased clip, nor scaled
+// down: either could leave the anti-aliased edges of a draw right by the occluder showing.
+void SkRecordNoopOccludedDraws(SkRecord*);
+
+// Merges runs of DrawImageRects with the same anti-aliased paint into a DrawEdgeAAImageSet, which
+// the GPU backend can draw as one op.
+void SkRecordBatchImageRects(SkRecord*);
+
 // Experimental optimizers
-void SkRecordOptimize2(SkRecord*);
+void SkRecordOptimize2(SkRecord*, const SkRect& cullRect);
 
 #endif//SkRecordOpts_DEFINED
@@ -44,14 +44,16 @@ SkRecorder::SkRecorder(SkRecord* record, int width, int height, SkMiniRecorder*
     , fDrawPictureMode(Record_DrawPictureMode)
     , fApproxBytesUsedBySubPictures(0)
     , fRecord(record)
-    , fMiniRecorder(mr) {}
+    , fMiniRecorder(mr)
+    , fListener(nullptr) {}
 
 SkRecorder::SkRecorder(SkRecord* record, const SkRect& bounds, SkMiniRecorder* mr)
     : SkCanvasVirtualEnforcer<SkNoDrawCanvas>(bounds.roundOut())
     , fDrawPictureMode(Record_DrawPictureMode)
     , fApproxBytesUsedBySubPictures(0)
     , fRecord(record)
-    , fMiniRecorder(mr) {}
+    , fMiniRecorder(mr)
+    , fListener(nullptr) {}
 
 void SkRecorder::reset(SkRecord* record, const SkRect& bounds,
                        DrawPictureMode dpm, SkMiniRecorder* mr) {
@@ -69,6 +71,12 @@ void SkRecorder::forgetRecord() {
     fRecord = nullptr;
 }
 
+std::unique_ptr<SkDrawableList> SkRecorder::switchRecord(SkRecord* record) {
+    SkASSERT(!fMiniRecorder);
+    fRecord = record;
+    return std::move(fDrawableList);
+}
+
 // To make appending to fRecord a little less verbose.
 template<typename T, typename... Args>
 void SkRecorder::append(Args&&... args) {
@@ -76,6 +84,9 @@ void SkRecorder::append(Args&&... args) {
         this->flushMiniRecorder();
     }
     new (fRecord->append<T>()) T{std::forward<Args>(args)...};
+    if (fListener) {
+        fListener->didAppend(this);
+    }
 }
 
 #define TRY_MINIRECORDER(method, ...) \
@@ -54,6 +54,20 @@ public:
     // Make SkRecorder forget entirely about its SkRecord*; all calls to SkRecorder will fail.
     void forgetRecord();
 
+    // Continue recording into a new SkRecord (which we don't own), keeping the canvas state:
+    // matrix, clip and save stack. Returns the drawables referenced by the ops recorded so far.
+    std::unique_ptr<SkDrawableList> switchRecord(SkRecord*);
+
+    // A Listener is told after each op is appended to the SkRecord. It may switchRecord().
+    class Listener {
+    public:
+        virtual ~Listener() {}
+        virtual void didAppend(SkRecorder*) = 0;
+    };
+    void setListener(Listener* listener) { fListener = listener; }
+
+    const SkRecord* record() const { return fRecord; }
+
     void onFlush() override;
 
     void willSave() override;
@@ -138,6 +152,7 @@ private:
     std::unique_ptr<SkDrawableList> fDrawableList;
 
     SkMiniRecorder* fMiniRecorder;
+    Listener* fListener;
 };
 
 #endif//SkRecorder_DEFINED
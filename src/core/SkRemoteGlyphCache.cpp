@@ -16,6 +16,7 @@
 #include "SkDevice.h"
 #include "SkDraw.h"
 #include "SkGlyphRun.h"
+#include "SkOSFile.h"
 #include "SkRemoteGlyphCacheImpl.h"
 #include "SkStrike.h"
 #include "SkStrikeCache.h"
@@ -165,13 +166,31 @@ private:
 // Paths use a SkWriter32 which requires 4 byte alignment.
 static const size_t kPathAlignment  = 4u;
 
-bool read_path(Deserializer* deserializer, SkGlyph* glyph, SkStrike* cache) {
+// When a server has a glyph pool, each image and path is preceded by its offset in the pool, or
+// by this if the pool could not take it and the data follows inline as usual.
+static const uint64_t kInlineGlyphData = ~0ull;
+
+// pool is only set if the server sent the glyph with a pool.
+bool read_path(Deserializer* deserializer, SkGlyph* glyph, SkStrike* cache,
+               SkSharedGlyphPool* pool) {
     uint64_t pathSize = 0u;
     if (!deserializer->read<uint64_t>(&pathSize)) return false;
 
     if (pathSize == 0u) return true;
 
-    auto* path = deserializer->read(pathSize, kPathAlignment);
+    uint64_t poolOffset = kInlineGlyphData;
+    if (pool && !deserializer->read<uint64_t>(&poolOffset)) return false;
+
+    // Paths are copied out of the pool; the mapping need only live until they are.
+    sk_sp<SkData> mapping;
+    const volatile void* path;
+    if (poolOffset != kInlineGlyphData) {
+        const void* pooled = nullptr;
+        mapping = pool->read(poolOffset, pathSize, kPathAlignment, &pooled);
+        path = pooled;
+    } else {
+        path = deserializer->read(pathSize, kPathAlignment);
+    }
     if (!path) return false;
 
     // Don't overwrite the path if we already have one. We could have used a fallback if the
@@ -181,6 +200,165 @@ bool read_path(Deserializer* deserializer, SkGlyph* glyph, SkStrike* cache) {
     return cache->initializePath(glyph, path, pathSize);
 }
 
+// -- SkSharedGlyphPool ---------------------------------------------------------------------------
+sk_sp<SkSharedGlyphPool> SkSharedGlyphPool::MakeWriter(const char path[], size_t byteLimit) {
+    FILE* file = sk_fopen(path, kWrite_SkFILE_Flag);
+    if (!file) return nullptr;
+    return sk_sp<SkSharedGlyphPool>(new SkSharedGlyphPool(file, true, byteLimit));
+}
+
+sk_sp<SkSharedGlyphPool> SkSharedGlyphPool::MakeReader(const char path[]) {
+    FILE* file = sk_fopen(path, kRead_SkFILE_Flag);
+    if (!file) return nullptr;
+    return sk_sp<SkSharedGlyphPool>(new SkSharedGlyphPool(file, false, 0u));
+}
+
+SkSharedGlyphPool::SkSharedGlyphPool(FILE* file, bool writer, uint64_t byteLimit)
+        : fFile(file), fWriter(writer), fByteLimit(byteLimit) {}
+
+SkSharedGlyphPool::~SkSharedGlyphPool() {
+    // Strikes hold on to the mappings they use, so they can outlive the file being closed.
+    sk_fclose(fFile);
+}
+
+size_t SkSharedGlyphPool::size() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fWriter ? fSize : (fMapping ? fMapping->size() : 0u);
+}
+
+SkSharedGlyphPool::PoolStrike* SkSharedGlyphPool::findOrCreateStrike(const SkDescriptor& desc) {
+    auto it = fStrikes.find(&desc);
+    if (it != fStrikes.end()) {
+        return it->second.get();
+    }
+    auto strike = skstd::make_unique<PoolStrike>(desc);
+    PoolStrike* result = strike.get();
+    fStrikes.emplace(strike->fDesc.getDesc(), std::move(strike));
+    return result;
+}
+
+bool SkSharedGlyphPool::append(const void* data, size_t size, size_t alignment,
+                               uint64_t* offset) {
+    static const uint8_t kZeros[16] = {0};
+    size_t padding = pad(fSize, alignment) - fSize;
+    SkASSERT(padding < sizeof(kZeros));
+    if (padding + size > fByteLimit - fSize) {
+        // Full. What is already written stays good, so smaller writes may still fit.
+        return false;
+    }
+    if (sk_fwrite(kZeros, padding, fFile) != padding || sk_fwrite(data, size, fFile) != size) {
+        // The file no longer matches fSize; don't write anything else to it.
+        fFailed = true;
+        return false;
+    }
+    *offset = fSize + padding;
+    fSize = *offset + size;
+    return true;
+}
+
+bool SkSharedGlyphPool::findImage(const SkDescriptor& desc, SkPackedGlyphID glyphID,
+                                  uint64_t* offset) {
+    if (Entry* entry = this->findOrCreateStrike(desc)->fImages.find(glyphID)) {
+        *offset = entry->fOffset;
+        return true;
+    }
+    return false;
+}
+
+bool SkSharedGlyphPool::findPath(const SkDescriptor& desc, SkPackedGlyphID glyphID,
+                                 uint64_t* offset, uint64_t* size) {
+    if (Entry* entry = this->findOrCreateStrike(desc)->fPaths.find(glyphID)) {
+        *offset = entry->fOffset;
+        *size = entry->fSize;
+        return true;
+    }
+    return false;
+}
+
+bool SkSharedGlyphPool::writeImage(const SkDescriptor& desc, SkScalerContext* context,
+                                   SkGlyph* glyph, uint64_t* offset) {
+    SkASSERT(fWriter);
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (fFailed) return false;
+        if (this->findImage(desc, glyph->getPackedID(), offset)) return true;
+        // Don't rasterize an image that can't fit.
+        if (glyph->computeImageSize() > fByteLimit - fSize) return false;
+    }
+
+    // Rasterize without the lock, so that other servers sharing the pool aren't held up.
+    size_t imageSize = glyph->computeImageSize();
+    SkAutoTMalloc<uint8_t> image(imageSize);
+    glyph->fImage = image.get();
+    context->getImage(*glyph);
+    glyph->fImage = nullptr;
+
+    SkAutoMutexAcquire lock(fMutex);
+    if (fFailed) return false;
+    // Another server may have written the same glyph in the meantime.
+    if (this->findImage(desc, glyph->getPackedID(), offset)) return true;
+
+    if (!this->append(image.get(), imageSize, glyph->formatAlignment(), offset)) return false;
+    this->findOrCreateStrike(desc)->fImages.set(glyph->getPackedID(), {*offset, imageSize});
+    return true;
+}
+
+bool SkSharedGlyphPool::writePath(const SkDescriptor& desc, SkScalerContext* context,
+                                  SkPackedGlyphID glyphID, uint64_t* offset, uint64_t* size) {
+    SkASSERT(fWriter);
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (fFailed) return false;
+        if (this->findPath(desc, glyphID, offset, size)) return true;
+    }
+
+    // Generate and serialize the path without the lock, as in writeImage().
+    SkPath path;
+    SkAutoTMalloc<uint8_t> buffer;
+    size_t pathSize = 0u;
+    if (context->getPath(glyphID, &path)) {
+        pathSize = path.writeToMemory(nullptr);
+        buffer.reset(pathSize);
+        path.writeToMemory(buffer.get());
+    }
+
+    SkAutoMutexAcquire lock(fMutex);
+    if (fFailed) return false;
+    if (this->findPath(desc, glyphID, offset, size)) return true;
+
+    *offset = 0u;
+    *size = pathSize;
+    if (pathSize > 0u && !this->append(buffer.get(), pathSize, kPathAlignment, offset)) {
+        return false;
+    }
+    this->findOrCreateStrike(desc)->fPaths.set(glyphID, {*offset, *size});
+    return true;
+}
+
+void SkSharedGlyphPool::flush() {
+    SkASSERT(fWriter);
+    SkAutoMutexAcquire lock(fMutex);
+    sk_fflush(fFile);
+}
+
+sk_sp<SkData> SkSharedGlyphPool::read(uint64_t offset, uint64_t size, size_t alignment,
+                                      const void** data) {
+    SkASSERT(!fWriter);
+    if (offset % alignment != 0u || offset > UINT64_MAX - size) return nullptr;
+
+    SkAutoMutexAcquire lock(fMutex);
+    if (!fMapping || offset + size > fMapping->size()) {
+        // The writer has added to the file since it was mapped. Earlier mappings stay alive as
+        // long as strikes point into them.
+        sk_sp<SkData> mapping = SkData::MakeFromFILE(fFile);
+        if (!mapping) return nullptr;
+        fMapping = std::move(mapping);
+        if (offset + size > fMapping->size()) return nullptr;
+    }
+    *data = fMapping->bytes() + offset;
+    return fMapping;
+}
+
 size_t SkDescriptorMapOperators::operator()(const SkDescriptor* key) const {
     return key->getChecksum();
 }
@@ -290,6 +468,11 @@ SkStrikeServer::SkStrikeServer(DiscardableHandleManager* discardableHandleManage
 
 SkStrikeServer::~SkStrikeServer() = default;
 
+void SkStrikeServer::setGlyphPool(sk_sp<SkSharedGlyphPool> pool) {
+    SkASSERT(!pool || pool->isWriter());
+    fGlyphPool = std::move(pool);
+}
+
 sk_sp<SkData> SkStrikeServer::serializeTypeface(SkTypeface* tf) {
     auto* data = fSerializedTypefaces.find(SkTypeface::UniqueID(tf));
     if (data) {
@@ -309,6 +492,7 @@ void SkStrikeServer::writeStrikeData(std::vector<uint8_t>* memory) {
     }
 
     Serializer serializer(memory);
+    serializer.emplace<bool>(fGlyphPool != nullptr);
     serializer.emplace<uint64_t>(fTypefacesToSend.size());
     for (const auto& tf : fTypefacesToSend) serializer.write<WireTypeface>(tf);
     fTypefacesToSend.clear();
@@ -317,9 +501,14 @@ void SkStrikeServer::writeStrikeData(std::vector<uint8_t>* memory) {
     for (const auto* desc : fLockedDescs) {
         auto it = fRemoteGlyphStateMap.find(desc);
         SkASSERT(it != fRemoteGlyphStateMap.end());
-        it->second->writePendingGlyphs(&serializer);
+        it->second->writePendingGlyphs(&serializer, fGlyphPool.get());
     }
     fLockedDescs.clear();
+
+    // The client may look at the pool as soon as it has memory.
+    if (fGlyphPool) {
+        fGlyphPool->flush();
+    }
 }
 
 SkStrikeServer::SkGlyphCacheState* SkStrikeServer::getOrCreateCache(
@@ -467,7 +656,8 @@ static void writeGlyph(SkGlyph* glyph, Serializer* serializer) {
     serializer->write<uint8_t>(glyph->fMaskFormat);
 }
 
-void SkStrikeServer::SkGlyphCacheState::writePendingGlyphs(Serializer* serializer) {
+void SkStrikeServer::SkGlyphCacheState::writePendingGlyphs(Serializer* serializer,
+                                                           SkSharedGlyphPool* pool) {
     // TODO(khushalsagar): Write a strike only if it has any pending glyphs.
     serializer->emplace<bool>(this->hasPendingGlyphs());
     if (!this->hasPendingGlyphs()) {
@@ -496,6 +686,15 @@ void SkStrikeServer::SkGlyphCacheState::writePendingGlyphs(Serializer* serialize
         auto imageSize = glyph.computeImageSize();
         if (imageSize == 0u) continue;
 
+        if (pool) {
+            uint64_t offset;
+            if (pool->writeImage(*fDescriptor.getDesc(), fContext.get(), &glyph, &offset)) {
+                serializer->write<uint64_t>(offset);
+                continue;
+            }
+            serializer->write<uint64_t>(kInlineGlyphData);
+        }
+
         glyph.fImage = serializer->allocate(imageSize, glyph.formatAlignment());
         fContext->getImage(glyph);
         // TODO: Generating the image can change the mask format, do we need to update it in the
@@ -511,7 +710,7 @@ void SkStrikeServer::SkGlyphCacheState::writePendingGlyphs(Serializer* serialize
         SkASSERT(SkMask::IsValidFormat(glyph.fMaskFormat));
 
         writeGlyph(&glyph, serializer);
-        writeGlyphPath(glyphID, serializer);
+        writeGlyphPath(glyphID, serializer, pool);
     }
     fPendingGlyphPaths.clear();
     this->resetScalerContext();
@@ -595,7 +794,18 @@ bool SkStrikeServer::SkGlyphCacheState::decideCouldDrawFromPath(const SkGlyph& g
 }
 
 void SkStrikeServer::SkGlyphCacheState::writeGlyphPath(const SkPackedGlyphID& glyphID,
-                                                       Serializer* serializer) const {
+                                                       Serializer* serializer,
+                                                       SkSharedGlyphPool* pool) const {
+    if (pool) {
+        uint64_t offset, pathSize;
+        if (pool->writePath(*fDescriptor.getDesc(), fContext.get(), glyphID,
+                            &offset, &pathSize)) {
+            serializer->write<uint64_t>(pathSize);
+            if (pathSize != 0u) serializer->write<uint64_t>(offset);
+            return;
+        }
+    }
+
     SkPath path;
     if (!fContext->getPath(glyphID, &path)) {
         serializer->write<uint64_t>(0u);
@@ -604,6 +814,7 @@ void SkStrikeServer::SkGlyphCacheState::writeGlyphPath(const SkPackedGlyphID& gl
 
     size_t pathSize = path.writeToMemory(nullptr);
     serializer->write<uint64_t>(pathSize);
+    if (pool) serializer->write<uint64_t>(kInlineGlyphData);
     path.writeToMemory(serializer->allocate(pathSize, kPathAlignment));
 }
 
@@ -669,6 +880,11 @@ SkStrikeClient::SkStrikeClient(sk_sp<DiscardableHandleManager> discardableManage
 
 SkStrikeClient::~SkStrikeClient() = default;
 
+void SkStrikeClient::setGlyphPool(sk_sp<SkSharedGlyphPool> pool) {
+    SkASSERT(!pool || !pool->isWriter());
+    fGlyphPool = std::move(pool);
+}
+
 #define READ_FAILURE                             \
     {                                            \
         SkDebugf("Bad font data serialization"); \
@@ -696,6 +912,11 @@ bool SkStrikeClient::readStrikeData(const volatile void* memory, size_t memorySi
     SkASSERT(memorySize != 0u);
     Deserializer deserializer(static_cast<const volatile char*>(memory), memorySize);
 
+    bool pooled = false;
+    if (!deserializer.read<bool>(&pooled)) READ_FAILURE
+    if (pooled && !fGlyphPool) READ_FAILURE
+    SkSharedGlyphPool* pool = pooled ? fGlyphPool.get() : nullptr;
+
     uint64_t typefaceSize = 0u;
     if (!deserializer.read<uint64_t>(&typefaceSize)) READ_FAILURE
 
@@ -773,6 +994,21 @@ bool SkStrikeClient::readStrikeData(const volatile void* memory, size_t memorySi
             auto imageSize = glyph->computeImageSize();
             if (imageSize == 0u) continue;
 
+            uint64_t poolOffset = kInlineGlyphData;
+            if (pool && !deserializer.read<uint64_t>(&poolOffset)) READ_FAILURE
+            if (poolOffset != kInlineGlyphData) {
+                const void* pooledImage = nullptr;
+                auto mapping = pool->read(poolOffset, imageSize, glyph->formatAlignment(),
+                                          &pooledImage);
+                if (!mapping) READ_FAILURE
+
+                if (allocatedGlyph->fImage == nullptr) {
+                    strike->initializeImageInPlace(std::move(mapping), pooledImage,
+                                                   allocatedGlyph);
+                }
+                continue;
+            }
+
             auto* image = deserializer.read(imageSize, glyph->formatAlignment());
             if (!image) READ_FAILURE
 
@@ -799,7 +1035,7 @@ bool SkStrikeClient::readStrikeData(const volatile void* memory, size_t memorySi
                 allocatedGlyph->fImage = glyphImage;
             }
 
-            if (!read_path(&deserializer, allocatedGlyph, strike.get())) READ_FAILURE
+            if (!read_path(&deserializer, allocatedGlyph, strike.get(), pool)) READ_FAILURE
         }
     }
 
@@ -8,6 +8,7 @@
 #ifndef SkRemoteGlyphCache_DEFINED
 #define SkRemoteGlyphCache_DEFINED
 
+#include <cstdio>
 #include <memory>
 #include <tuple>
 #include <unordered_map>
@@ -16,9 +17,12 @@
 
 #include "../private/SkTHash.h"
 #include "SkData.h"
+#include "SkDescriptor.h"
 #include "SkDevice.h"
 #include "SkDrawLooper.h"
+#include "SkGlyph.h"
 #include "SkMakeUnique.h"
+#include "SkMutex.h"
 #include "SkNoDrawCanvas.h"
 #include "SkRefCnt.h"
 #include "SkSerialProcs.h"
@@ -28,6 +32,7 @@
 class Serializer;
 enum SkAxisAlignment : uint32_t;
 class SkDescriptor;
+class SkScalerContext;
 class SkStrike;
 struct SkPackedGlyphID;
 enum SkScalerContextFlags : uint32_t;
@@ -86,6 +91,91 @@ private:
 
 using SkDiscardableHandleId = uint32_t;
 
+#ifndef SK_DEFAULT_SHARED_GLYPH_POOL_LIMIT
+    #define SK_DEFAULT_SHARED_GLYPH_POOL_LIMIT (64 * 1024 * 1024)
+#endif
+
+// A SkSharedGlyphPool holds glyph images and paths in a file, usually on a memory backed file
+// system such as /dev/shm, so that they can be shared by processes instead of being copied to
+// each one. A single SkStrikeServer process appends to the file with a writer, and any number of
+// SkStrikeClient processes map it read only with readers. Servers then send a glyph's offset in
+// the pool in place of its data, and clients point their glyphs' images into the mapping.
+//
+// A writer may be shared by several SkStrikeServers (one per client, say); a glyph is written
+// once for all of them. All methods are thread-safe.
+//
+// Nothing is ever removed from the pool, so a writer stops growing it at a byte limit. Servers
+// send the glyphs that don't fit with their data, as they do without a pool.
+class SK_API SkSharedGlyphPool final : public SkRefCnt {
+public:
+    // Creates the file at path, truncating any existing one, to hold at most byteLimit bytes.
+    // Returns null if it can't.
+    static sk_sp<SkSharedGlyphPool> MakeWriter(
+            const char path[], size_t byteLimit = SK_DEFAULT_SHARED_GLYPH_POOL_LIMIT);
+
+    // Opens the file at path, written by a writer in another process. Returns null if it can't.
+    static sk_sp<SkSharedGlyphPool> MakeReader(const char path[]);
+
+    ~SkSharedGlyphPool() override;
+
+    bool isWriter() const { return fWriter; }
+
+    // The number of bytes written to the pool, or mapped by a reader.
+    size_t size() const;
+
+    // Methods used internally in skia ------------------------------------------
+    // Writer only. Sets *offset to where the image of glyph (with its metrics already set) is in
+    // the pool, rasterizing and writing it with context first if it is not there yet. Returns
+    // false if the image could not be written, or would take the pool past its byte limit.
+    // Rasterizing doesn't hold up other callers; if two race on one glyph, both rasterize it but
+    // only the first is written.
+    bool writeImage(const SkDescriptor&, SkScalerContext*, SkGlyph*, uint64_t* offset);
+
+    // Writer only. As writeImage, for the serialized path of the glyph. *size is set to zero if
+    // the glyph has no path.
+    bool writePath(const SkDescriptor&, SkScalerContext*, SkPackedGlyphID,
+                   uint64_t* offset, uint64_t* size);
+
+    // Writer only. Makes everything written so far visible to readers.
+    void flush();
+
+    // Reader only. Sets *data to the size bytes at offset, which must be aligned to alignment,
+    // mapping more of the file if needed, and returns the mapping that holds them. Returns null
+    // if they are not in the file.
+    sk_sp<SkData> read(uint64_t offset, uint64_t size, size_t alignment, const void** data);
+
+private:
+    struct Entry {
+        uint64_t fOffset;
+        uint64_t fSize;
+    };
+    struct PoolStrike {
+        explicit PoolStrike(const SkDescriptor& desc) : fDesc(desc) {}
+
+        SkAutoDescriptor                    fDesc;
+        SkTHashMap<SkPackedGlyphID, Entry>  fImages;
+        SkTHashMap<SkPackedGlyphID, Entry>  fPaths;
+    };
+
+    SkSharedGlyphPool(FILE* file, bool writer, uint64_t byteLimit);
+
+    // Must be called with fMutex held.
+    PoolStrike* findOrCreateStrike(const SkDescriptor&);
+    bool findImage(const SkDescriptor&, SkPackedGlyphID, uint64_t* offset);
+    bool findPath(const SkDescriptor&, SkPackedGlyphID, uint64_t* offset, uint64_t* size);
+    bool append(const void* data, size_t size, size_t alignment, uint64_t* offset);
+
+    FILE* const                                 fFile;
+    const bool                                  fWriter;
+    const uint64_t                              fByteLimit;         // Writer only.
+
+    mutable SkMutex                             fMutex;     // Guards everything below.
+    uint64_t                                    fSize = 0u;
+    bool                                        fFailed = false;   // Writer only.
+    SkDescriptorMap<std::unique_ptr<PoolStrike>> fStrikes;  // Writer only.
+    sk_sp<SkData>                               fMapping;   // Reader only.
+};
+
 // This class is not thread-safe.
 class SK_API SkStrikeServer final : public SkStrikeCacheInterface {
 public:
@@ -124,6 +214,10 @@ public:
     // unlocked after this call.
     void writeStrikeData(std::vector<uint8_t>* memory);
 
+    // Writes glyph images and paths into pool, a writer, and sends their offsets instead of
+    // their data. Clients must have a reader of the same pool.
+    void setGlyphPool(sk_sp<SkSharedGlyphPool> pool);
+
     // Methods used internally in skia ------------------------------------------
     class SkGlyphCacheState;
 
@@ -154,6 +248,7 @@ private:
 
     SkDescriptorMap<std::unique_ptr<SkGlyphCacheState>> fRemoteGlyphStateMap;
     DiscardableHandleManager* const fDiscardableHandleManager;
+    sk_sp<SkSharedGlyphPool> fGlyphPool;
     SkTHashSet<SkFontID> fCachedTypefaces;
     size_t fMaxEntriesInDescriptorMap = kMaxEntriesInDescriptorMap;
 
@@ -210,6 +305,10 @@ public:
     // Returns false if the data is invalid.
     bool readStrikeData(const volatile void* memory, size_t memorySize);
 
+    // Reads the images and paths of glyphs sent by a server with a pool from pool, a reader.
+    // Images are used in place.
+    void setGlyphPool(sk_sp<SkSharedGlyphPool> pool);
+
 private:
     class DiscardableStrikePinner;
 
@@ -217,6 +316,7 @@ private:
 
     SkTHashMap<SkFontID, sk_sp<SkTypeface>> fRemoteFontIdToTypeface;
     sk_sp<DiscardableHandleManager> fDiscardableHandleManager;
+    sk_sp<SkSharedGlyphPool> fGlyphPool;
     SkStrikeCache* const fStrikeCache;
     const bool fIsLogging;
 };
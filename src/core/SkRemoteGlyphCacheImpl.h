@@ -23,7 +23,8 @@ public:
     ~SkGlyphCacheState() override;
 
     void addGlyph(SkPackedGlyphID, bool pathOnly);
-    void writePendingGlyphs(Serializer* serializer);
+    // Images and paths go into pool instead of serializer if it is not null.
+    void writePendingGlyphs(Serializer* serializer, SkSharedGlyphPool* pool);
     SkDiscardableHandleId discardableHandleId() const { return fDiscardableHandleId; }
 
     bool isSubpixel() const { return fIsSubpixel; }
@@ -53,7 +54,8 @@ private:
     bool hasPendingGlyphs() const {
         return !fPendingGlyphImages.empty() || !fPendingGlyphPaths.empty();
     }
-    void writeGlyphPath(const SkPackedGlyphID& glyphID, Serializer* serializer) const;
+    void writeGlyphPath(const SkPackedGlyphID& glyphID, Serializer* serializer,
+                        SkSharedGlyphPool* pool) const;
 
     void ensureScalerContext();
     void resetScalerContext();
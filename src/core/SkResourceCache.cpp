@@ -11,10 +11,13 @@
 #include "SkMessageBus.h"
 #include "SkMipMap.h"
 #include "SkMutex.h"
+#include "SkOnce.h"
 #include "SkOpts.h"
 #include "SkTo.h"
 #include "SkTraceMemoryDump.h"
 
+#include <atomic>
+#include <limits>
 #include <stddef.h>
 #include <stdlib.h>
 
@@ -38,6 +41,11 @@ static inline bool SkShouldPostMessageToBus(
     #define SK_DEFAULT_IMAGE_CACHE_LIMIT     (32 * 1024 * 1024)
 #endif
 
+// The global cache is split into 1 << SK_RESOURCE_CACHE_SHARD_BITS shards.
+#ifndef SK_RESOURCE_CACHE_SHARD_BITS
+    #define SK_RESOURCE_CACHE_SHARD_BITS     3
+#endif
+
 void SkResourceCache::Key::init(void* nameSpace, uint64_t sharedID, size_t dataSize) {
     SkASSERT(SkAlign4(dataSize) == dataSize);
 
@@ -84,6 +92,7 @@ void SkResourceCache::init() {
     fTotalBytesUsed = 0;
     fCount = 0;
     fSingleAllocationByteLimit = 0;
+    fSharedBudget = false;
 
     // One of these should be explicit set by the caller after we return.
     fTotalByteLimit = 0;
@@ -202,17 +211,27 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
     size_t byteLimit;
     int    countLimit;
 
-    if (fDiscardableFactory) {
+    if (fSharedBudget && !forcePurge) {
+        return;  // Global::purgeAsNeeded() takes care of this
+    }
+
+    if (forcePurge) {
+        byteLimit = 0;
+        countLimit = 0;
+    } else if (fDiscardableFactory) {
         countLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
         byteLimit = UINT32_MAX;  // no limit based on bytes
     } else {
         countLimit = SK_MaxS32; // no limit based on count
         byteLimit = fTotalByteLimit;
     }
+    this->purgeDownTo(byteLimit, countLimit);
+}
 
+void SkResourceCache::purgeDownTo(size_t byteLimit, int countLimit) {
     Rec* rec = fTail;
     while (rec) {
-        if (!forcePurge && fTotalBytesUsed < byteLimit && fCount < countLimit) {
+        if (fTotalBytesUsed < byteLimit && fCount < countLimit) {
             break;
         }
 
@@ -289,17 +308,20 @@ size_t SkResourceCache::setTotalByteLimit(size_t newLimit) {
     return prevLimit;
 }
 
-SkCachedData* SkResourceCache::newCachedData(size_t bytes) {
-    this->checkMessages();
-
-    if (fDiscardableFactory) {
-        SkDiscardableMemory* dm = fDiscardableFactory(bytes);
+static SkCachedData* new_cached_data(SkResourceCache::DiscardableFactory factory, size_t bytes) {
+    if (factory) {
+        SkDiscardableMemory* dm = factory(bytes);
         return dm ? new SkCachedData(bytes, dm) : nullptr;
     } else {
         return new SkCachedData(sk_malloc_throw(bytes), bytes);
     }
 }
 
+SkCachedData* SkResourceCache::newCachedData(size_t bytes) {
+    this->checkMessages();
+    return new_cached_data(fDiscardableFactory, bytes);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkResourceCache::release(Rec* rec) {
@@ -449,86 +471,236 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-SK_DECLARE_STATIC_MUTEX(gMutex);
-static SkResourceCache* gResourceCache = nullptr;
+/**
+ *  The global cache. Keys are spread by hash over shards, each an SkResourceCache behind its own
+ *  mutex, so threads looking up different keys rarely wait on each other.
+ *
+ *  The budget is for all the shards together. What they hold is tallied in atomics, and when an
+ *  add takes the total over budget, shards are purged one at a time, starting with the one just
+ *  added to. Recs are kept in LRU order within each shard, but only roughly across shards.
+ */
+class SkResourceCache::Global {
+public:
+    static constexpr int kShardBits  = SK_RESOURCE_CACHE_SHARD_BITS;
+    static constexpr int kShardCount = 1 << kShardBits;
+    static_assert(0 < kShardBits && kShardBits <= 8, "bad_SK_RESOURCE_CACHE_SHARD_BITS");
 
-/** Must hold gMutex when calling. */
-static SkResourceCache* get_cache() {
-    // gMutex is always held when this is called, so we don't need to be fancy in here.
-    gMutex.assertHeld();
-    if (nullptr == gResourceCache) {
+    Global() : fBytesUsed(0), fCount(0), fSingleAllocationByteLimit(0) {
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
+        fDiscardableFactory = SkDiscardableMemory::Create;
+        fTotalByteLimit = 0;
 #else
-        gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+        fDiscardableFactory = nullptr;
+        fTotalByteLimit = SK_DEFAULT_IMAGE_CACHE_LIMIT;
 #endif
+        for (Shard& shard : fShards) {
+            shard.fCache = fDiscardableFactory ? new SkResourceCache(fDiscardableFactory)
+                                               : new SkResourceCache(fTotalByteLimit);
+            shard.fCache->fSharedBudget = true;
+        }
     }
-    return gResourceCache;
+
+    bool find(const Key& key, FindVisitor visitor, void* context) {
+        bool found = false;
+        this->withShard(ShardIndex(key), [&](SkResourceCache* cache) {
+            found = cache->find(key, visitor, context);
+        });
+        return found;
+    }
+
+    void add(Rec* rec, void* payload) {
+        // rec may be deleted by the add, so find its shard first.
+        const int index = ShardIndex(rec->getKey());
+        this->withShard(index, [&](SkResourceCache* cache) {
+            cache->add(rec, payload);
+        });
+        this->purgeAsNeeded(index);
+    }
+
+    void visitAll(Visitor visitor, void* context) {
+        for (int i = 0; i < kShardCount; ++i) {
+            this->withShard(i, [&](SkResourceCache* cache) {
+                cache->visitAll(visitor, context);
+            });
+        }
+    }
+
+    void purgeAll() {
+        for (int i = 0; i < kShardCount; ++i) {
+            this->withShard(i, [](SkResourceCache* cache) {
+                cache->purgeAll();
+            });
+        }
+    }
+
+    size_t getTotalBytesUsed() const { return fBytesUsed; }
+    size_t getTotalByteLimit() const { return fTotalByteLimit; }
+
+    size_t setTotalByteLimit(size_t newLimit) {
+        size_t prevLimit = fTotalByteLimit.exchange(newLimit);
+        if (newLimit < prevLimit) {
+            this->purgeAsNeeded(0);
+        }
+        return prevLimit;
+    }
+
+    size_t setSingleAllocationByteLimit(size_t newLimit) {
+        return fSingleAllocationByteLimit.exchange(newLimit);
+    }
+
+    size_t getSingleAllocationByteLimit() const { return fSingleAllocationByteLimit; }
+
+    // See SkResourceCache::getEffectiveSingleAllocationByteLimit().
+    size_t getEffectiveSingleAllocationByteLimit() const {
+        size_t limit = fSingleAllocationByteLimit;
+        if (nullptr == fDiscardableFactory) {
+            limit = 0 == limit ? fTotalByteLimit.load() : SkTMin(limit, fTotalByteLimit.load());
+        }
+        return limit;
+    }
+
+    DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
+
+    SkCachedData* newCachedData(size_t bytes) {
+        return new_cached_data(fDiscardableFactory, bytes);
+    }
+
+    void dump() {
+        SkDebugf("SkResourceCache: count=%d bytes=%zu %s, %d shards\n",
+                 fCount.load(), fBytesUsed.load(), fDiscardableFactory ? "discardable" : "malloc",
+                 kShardCount);
+        for (int i = 0; i < kShardCount; ++i) {
+            this->withShard(i, [](SkResourceCache* cache) {
+                cache->dump();
+            });
+        }
+    }
+
+private:
+    struct Shard {
+        SkMutex          fMutex;
+        SkResourceCache* fCache;
+    };
+
+    // Each shard's hash table is indexed by the low bits of the key hash, so pick the shard with
+    // the high bits.
+    static int ShardIndex(const Key& key) {
+        return key.hash() >> (32 - kShardBits);
+    }
+
+    // Calls fn(SkResourceCache*) with the shard locked, and tallies whatever fn adds or removes.
+    template <typename Fn>
+    void withShard(int index, Fn&& fn) {
+        Shard& shard = fShards[index];
+        SkAutoMutexAcquire am(shard.fMutex);
+        SkResourceCache* cache = shard.fCache;
+        const size_t bytesUsed = cache->fTotalBytesUsed;
+        const int    count     = cache->fCount;
+        fn(cache);
+        fBytesUsed += cache->fTotalBytesUsed - bytesUsed;  // (unsigned, so this can shrink too)
+        fCount     += cache->fCount - count;
+    }
+
+    // Given that a part of the total is held by one shard, returns the limit that shard must be
+    // purged down to for the total to come in under limit.
+    template <typename T>
+    static T ShardLimit(T part, T total, T limit) {
+        if (total < limit) {
+            return std::numeric_limits<T>::max();
+        }
+        const T over = total - limit;
+        return part > over ? part - over : 0;
+    }
+
+    // Purges shards, starting with first, until the total is within budget. Never holds more than
+    // one shard's lock at a time.
+    void purgeAsNeeded(int first) {
+        size_t byteLimit;
+        int    countLimit;
+        if (fDiscardableFactory) {
+            countLimit = SK_DISCARDABLEMEMORY_SCALEDIMAGECACHE_COUNT_LIMIT;
+            byteLimit = UINT32_MAX;  // no limit based on bytes
+        } else {
+            countLimit = SK_MaxS32; // no limit based on count
+            byteLimit = fTotalByteLimit;
+        }
+
+        for (int i = 0; i < kShardCount; ++i) {
+            if (fBytesUsed < byteLimit && fCount < countLimit) {
+                return;
+            }
+            this->withShard((first + i) % kShardCount, [&](SkResourceCache* cache) {
+                cache->purgeDownTo(ShardLimit(cache->fTotalBytesUsed, fBytesUsed.load(), byteLimit),
+                                   ShardLimit(cache->fCount, fCount.load(), countLimit));
+            });
+        }
+    }
+
+    Shard                fShards[kShardCount];
+    std::atomic<size_t>  fBytesUsed;
+    std::atomic<int>     fCount;
+    std::atomic<size_t>  fTotalByteLimit;
+    std::atomic<size_t>  fSingleAllocationByteLimit;
+    DiscardableFactory   fDiscardableFactory;
+};
+
+SkResourceCache::Global* SkResourceCache::GetGlobal() {
+    static SkOnce once;
+    static Global* global;
+    once([] { global = new Global; });
+    return global;
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalBytesUsed();
+    return GetGlobal()->getTotalBytesUsed();
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalByteLimit();
+    return GetGlobal()->getTotalByteLimit();
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setTotalByteLimit(newLimit);
+    return GetGlobal()->setTotalByteLimit(newLimit);
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->discardableFactory();
+    return GetGlobal()->discardableFactory();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->newCachedData(bytes);
+    return GetGlobal()->newCachedData(bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->dump();
+    GetGlobal()->dump();
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setSingleAllocationByteLimit(size);
+    return GetGlobal()->setSingleAllocationByteLimit(size);
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getSingleAllocationByteLimit();
+    return GetGlobal()->getSingleAllocationByteLimit();
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getEffectiveSingleAllocationByteLimit();
+    return GetGlobal()->getEffectiveSingleAllocationByteLimit();
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->purgeAll();
+    GetGlobal()->purgeAll();
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->find(key, visitor, context);
+    return GetGlobal()->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec, void* payload) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->add(rec, payload);
+    GetGlobal()->add(rec, payload);
 }
 
 void SkResourceCache::VisitAll(Visitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->visitAll(visitor, context);
+    GetGlobal()->visitAll(visitor, context);
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
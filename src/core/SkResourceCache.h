@@ -24,7 +24,9 @@ class SkTraceMemoryDump;
  *  caller must manage the access itself (e.g. via a mutex).
  *
  *  As a convenience, a global instance is also defined, which can be safely
- *  access across threads via the static methods (e.g. FindAndLock, etc.).
+ *  access across threads via the static methods (e.g. FindAndLock, etc.). To keep
+ *  threads from contending on it, the global instance is split by key hash into
+ *  shards, each with its own lock, which share a single budget.
  */
 class SkResourceCache {
 public:
@@ -270,10 +272,17 @@ private:
     size_t  fSingleAllocationByteLimit;
     int     fCount;
 
+    // True for the shards of the global cache, whose budget is enforced across all shards
+    // rather than by each one.
+    bool    fSharedBudget;
+
     SkMessageBus<PurgeSharedIDMessage>::Inbox fPurgeSharedIDInbox;
 
     void checkMessages();
     void purgeAsNeeded(bool forcePurge = false);
+    // Purges least recently used Recs until fewer than byteLimit bytes and countLimit Recs are
+    // in use, or none that can be purged are left.
+    void purgeDownTo(size_t byteLimit, int countLimit);
 
     // linklist management
     void moveToHead(Rec*);
@@ -283,6 +292,9 @@ private:
 
     void init();    // called by constructors
 
+    class Global;
+    static Global* GetGlobal();
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
@@ -280,6 +280,13 @@ public:
     bool SK_WARN_UNUSED_RESULT getPath(SkPackedGlyphID, SkPath*);
     void        getFontMetrics(SkFontMetrics*);
 
+    /** Returns a new context for the same strike, described by desc, that can generate glyphs on
+        another thread while this one is in use. Returns null if the port can't make one.
+     */
+    virtual std::unique_ptr<SkScalerContext> makeConcurrentContext(const SkDescriptor& desc) const {
+        return nullptr;
+    }
+
     /** Return the size in bytes of the associated gamma lookup table
      */
     static size_t GetGammaLUTSize(SkScalar contrast, SkScalar paintGamma, SkScalar deviceGamma,
@@ -16,6 +16,7 @@
 class SkRasterClip;
 class SkRegion;
 class SkBlitter;
+class SkExecutor;
 class SkPath;
 
 /** Defines a fixed-point rectangle, identical to the integer SkIRect, but its
@@ -26,6 +27,10 @@ typedef SkIRect SkXRect;
 extern std::atomic<bool> gSkUseAnalyticAA;
 extern std::atomic<bool> gSkForceAnalyticAA;
 
+// If set, AntiFillPath splits very complex paths into horizontal bands and fills them with analytic
+// AA on this executor. Such paths would otherwise be supersampled on the calling thread.
+extern std::atomic<SkExecutor*> gSkAnalyticAAExecutor;
+
 class AdditiveBlitter;
 
 class SkScan {
@@ -51,6 +56,10 @@ public:
     static void AntiFillXRect(const SkXRect&, const SkRasterClip&, SkBlitter*);
     static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    // Like AntiFillPath, but always uses analytic AA, and fills very complex paths in bands on
+    // bandExecutor unless it is null. Ignores gSkForceAnalyticAA and gSkAnalyticAAExecutor.
+    static void AnalyticAntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*,
+                                     SkExecutor* bandExecutor);
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -80,6 +89,8 @@ private:
     static void AntiFillRect(const SkRect&, const SkRegion* clip, SkBlitter*);
     static void AntiFillXRect(const SkXRect&, const SkRegion*, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*, bool forceRLE);
+    static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*, bool forceRLE,
+                             bool forceAAA, SkExecutor* bandExecutor);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -87,7 +98,10 @@ private:
     static void HairLineRgn(const SkPoint[], int count, const SkRegion*, SkBlitter*);
     static void AntiHairLineRgn(const SkPoint[], int count, const SkRegion*, SkBlitter*);
     static void AAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
-                            const SkIRect& clipBounds, bool forceRLE);
+                            const SkIRect& clipBounds, bool forceRLE, SkExecutor* bandExecutor);
+    // Whether AAAFillPath would fill path in bands, if given a bandExecutor.
+    static bool CanBandAAA(const SkPath& path, const SkIRect& pathIR, const SkIRect& clipBounds,
+                           bool forceRLE);
     static void SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
 };
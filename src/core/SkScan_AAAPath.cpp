@@ -11,7 +11,9 @@
 #include "SkBlitter.h"
 #include "SkEdge.h"
 #include "SkEdgeBuilder.h"
+#include "SkExecutor.h"
 #include "SkGeometry.h"
+#include "SkMask.h"
 #include "SkPath.h"
 #include "SkQuadClipper.h"
 #include "SkRasterClip.h"
@@ -19,6 +21,7 @@
 #include "SkScan.h"
 #include "SkScanPriv.h"
 #include "SkTSort.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 #include "SkUTF.h"
@@ -26,10 +29,15 @@
 #include <utility>
 
 #if defined(SK_DISABLE_AAA)
-void SkScan::AAAFillPath(const SkPath&, SkBlitter*, const SkIRect&, const SkIRect&, bool) {
+void SkScan::AAAFillPath(const SkPath&, SkBlitter*, const SkIRect&, const SkIRect&, bool,
+                         SkExecutor*) {
     SkDEBUGFAIL("AAA Disabled");
     return;
 }
+
+bool SkScan::CanBandAAA(const SkPath&, const SkIRect&, const SkIRect&, bool) {
+    return false;
+}
 #else
 
 /*
@@ -1848,7 +1856,8 @@ static SK_ALWAYS_INLINE void aaa_fill_path(
         int              stop_y,
         bool             pathContainedInClip,
         bool             isUsingMask,
-        bool             forceRLE) {  // forceRLE implies that SkAAClip is calling us
+        bool             forceRLE,    // forceRLE implies that SkAAClip is calling us
+        int              rowCount = 0) {  // Rows of the whole fill, if this only fills a band.
     SkASSERT(blitter);
 
     SkAnalyticEdgeBuilder builder;
@@ -1933,7 +1942,7 @@ static SK_ALWAYS_INLINE void aaa_fill_path(
 
         // We skip intersection computation if there are many points which probably already
         // give us enough fractional scan lines.
-        bool skipIntersect = path.countPoints() > (stop_y - start_y) * 2;
+        bool skipIntersect = path.countPoints() > (rowCount ? rowCount : stop_y - start_y) * 2;
 
         aaa_walk_edges(&headEdge,
                        &tailEdge,
@@ -1950,11 +1959,123 @@ static SK_ALWAYS_INLINE void aaa_fill_path(
     }
 }
 
+// Writes coverage into an A8 mask instead of blending it, so that bands of a path can be filled
+// on other threads. AAA's real blitter calls never touch a pixel twice, so writing is enough.
+class CoverageMaskBlitter : public SkBlitter {
+public:
+    explicit CoverageMaskBlitter(const SkMask& mask) : fMask(mask) {}
+
+    void blitH(int x, int y, int width) override {
+        memset(fMask.getAddr8(x, y), 0xFF, width);
+    }
+
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        uint8_t* dst = fMask.getAddr8(x, y);
+        for (int count = runs[0]; count > 0; count = runs[0]) {
+            memset(dst, antialias[0], count);
+            dst       += count;
+            runs      += count;
+            antialias += count;
+        }
+    }
+
+    void blitV(int x, int y, int height, SkAlpha alpha) override {
+        uint8_t* dst = fMask.getAddr8(x, y);
+        for (int i = 0; i < height; ++i) {
+            *dst = alpha;
+            dst += fMask.fRowBytes;
+        }
+    }
+
+    void blitRect(int x, int y, int width, int height) override {
+        uint8_t* dst = fMask.getAddr8(x, y);
+        for (int i = 0; i < height; ++i) {
+            memset(dst, 0xFF, width);
+            dst += fMask.fRowBytes;
+        }
+    }
+
+private:
+    const SkMask& fMask;
+};
+
+// Banding pays off only for paths with many edges: every band walks the whole path to build its
+// own edge list, clipped to the band.
+static constexpr int     kMinBandedPoints  = 1 << 14;
+static constexpr int     kMinBandRows      = 32;
+static constexpr int     kMaxBands         = 32;
+static constexpr int64_t kMaxBandedStorage = 1 << 24;  // Bytes of coverage held at once.
+
+bool SkScan::CanBandAAA(const SkPath&  path,
+                        const SkIRect& ir,
+                        const SkIRect& clipBounds,
+                        bool           forceRLE) {
+    // SkAAClip needs its rows in order, and inverse fills draw outside ir.
+    if (forceRLE || path.isInverseFillType() || path.countPoints() < kMinBandedPoints) {
+        return false;
+    }
+    SkIRect bounds;
+    if (!bounds.intersect(ir, clipBounds)) {
+        return false;
+    }
+    return bounds.height() >= 2 * kMinBandRows &&
+           (int64_t)bounds.width() * bounds.height() <= kMaxBandedStorage;
+}
+
+// Fills the bands of path on executor, each into its own rows of a shared coverage mask, then
+// blits the mask on this thread. The real blitter is only ever used here. Edges are clipped at the
+// seams between bands, so the rows beside a seam may differ from one fill by a level or two.
+static void aaa_fill_path_in_bands(const SkPath&  path,
+                                   SkBlitter*     blitter,
+                                   const SkIRect& ir,
+                                   const SkIRect& clipBounds,
+                                   SkExecutor*    executor) {
+    SkMask mask;
+    SkAssertResult(mask.fBounds.intersect(ir, clipBounds));
+    mask.fRowBytes = mask.fBounds.width();
+    mask.fFormat   = SkMask::kA8_Format;
+    mask.fImage    = SkMask::AllocImage(mask.computeImageSize(), SkMask::kZeroInit_Alloc);
+    SkAutoMaskFreeImage freeImage(mask.fImage);
+
+    const SkIRect& bounds    = mask.fBounds;
+    const int      bandCount = SkTMin(kMaxBands, bounds.height() / kMinBandRows);
+    const bool     isConvex  = path.isConvex();
+
+    SkTaskGroup bands(*executor);
+    bands.batch(bandCount, [&](int i) {
+        SkIRect band = bounds;
+        band.fTop    = bounds.fTop + bounds.height() *  i      / bandCount;
+        band.fBottom = bounds.fTop + bounds.height() * (i + 1) / bandCount;
+
+        // The edge builder clips the path to the band, so each band only sorts and walks the
+        // edges that cross it.
+        CoverageMaskBlitter coverage(mask);
+        if (isConvex) {
+            RunBasedAdditiveBlitter additiveBlitter(&coverage, ir, band, false);
+            aaa_fill_path(path, band, &additiveBlitter, band.fTop, band.fBottom,
+                          false, false, false, bounds.height());
+        } else {
+            SafeRLEAdditiveBlitter additiveBlitter(&coverage, ir, band, false);
+            aaa_fill_path(path, band, &additiveBlitter, band.fTop, band.fBottom,
+                          false, false, false, bounds.height());
+        }
+    });
+    bands.wait();
+
+    blitter->blitMask(mask, bounds);
+}
+
 void SkScan::AAAFillPath(const SkPath&  path,
                          SkBlitter*     blitter,
                          const SkIRect& ir,
                          const SkIRect& clipBounds,
-                         bool           forceRLE) {
+                         bool           forceRLE,
+                         SkExecutor*    bandExecutor) {
+    if (bandExecutor && CanBandAAA(path, ir, clipBounds, forceRLE)) {
+        aaa_fill_path_in_bands(path, blitter, ir, clipBounds, bandExecutor);
+        return;
+    }
+
     bool containedInClip = clipBounds.contains(ir);
     bool isInverse       = path.isInverseFillType();
 
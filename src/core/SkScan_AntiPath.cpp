@@ -636,11 +636,12 @@ static void compute_complexity(const SkPath& path, SkScalar& avgLength, SkScalar
     }
 }
 
-static bool ShouldUseAAA(const SkPath& path, SkScalar avgLength, SkScalar complexity) {
+static bool ShouldUseAAA(const SkPath& path, SkScalar avgLength, SkScalar complexity,
+                         bool forceAAA) {
 #if defined(SK_DISABLE_AAA)
     return false;
 #else
-    if (gSkForceAnalyticAA) {
+    if (forceAAA) {
         return true;
     }
     if (!gSkUseAnalyticAA) {
@@ -714,6 +715,12 @@ static int rect_overflows_short_shift(SkIRect rect, int shift) {
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
                           SkBlitter* blitter, bool forceRLE) {
+    AntiFillPath(path, origClip, blitter, forceRLE, gSkForceAnalyticAA, gSkAnalyticAAExecutor);
+}
+
+void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
+                          SkBlitter* blitter, bool forceRLE, bool forceAAA,
+                          SkExecutor* bandExecutor) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -786,10 +793,11 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
     SkScalar avgLength, complexity;
     compute_complexity(path, avgLength, complexity);
 
-    if (ShouldUseAAA(path, avgLength, complexity)) {
-        // Do not use AAA if path is too complicated:
-        // there won't be any speedup or significant visual improvement.
-        SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
+    // Do not use AAA if path is too complicated: there won't be any speedup or significant visual
+    // improvement. The exception is when AAA can fill it in bands on other threads.
+    if (ShouldUseAAA(path, avgLength, complexity, forceAAA) ||
+        (bandExecutor && CanBandAAA(path, ir, clipRgn->getBounds(), forceRLE))) {
+        SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE, bandExecutor);
     } else {
         SkScan::SAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
     }
@@ -836,3 +844,21 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip, SkBlitte
         AntiFillPath(path, tmp, &aaBlitter, true); // SkAAClipBlitter can blitMask, why forceRLE?
     }
 }
+
+void SkScan::AnalyticAntiFillPath(const SkPath& path, const SkRasterClip& clip,
+                                  SkBlitter* blitter, SkExecutor* bandExecutor) {
+    if (clip.isEmpty() || !path.isFinite()) {
+        return;
+    }
+
+    if (clip.isBW()) {
+        AntiFillPath(path, clip.bwRgn(), blitter, false, true, bandExecutor);
+    } else {
+        SkRegion        tmp;
+        SkAAClipBlitter aaBlitter;
+
+        tmp.setRect(clip.getBounds());
+        aaBlitter.init(blitter, &clip.aaRgn());
+        AntiFillPath(path, tmp, &aaBlitter, true, true, bandExecutor);
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStreamingRecorder.h"
+
+#include "SkCanvas.h"
+#include "SkRecordDraw.h"
+
+SkStreamingRecorder::SkStreamingRecorder(SkCanvas* dst, const SkRect& bounds,
+                                         SkExecutor* executor)
+    : SkStreamingRecorder(dst, bounds, executor, Options()) {}
+
+SkStreamingRecorder::SkStreamingRecorder(SkCanvas* dst, const SkRect& bounds,
+                                         SkExecutor* executor, const Options& options)
+    : fDst(dst)
+    , fOptions(options)
+    , fInitialCTM(dst->getTotalMatrix())
+    , fSaveCount(dst->save())
+    , fRecord(sk_make_sp<SkRecord>())
+    , fRecorder(fRecord.get(), bounds)
+    , fExecutor(executor ? *executor : SkExecutor::GetDefault())
+    , fPlayback(fExecutor) {
+    SkASSERT(fOptions.fOpsPerChunk > 0);
+    fRecorder.setListener(this);
+}
+
+SkStreamingRecorder::~SkStreamingRecorder() {
+    this->finish();
+}
+
+SkCanvas* SkStreamingRecorder::getRecordingCanvas() {
+    return fFinished ? nullptr : &fRecorder;
+}
+
+void SkStreamingRecorder::didAppend(SkRecorder* recorder) {
+    SkASSERT(recorder == &fRecorder);
+    if (fRecord->count() >= fOptions.fOpsPerChunk ||
+        fRecord->bytesUsed() >= fOptions.fMemoryLimit / 4) {
+        this->submitChunk();
+    }
+}
+
+void SkStreamingRecorder::submitChunk() {
+    if (0 == fRecord->count()) {
+        return;
+    }
+
+    Chunk chunk;
+    chunk.fBytes = fRecord->bytesUsed();
+    chunk.fRecord = std::move(fRecord);
+    fRecord = sk_make_sp<SkRecord>();
+    chunk.fDrawables = fRecorder.switchRecord(fRecord.get());
+
+    fMutex.acquire();
+    // Always let one chunk through, or an oversized op could never be drawn.
+    while (fQueuedBytes > 0 && fQueuedBytes + chunk.fBytes > fOptions.fMemoryLimit) {
+        fRecorderWaiting = true;
+        fMutex.release();
+        // Help the executor along, as SkTaskGroup::wait() does: this thread may be the only one
+        // that can run drain().
+        while (!fChunkDrawn.try_wait()) {
+            fExecutor.borrow();
+        }
+        fMutex.acquire();
+    }
+    fQueuedBytes += chunk.fBytes;
+    fQueue.push_back(std::move(chunk));
+    const bool startDraining = !fDraining;
+    fDraining = true;
+    fMutex.release();
+
+    if (startDraining) {
+        fPlayback.add([this] { this->drain(); });
+    }
+}
+
+void SkStreamingRecorder::drain() {
+    fMutex.acquire();
+    while (!fQueue.empty()) {
+        Chunk chunk = std::move(fQueue.front());
+        fQueue.pop_front();
+        fMutex.release();
+
+        this->drawChunk(chunk);
+        const size_t bytes = chunk.fBytes;
+        chunk = Chunk();    // Free the chunk before we count it as gone.
+
+        fMutex.acquire();
+        fQueuedBytes -= bytes;
+        if (fRecorderWaiting) {
+            fRecorderWaiting = false;
+            fChunkDrawn.signal();
+        }
+    }
+    fDraining = false;
+    fMutex.release();
+}
+
+void SkStreamingRecorder::drawChunk(const Chunk& chunk) {
+    SkDrawable* const* drawables = chunk.fDrawables ? chunk.fDrawables->begin() : nullptr;
+    const int drawableCount = chunk.fDrawables ? chunk.fDrawables->count() : 0;
+
+    // Every chunk plays back relative to the matrix dst had when recording began, so that
+    // SetMatrix ops land in the same place no matter which chunk they're in.
+    SkRecords::Draw draw(fDst, nullptr, drawables, drawableCount, &fInitialCTM);
+    for (int i = 0; i < chunk.fRecord->count(); i++) {
+        chunk.fRecord->visit(i, draw);
+    }
+}
+
+void SkStreamingRecorder::finish() {
+    if (fFinished) {
+        return;
+    }
+    fFinished = true;
+    this->submitChunk();
+
+    fPlayback.wait();
+    SkASSERT(fQueue.empty() && 0 == fQueuedBytes);
+
+    fRecorder.setListener(nullptr);
+    fDst->restoreToCount(fSaveCount);
+}
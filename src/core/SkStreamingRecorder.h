@@ -0,0 +1,97 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStreamingRecorder_DEFINED
+#define SkStreamingRecorder_DEFINED
+
+#include "SkMatrix.h"
+#include "SkMutex.h"
+#include "SkRecord.h"
+#include "SkRecorder.h"
+#include "SkSemaphore.h"
+#include "SkTaskGroup.h"
+
+#include <deque>
+#include <memory>
+
+class SkCanvas;
+class SkExecutor;
+
+/**
+ *  Records drawing commands and plays them back into another canvas while recording continues,
+ *  without ever holding the whole recording in memory.
+ *
+ *  Ops are recorded into a sequence of small SkRecords ("chunks"). Each full chunk is queued and
+ *  drawn into the destination canvas by a task on the executor, then freed. If the chunks waiting
+ *  to be drawn would use more than the memory limit, the recording thread waits until the
+ *  playback catches up, running the executor's queued work meanwhile as SkTaskGroup::wait()
+ *  does, so the recording thread may itself be one of the executor's threads.
+ *
+ *  The destination canvas belongs to the playback task until finish() returns, so it must not be
+ *  used by anyone else in the meantime. Drawables are drawn on the playback task as well.
+ */
+class SkStreamingRecorder : SkRecorder::Listener {
+public:
+    struct Options {
+        // Approximate bound on the bytes of recorded ops that have not yet been drawn.
+        size_t fMemoryLimit = 16 * 1024 * 1024;
+        // A chunk is queued when it has this many ops, or uses a quarter of fMemoryLimit.
+        int    fOpsPerChunk = 1024;
+    };
+
+    // If executor is null, chunks are drawn on SkExecutor::GetDefault().
+    SkStreamingRecorder(SkCanvas* dst, const SkRect& bounds, SkExecutor* executor = nullptr);
+    SkStreamingRecorder(SkCanvas* dst, const SkRect& bounds, SkExecutor* executor,
+                        const Options& options);
+
+    // Calls finish().
+    ~SkStreamingRecorder() override;
+
+    // Draw into this canvas on a single thread. Returns null after finish().
+    SkCanvas* getRecordingCanvas();
+
+    // Queues the current chunk and blocks until everything recorded has been drawn into dst.
+    // dst's save stack is then restored to where it was when recording began.
+    void finish();
+
+private:
+    struct Chunk {
+        sk_sp<SkRecord>                 fRecord;
+        std::unique_ptr<SkDrawableList> fDrawables;
+        size_t                          fBytes = 0;
+    };
+
+    void didAppend(SkRecorder*) override;
+
+    // Hands the current chunk to the playback task, blocking while we're over the memory limit.
+    void submitChunk();
+
+    // Runs on the executor: draws queued chunks until there are none left.
+    void drain();
+    void drawChunk(const Chunk&);
+
+    SkCanvas*             fDst;
+    const Options         fOptions;
+    const SkMatrix        fInitialCTM;
+    const int             fSaveCount;
+
+    sk_sp<SkRecord>       fRecord;      // The chunk being recorded.
+    SkRecorder            fRecorder;
+    bool                  fFinished = false;
+
+    SkExecutor&           fExecutor;
+    SkTaskGroup           fPlayback;    // Runs drain() on fExecutor.
+
+    SkMutex               fMutex;       // Guards everything below.
+    std::deque<Chunk>     fQueue;
+    size_t                fQueuedBytes = 0;    // Includes the chunk being drawn, if any.
+    bool                  fDraining = false;
+    bool                  fRecorderWaiting = false;
+    SkSemaphore           fChunkDrawn;  // Signaled by drain() when fRecorderWaiting.
+};
+
+#endif//SkStreamingRecorder_DEFINED
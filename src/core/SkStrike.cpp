@@ -7,11 +7,13 @@
 
 #include "SkStrike.h"
 
+#include "SkExecutor.h"
 #include "SkGraphics.h"
 #include "SkMakeUnique.h"
 #include "SkMutex.h"
 #include "SkOnce.h"
 #include "SkPath.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTypeface.h"
 #include <cctype>
@@ -36,6 +38,13 @@ SkStrike::SkStrike(
     fMemoryUsed = sizeof(*this);
 }
 
+void SkStrike::setPersistentStrike(sk_sp<SkPersistentGlyphCache> cache,
+                                   SkPersistentGlyphCache::Strike* strike) {
+    SkASSERT(fGlyphMap.count() == 0);
+    fPersistentCache = std::move(cache);
+    fPersistentStrike = strike;
+}
+
 const SkDescriptor& SkStrike::getDescriptor() const {
     return *fDesc.getDesc();
 }
@@ -107,20 +116,32 @@ SkGlyph* SkStrike::lookupByPackedGlyphID(SkPackedGlyphID packedGlyphID, MetricsT
                 fScalerContext->getAdvance(glyphPtr);
                 break;
             case kFull_MetricsType:
-                fScalerContext->getMetrics(glyphPtr);
+                this->getMetrics(glyphPtr);
                 break;
         }
     } else {
         // Glyph is present in strike. Make sure the glyph has the right data.
 
         if (type == kFull_MetricsType && glyphPtr->isJustAdvance()) {
-            fScalerContext->getMetrics(glyphPtr);
+            this->getMetrics(glyphPtr);
         }
     }
 
     return glyphPtr;
 }
 
+void SkStrike::getMetrics(SkGlyph* glyph) {
+    if (fPersistentStrike) {
+        if (fPersistentStrike->findMetrics(glyph)) {
+            return;
+        }
+        fScalerContext->getMetrics(glyph);
+        fPersistentStrike->addMetrics(*glyph);
+        return;
+    }
+    fScalerContext->getMetrics(glyph);
+}
+
 const void* SkStrike::findImage(const SkGlyph& glyph) {
     if (glyph.fWidth > 0 && glyph.fWidth < kMaxGlyphWidth) {
         if (nullptr == glyph.fImage) {
@@ -128,7 +149,17 @@ const void* SkStrike::findImage(const SkGlyph& glyph) {
             size_t  size = const_cast<SkGlyph&>(glyph).allocImage(&fAlloc);
             // check that alloc() actually succeeded
             if (glyph.fImage) {
-                fScalerContext->getImage(glyph);
+                // Copying a persisted image is much cheaper than rasterizing it again.
+                const void* persisted = fPersistentStrike ? fPersistentStrike->findImage(glyph)
+                                                          : nullptr;
+                if (persisted) {
+                    memcpy(glyph.fImage, persisted, size);
+                } else {
+                    fScalerContext->getImage(glyph);
+                    if (fPersistentStrike) {
+                        fPersistentStrike->addImage(glyph);
+                    }
+                }
                 // TODO: the scaler may have changed the maskformat during
                 // getImage (e.g. from AA or LCD to BW) which means we may have
                 // overallocated the buffer. Check if the new computedImageSize
@@ -155,6 +186,95 @@ void SkStrike::initializeImage(const volatile void* data, size_t size, SkGlyph*
     }
 }
 
+void SkStrike::initializeImageInPlace(sk_sp<SkData> backing, const void* image,
+                                      SkGlyph* glyph) {
+    SkASSERT(!glyph->fImage);
+    SkASSERT(backing && backing->bytes() <= image);
+
+    if (glyph->fWidth > 0 && glyph->fWidth < kMaxGlyphWidth) {
+        glyph->fImage = const_cast<void*>(image);
+        // Images from the same backing usually come together.
+        if (fImageBackings.empty() || fImageBackings.back() != backing) {
+            fImageBackings.push_back(std::move(backing));
+        }
+        // The image is not ours, but count it as if it were so that the strike cache still
+        // purges this strike when it should.
+        fMemoryUsed += glyph->computeImageSize();
+    }
+}
+
+// Fewer glyphs than this are not worth another scaler context.
+static constexpr int kMinPrefetchGlyphsPerTask = 16;
+static constexpr int kMaxPrefetchTasks = 8;
+
+void SkStrike::prefetchImages(SkSpan<const SkGlyphID> glyphIDs, SkSpan<const SkPoint> positions,
+                              SkExecutor* executor) {
+    SkASSERT(positions.empty() || positions.size() == glyphIDs.size());
+
+    // Metrics, allocation and bookkeeping stay on this thread; only rasterizing is spread out.
+    SkTDArray<SkGlyph*> missing;
+    for (size_t i = 0; i < glyphIDs.size(); ++i) {
+        SkPoint position = positions.empty() ? SkPoint{0, 0} : positions[i];
+        if (!SkScalarsAreFinite(position.x(), position.y())) {
+            continue;
+        }
+        SkGlyph* glyph = const_cast<SkGlyph*>(&this->getGlyphMetrics(glyphIDs[i], position));
+        if (glyph->fImage != nullptr || glyph->fWidth == 0 || glyph->fWidth >= kMaxGlyphWidth) {
+            continue;
+        }
+        // Copying a persisted image is cheaper than handing it to another thread.
+        if (fPersistentStrike && fPersistentStrike->findImage(*glyph)) {
+            this->findImage(*glyph);
+            continue;
+        }
+        // Allocating marks the glyph, so that repeats of it are skipped.
+        glyph->allocImage(&fAlloc);
+        if (glyph->fImage) {
+            missing.push_back(glyph);
+        }
+    }
+
+    const int count = missing.count();
+    int taskCount = SkTMin(kMaxPrefetchTasks, count / kMinPrefetchGlyphsPerTask);
+
+    if (taskCount > 1) {
+        while (fCanMakeConcurrentContexts && SkToInt(fConcurrentContexts.size()) < taskCount) {
+            auto context = fScalerContext->makeConcurrentContext(this->getDescriptor());
+            if (!context) {
+                fCanMakeConcurrentContexts = false;
+                break;
+            }
+            fConcurrentContexts.push_back(std::move(context));
+        }
+        taskCount = SkTMin(taskCount, SkToInt(fConcurrentContexts.size()));
+    }
+
+    auto generate = [&](SkScalerContext* context, int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            SkDEBUGCODE(SkMask::Format oldFormat = (SkMask::Format)missing[i]->fMaskFormat);
+            context->getImage(*missing[i]);
+            SkASSERT(oldFormat == missing[i]->fMaskFormat);
+        }
+    };
+    if (taskCount > 1) {
+        SkTaskGroup tasks(executor ? *executor : SkExecutor::GetDefault());
+        tasks.batch(taskCount, [&](int task) {
+            generate(fConcurrentContexts[task].get(), count * task / taskCount,
+                     count * (task + 1) / taskCount);
+        });
+        tasks.wait();
+    } else {
+        generate(fScalerContext.get(), 0, count);
+    }
+
+    for (SkGlyph* glyph : missing) {
+        if (fPersistentStrike) {
+            fPersistentStrike->addImage(*glyph);
+        }
+        fMemoryUsed += glyph->computeImageSize();
+    }
+}
+
 const SkPath* SkStrike::findPath(const SkGlyph& glyph) {
 
     if (!glyph.isEmpty()) {
@@ -166,7 +286,23 @@ const SkPath* SkStrike::findPath(const SkGlyph& glyph) {
             return nullptr;
         }
 
-        const_cast<SkGlyph&>(glyph).addPath(fScalerContext.get(), &fAlloc);
+        SkPath persisted;
+        bool hasPath;
+        if (fPersistentStrike &&
+            fPersistentStrike->findPath(glyph.getPackedID(), &persisted, &hasPath)) {
+            SkGlyph::PathData* pathData = fAlloc.make<SkGlyph::PathData>();
+            const_cast<SkGlyph&>(glyph).fPathData = pathData;
+            pathData->fHasPath = hasPath;
+            if (hasPath) {
+                pathData->fPath = std::move(persisted);
+                pathData->fPath.updateBoundsCache();
+            }
+        } else {
+            const_cast<SkGlyph&>(glyph).addPath(fScalerContext.get(), &fAlloc);
+            if (fPersistentStrike && glyph.fPathData != nullptr) {
+                fPersistentStrike->addPath(glyph.getPackedID(), glyph.path());
+            }
+        }
         if (glyph.fPathData != nullptr) {
             fMemoryUsed += compute_path_size(glyph.fPathData->fPath);
         }
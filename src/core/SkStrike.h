@@ -14,11 +14,15 @@
 #include "SkGlyph.h"
 #include "SkGlyphRunPainter.h"
 #include "SkPaint.h"
+#include "SkPersistentGlyphCache.h"
 #include "SkTHash.h"
 #include "SkScalerContext.h"
 #include "SkStrikeInterface.h"
 #include "SkTemplates.h"
 #include <memory>
+#include <vector>
+
+class SkExecutor;
 
 /** \class SkGlyphCache
 
@@ -82,6 +86,24 @@ public:
      */
     void initializeImage(const volatile void* data, size_t size, SkGlyph*);
 
+    /** Points the image of the glyph at |image|, inside |backing|, instead of copying it. The
+        strike keeps |backing| alive, and never writes to the image.
+     */
+    void initializeImageInPlace(sk_sp<SkData> backing, const void* image, SkGlyph*);
+
+    /** Generates the images of those glyphs in glyphIDs that don't have one yet, so that
+        findImage() has them at hand. positions are the glyphs' device positions, and may be
+        empty if the strike is not subpixel. If the scaler context can make concurrent contexts,
+        the glyphs are rasterized in parallel on executor, or SkExecutor::GetDefault() if it is
+        null; otherwise they are rasterized here, one after another. The concurrent contexts are
+        made on first use and kept with the strike.
+
+        Nothing in the glyph run drawing path calls this yet; callers that know a whole document's
+        glyphs up front, like the SkGlyphCacheFirstPaint benches, call it themselves.
+    */
+    void prefetchImages(SkSpan<const SkGlyphID> glyphIDs, SkSpan<const SkPoint> positions,
+                        SkExecutor* executor = nullptr);
+
     /** If the advance axis intersects the glyph's path, append the positions scaled and offset
         to the array (if non-null), and set the count to the updated array length.
     */
@@ -147,6 +169,11 @@ public:
 
     SkScalerContext* getScalerContext() const { return fScalerContext.get(); }
 
+    /** Look up glyphs in strike before asking the scaler context for them, and add whatever the
+        scaler context produces to it. Must be called before any glyphs are looked up. */
+    void setPersistentStrike(sk_sp<SkPersistentGlyphCache> cache,
+                             SkPersistentGlyphCache::Strike* strike);
+
 #ifdef SK_DEBUG
     void forceValidate() const;
     void validate() const;
@@ -205,10 +232,17 @@ private:
     static const SkGlyph::Intercept* MatchBounds(const SkGlyph* glyph,
                                                  const SkScalar bounds[2]);
 
+    void getMetrics(SkGlyph* glyph);
+
     const SkAutoDescriptor fDesc;
     const std::unique_ptr<SkScalerContext> fScalerContext;
     SkFontMetrics          fFontMetrics;
 
+    // For prefetchImages(). Opening a context may be costlier than rasterizing a run, so each is
+    // kept once made.
+    std::vector<std::unique_ptr<SkScalerContext>> fConcurrentContexts;
+    bool                   fCanMakeConcurrentContexts{true};
+
     class GlyphMapHashTraits {
     public:
         static SkPackedGlyphID GetKey(const SkGlyph* glyph) {
@@ -236,6 +270,13 @@ private:
 
     const bool              fIsSubpixel;
     const SkAxisAlignment   fAxisAlignment;
+
+    // Memory that glyph images point into, from initializeImageInPlace.
+    std::vector<sk_sp<SkData>>      fImageBackings;
+
+    // Optional; fPersistentCache keeps fPersistentStrike alive.
+    sk_sp<SkPersistentGlyphCache>   fPersistentCache;
+    SkPersistentGlyphCache::Strike* fPersistentStrike{nullptr};
 };
 
 #endif  // SkStrike_DEFINED
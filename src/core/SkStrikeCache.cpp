@@ -61,6 +61,7 @@ public:
     SkStrikeCache* const            fStrikeCache;
     Node*                           fNext{nullptr};
     Node*                           fPrev{nullptr};
+    uint64_t                        fLastUse{0};     // When it was last attached to a shard.
     SkStrike                        fStrike;
     std::unique_ptr<SkStrikePinner> fPinner;
 };
@@ -127,11 +128,13 @@ bool operator == (decltype(nullptr), const SkStrikeCache::ExclusiveStrikePtr& rh
 }
 
 SkStrikeCache::~SkStrikeCache() {
-    Node* node = fHead;
-    while (node) {
-        Node* next = node->fNext;
-        delete node;
-        node = next;
+    for (Shard& shard : fShards) {
+        Node* node = shard.fHead;
+        while (node) {
+            Node* next = node->fNext;
+            delete node;
+            node = next;
+        }
     }
 }
 
@@ -308,13 +311,25 @@ void SkStrikeCache::attachNode(Node* node) {
     if (node == nullptr) {
         return;
     }
-    SkAutoExclusive ac(fLock);
-
-    this->validate();
     node->fStrike.validate();
 
-    this->internalAttachToHead(node);
-    this->internalPurge();
+    {
+        Shard& shard = this->shardFor(node->fStrike.getDescriptor());
+        SkAutoExclusive ac(shard.fLock);
+        shard.validate();
+        this->attachToHead(&shard, node);
+    }
+
+    // Checking the budget is lock free, so only threads that push us over it pay for a purge.
+    // If another thread is already purging, leave it to that thread.
+    if ((fTotalMemoryUsed.load(std::memory_order_relaxed) >
+                fCacheSizeLimit.load(std::memory_order_relaxed) ||
+         fCacheCount.load(std::memory_order_relaxed) >
+                fCacheCountLimit.load(std::memory_order_relaxed)) &&
+        fPurgeLock.tryAcquire()) {
+        this->internalPurge(0);
+        fPurgeLock.release();
+    }
 }
 
 SkExclusiveStrikePtr SkStrikeCache::findStrikeExclusive(const SkDescriptor& desc) {
@@ -322,11 +337,12 @@ SkExclusiveStrikePtr SkStrikeCache::findStrikeExclusive(const SkDescriptor& desc
 }
 
 auto SkStrikeCache::findAndDetachStrike(const SkDescriptor& desc) -> Node* {
-    SkAutoExclusive ac(fLock);
+    Shard& shard = this->shardFor(desc);
+    SkAutoExclusive ac(shard.fLock);
 
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
+    for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
         if (node->fStrike.getDescriptor() == desc) {
-            this->internalDetachCache(node);
+            this->detach(&shard, node);
             return node;
         }
     }
@@ -363,28 +379,30 @@ static bool loose_compare(const SkDescriptor& lhs, const SkDescriptor& rhs) {
 
 bool SkStrikeCache::desperationSearchForImage(const SkDescriptor& desc, SkGlyph* glyph,
                                               SkStrike* targetCache) {
-    SkAutoExclusive ac(fLock);
-
     SkGlyphID glyphID = glyph->getGlyphID();
     SkFixed targetSubX = glyph->getSubXFixed(),
             targetSubY = glyph->getSubYFixed();
 
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
-        if (loose_compare(node->fStrike.getDescriptor(), desc)) {
-            auto targetGlyphID = SkPackedGlyphID(glyphID, targetSubX, targetSubY);
-            if (node->fStrike.isGlyphCached(glyphID, targetSubX, targetSubY)) {
-                SkGlyph* fallback = node->fStrike.getRawGlyphByID(targetGlyphID);
-                // This desperate-match node may disappear as soon as we drop fLock, so we
-                // need to copy the glyph from node into this strike, including a
-                // deep copy of the mask.
-                targetCache->initializeGlyphFromFallback(glyph, *fallback);
-                return true;
-            }
+    // A loose match may hash to any shard.
+    for (Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            if (loose_compare(node->fStrike.getDescriptor(), desc)) {
+                auto targetGlyphID = SkPackedGlyphID(glyphID, targetSubX, targetSubY);
+                if (node->fStrike.isGlyphCached(glyphID, targetSubX, targetSubY)) {
+                    SkGlyph* fallback = node->fStrike.getRawGlyphByID(targetGlyphID);
+                    // This desperate-match node may disappear as soon as we drop the lock, so we
+                    // need to copy the glyph from node into this strike, including a
+                    // deep copy of the mask.
+                    targetCache->initializeGlyphFromFallback(glyph, *fallback);
+                    return true;
+                }
 
-            // Look for any sub-pixel pos for this glyph, in case there is a pos mismatch.
-            if (const auto* fallback = node->fStrike.getCachedGlyphAnySubPix(glyphID)) {
-                targetCache->initializeGlyphFromFallback(glyph, *fallback);
-                return true;
+                // Look for any sub-pixel pos for this glyph, in case there is a pos mismatch.
+                if (const auto* fallback = node->fStrike.getCachedGlyphAnySubPix(glyphID)) {
+                    targetCache->initializeGlyphFromFallback(glyph, *fallback);
+                    return true;
+                }
             }
         }
     }
@@ -394,23 +412,25 @@ bool SkStrikeCache::desperationSearchForImage(const SkDescriptor& desc, SkGlyph*
 
 bool SkStrikeCache::desperationSearchForPath(
         const SkDescriptor& desc, SkGlyphID glyphID, SkPath* path) {
-    SkAutoExclusive ac(fLock);
-
     // The following is wrong there is subpixel positioning with paths...
     // Paths are only ever at sub-pixel position (0,0), so we can just try that directly rather
     // than try our packed position first then search all others on failure like for masks.
     //
     // This will have to search the sub-pixel positions too.
     // There is also a problem with accounting for cache size with shared path data.
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
-        if (loose_compare(node->fStrike.getDescriptor(), desc)) {
-            if (node->fStrike.isGlyphCached(glyphID, 0, 0)) {
-                SkGlyph* from = node->fStrike.getRawGlyphByID(SkPackedGlyphID(glyphID));
-                if (from->fPathData != nullptr) {
-                    // We can just copy the path out by value here, so no need to worry
-                    // about the lifetime of this desperate-match node.
-                    *path = from->fPathData->fPath;
-                    return true;
+    // A loose match may hash to any shard.
+    for (Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            if (loose_compare(node->fStrike.getDescriptor(), desc)) {
+                if (node->fStrike.isGlyphCached(glyphID, 0, 0)) {
+                    SkGlyph* from = node->fStrike.getRawGlyphByID(SkPackedGlyphID(glyphID));
+                    if (from->fPathData != nullptr) {
+                        // We can just copy the path out by value here, so no need to worry
+                        // about the lifetime of this desperate-match node.
+                        *path = from->fPathData->fPath;
+                        return true;
+                    }
                 }
             }
         }
@@ -443,34 +463,60 @@ auto SkStrikeCache::createStrike(
         std::unique_ptr<SkScalerContext> scaler,
         SkFontMetrics* maybeMetrics,
         std::unique_ptr<SkStrikePinner> pinner) -> Node* {
+    // Strikes filled in from elsewhere (e.g. the remote glyph cache) don't use the persistent
+    // cache; their scaler contexts can't produce glyphs.
+    sk_sp<SkPersistentGlyphCache> persistentCache;
+    SkPersistentGlyphCache::Strike* persistentStrike = nullptr;
+    if (maybeMetrics == nullptr && pinner == nullptr) {
+        {
+            SkAutoExclusive lock(fPersistentCacheLock);
+            persistentCache = fPersistentCache;
+        }
+        if (persistentCache) {
+            persistentStrike = persistentCache->findOrCreateStrike(desc, *scaler->getTypeface());
+        }
+    }
+
     SkFontMetrics fontMetrics;
     if (maybeMetrics != nullptr) {
         fontMetrics = *maybeMetrics;
-    } else {
+    } else if (!persistentStrike || !persistentStrike->findFontMetrics(&fontMetrics)) {
         scaler->getFontMetrics(&fontMetrics);
+        if (persistentStrike) {
+            persistentStrike->addFontMetrics(fontMetrics);
+        }
     }
 
-    return new Node{this, desc, std::move(scaler), fontMetrics, std::move(pinner)};
+    Node* node = new Node{this, desc, std::move(scaler), fontMetrics, std::move(pinner)};
+    if (persistentStrike) {
+        node->fStrike.setPersistentStrike(std::move(persistentCache), persistentStrike);
+    }
+    return node;
+}
+
+void SkStrikeCache::SetPersistentGlyphCache(sk_sp<SkPersistentGlyphCache> cache) {
+    GlobalStrikeCache()->setPersistentGlyphCache(std::move(cache));
+}
+
+void SkStrikeCache::setPersistentGlyphCache(sk_sp<SkPersistentGlyphCache> cache) {
+    SkAutoExclusive lock(fPersistentCacheLock);
+    fPersistentCache = std::move(cache);
 }
 
 void SkStrikeCache::purgeAll() {
-    SkAutoExclusive ac(fLock);
-    this->internalPurge(fTotalMemoryUsed);
+    this->purge(fTotalMemoryUsed.load());
 }
 
 size_t SkStrikeCache::getTotalMemoryUsed() const {
-    SkAutoExclusive ac(fLock);
-    return fTotalMemoryUsed;
+    return fTotalMemoryUsed.load();
 }
 
 int SkStrikeCache::getCacheCountUsed() const {
-    SkAutoExclusive ac(fLock);
-    return fCacheCount;
+    return fCacheCount.load();
 }
 
 int SkStrikeCache::getCacheCountLimit() const {
-    SkAutoExclusive ac(fLock);
-    return fCacheCountLimit;
+    return fCacheCountLimit.load();
 }
 
 size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
@@ -479,17 +525,13 @@ size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
         newLimit = minLimit;
     }
 
-    SkAutoExclusive ac(fLock);
-
-    size_t prevLimit = fCacheSizeLimit;
-    fCacheSizeLimit = newLimit;
-    this->internalPurge();
+    size_t prevLimit = fCacheSizeLimit.exchange(newLimit);
+    this->purge();
     return prevLimit;
 }
 
 size_t  SkStrikeCache::getCacheSizeLimit() const {
-    SkAutoExclusive ac(fLock);
-    return fCacheSizeLimit;
+    return fCacheSizeLimit.load();
 }
 
 int SkStrikeCache::setCacheCountLimit(int newCount) {
@@ -497,17 +539,13 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoExclusive ac(fLock);
-
-    int prevCount = fCacheCountLimit;
-    fCacheCountLimit = newCount;
-    this->internalPurge();
+    int prevCount = fCacheCountLimit.exchange(newCount);
+    this->purge();
     return prevCount;
 }
 
 int SkStrikeCache::getCachePointSizeLimit() const {
-    SkAutoExclusive ac(fLock);
-    return fPointSizeLimit;
+    return fPointSizeLimit.load();
 }
 
 int SkStrikeCache::setCachePointSizeLimit(int newLimit) {
@@ -515,41 +553,47 @@ int SkStrikeCache::setCachePointSizeLimit(int newLimit) {
         newLimit = 0;
     }
 
-    SkAutoExclusive ac(fLock);
-
-    int prevLimit = fPointSizeLimit;
-    fPointSizeLimit = newLimit;
-    return prevLimit;
+    return fPointSizeLimit.exchange(newLimit);
 }
 
 void SkStrikeCache::forEachStrike(std::function<void(const SkStrike&)> visitor) const {
-    SkAutoExclusive ac(fLock);
+    for (const Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
 
-    this->validate();
+        shard.validate();
 
-    for (Node* node = this->internalGetHead(); node != nullptr; node = node->fNext) {
-        visitor(node->fStrike);
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            visitor(node->fStrike);
+        }
     }
 }
 
+size_t SkStrikeCache::purge(size_t minBytesNeeded) {
+    SkAutoExclusive ac(fPurgeLock);
+    return this->internalPurge(minBytesNeeded);
+}
+
 size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
-    this->validate();
+    const size_t totalMemoryUsed = fTotalMemoryUsed.load(),
+                 cacheSizeLimit  = fCacheSizeLimit.load();
+    const int    cacheCount      = fCacheCount.load(),
+                 cacheCountLimit = fCacheCountLimit.load();
 
     size_t bytesNeeded = 0;
-    if (fTotalMemoryUsed > fCacheSizeLimit) {
-        bytesNeeded = fTotalMemoryUsed - fCacheSizeLimit;
+    if (totalMemoryUsed > cacheSizeLimit) {
+        bytesNeeded = totalMemoryUsed - cacheSizeLimit;
     }
     bytesNeeded = SkTMax(bytesNeeded, minBytesNeeded);
     if (bytesNeeded) {
         // no small purges!
-        bytesNeeded = SkTMax(bytesNeeded, fTotalMemoryUsed >> 2);
+        bytesNeeded = SkTMax(bytesNeeded, totalMemoryUsed >> 2);
     }
 
     int countNeeded = 0;
-    if (fCacheCount > fCacheCountLimit) {
-        countNeeded = fCacheCount - fCacheCountLimit;
+    if (cacheCount > cacheCountLimit) {
+        countNeeded = cacheCount - cacheCountLimit;
         // no small purges!
-        countNeeded = SkMax32(countNeeded, fCacheCount >> 2);
+        countNeeded = SkMax32(countNeeded, cacheCount >> 2);
     }
 
     // early exit
@@ -560,24 +604,33 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
     size_t  bytesFreed = 0;
     int     countFreed = 0;
 
-    // Start at the tail and proceed backwards deleting; the list is in LRU
-    // order, with unimportant entries at the tail.
-    Node* node = this->internalGetTail();
-    while (node != nullptr && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
-        Node* prev = node->fPrev;
+    // Approximate a global LRU: each step evicts the least recently used strike among the tails
+    // of all the shards. Shards are locked one at a time, so a strike may be used again between
+    // finding the oldest shard and evicting from it; then that shard's new oldest strike goes.
+    while (bytesFreed < bytesNeeded || countFreed < countNeeded) {
+        Shard*   oldestShard = nullptr;
+        uint64_t oldestUse   = UINT64_MAX;
+        for (Shard& shard : fShards) {
+            SkAutoExclusive ac(shard.fLock);
+            Node* node = shard.internalOldestDeletable();
+            if (node && node->fLastUse < oldestUse) {
+                oldestShard = &shard;
+                oldestUse   = node->fLastUse;
+            }
+        }
+        if (!oldestShard) {
+            break;
+        }
 
-        // Only delete if the strike is not pinned.
-        if (node->fPinner == nullptr || node->fPinner->canDelete()) {
+        SkAutoExclusive ac(oldestShard->fLock);
+        if (Node* node = oldestShard->internalOldestDeletable()) {
             bytesFreed += node->fStrike.getMemoryUsed();
             countFreed += 1;
-            this->internalDetachCache(node);
+            this->detach(oldestShard, node);
             delete node;
         }
-        node = prev;
     }
 
-    this->validate();
-
 #ifdef SPEW_PURGE_STATUS
     if (countFreed) {
         SkDebugf("purging %dK from font cache [%d entries]\n",
@@ -588,7 +641,20 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
     return bytesFreed;
 }
 
-void SkStrikeCache::internalAttachToHead(Node* node) {
+void SkStrikeCache::attachToHead(Shard* shard, Node* node) {
+    node->fLastUse = fUseCount.fetch_add(1, std::memory_order_relaxed);
+    shard->internalAttachToHead(node);
+    fCacheCount.fetch_add(1, std::memory_order_relaxed);
+    fTotalMemoryUsed.fetch_add(node->fStrike.getMemoryUsed(), std::memory_order_relaxed);
+}
+
+void SkStrikeCache::detach(Shard* shard, Node* node) {
+    fCacheCount.fetch_sub(1, std::memory_order_relaxed);
+    fTotalMemoryUsed.fetch_sub(node->fStrike.getMemoryUsed(), std::memory_order_relaxed);
+    shard->internalDetachCache(node);
+}
+
+void SkStrikeCache::Shard::internalAttachToHead(Node* node) {
     SkASSERT(nullptr == node->fPrev && nullptr == node->fNext);
     if (fHead) {
         fHead->fPrev = node;
@@ -604,7 +670,17 @@ void SkStrikeCache::internalAttachToHead(Node* node) {
     fTotalMemoryUsed += node->fStrike.getMemoryUsed();
 }
 
-void SkStrikeCache::internalDetachCache(Node* node) {
+auto SkStrikeCache::Shard::internalOldestDeletable() const -> Node* {
+    for (Node* node = fTail; node != nullptr; node = node->fPrev) {
+        // Pinned strikes can't be deleted.
+        if (node->fPinner == nullptr || node->fPinner->canDelete()) {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+void SkStrikeCache::Shard::internalDetachCache(Node* node) {
     SkASSERT(fCacheCount > 0);
     fCacheCount -= 1;
     fTotalMemoryUsed -= node->fStrike.getMemoryUsed();
@@ -637,7 +713,7 @@ void SkStrikeCache::validateGlyphCacheDataSize() const {
 #endif
 
 #ifdef SK_DEBUG
-void SkStrikeCache::validate() const {
+void SkStrikeCache::Shard::validate() const {
     size_t computedBytes = 0;
     int computedCount = 0;
 
@@ -653,6 +729,30 @@ void SkStrikeCache::validate() const {
     SkASSERTF(fTotalMemoryUsed == computedBytes, "fTotalMemoryUsed: %d, computedBytes: %d",
               fTotalMemoryUsed, computedBytes);
 }
+
+void SkStrikeCache::validate() const {
+    // Hold every shard lock, always taken in the same order, so the totals are consistent.
+    for (const Shard& shard : fShards) {
+        shard.fLock.acquire();
+    }
+
+    size_t computedBytes = 0;
+    int computedCount = 0;
+    for (const Shard& shard : fShards) {
+        shard.validate();
+        computedBytes += shard.fTotalMemoryUsed;
+        computedCount += shard.fCacheCount;
+    }
+
+    SkASSERTF(fCacheCount == computedCount, "fCacheCount: %d, computedCount: %d",
+              fCacheCount.load(), computedCount);
+    SkASSERTF(fTotalMemoryUsed == computedBytes, "fTotalMemoryUsed: %d, computedBytes: %d",
+              fTotalMemoryUsed.load(), computedBytes);
+
+    for (const Shard& shard : fShards) {
+        shard.fLock.release();
+    }
+}
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -8,10 +8,12 @@
 #ifndef SkStrikeCache_DEFINED
 #define SkStrikeCache_DEFINED
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "SkDescriptor.h"
+#include "SkPersistentGlyphCache.h"
 #include "SkStrike.h"
 #include "SkSpinlock.h"
 #include "SkTemplates.h"
@@ -141,6 +143,11 @@ public:
     static std::unique_ptr<SkScalerContext> CreateScalerContext(
             const SkDescriptor&, const SkScalerContextEffects&, const SkTypeface&);
 
+    // Strikes created after this call look up their glyphs in cache before rasterizing them,
+    // and add what they rasterize to it. Pass null to stop using a persistent cache.
+    static void SetPersistentGlyphCache(sk_sp<SkPersistentGlyphCache> cache);
+    void setPersistentGlyphCache(sk_sp<SkPersistentGlyphCache> cache);
+
     static void PurgeAll();
     static void ValidateGlyphCacheDataSize();
     static void Dump();
@@ -175,29 +182,66 @@ public:
     void validateGlyphCacheDataSize() const {}
 #endif
 
+    // The cache is split into kShardCount independently locked shards, picked by descriptor
+    // checksum, so that threads working on different strikes rarely contend. Each shard keeps
+    // its own LRU list; the size and count budgets are enforced across all shards, purging the
+    // least recently used strikes of the whole cache first.
+    static constexpr int kShardCount = 16;
+
 private:
+    struct Shard {
+        // The following methods can only be called when fLock is already held.
+        void internalDetachCache(Node*);
+        void internalAttachToHead(Node*);
+        // The least recently used strike that isn't pinned, or null if there is none.
+        Node* internalOldestDeletable() const;
+#ifdef SK_DEBUG
+        void validate() const;
+#else
+        void validate() const {}
+#endif
+
+        mutable SkSpinlock fLock;
+        Node*              fHead{nullptr};
+        Node*              fTail{nullptr};
+        size_t             fTotalMemoryUsed{0};
+        int32_t            fCacheCount{0};
+
+        // Keep shards, and so their locks, on separate cache lines.
+        char               fPadding[64];
+    };
+
+    Shard& shardFor(const SkDescriptor& desc) {
+        return fShards[desc.getChecksum() & (kShardCount - 1)];
+    }
 
-    // The following methods can only be called when mutex is already held.
-    Node* internalGetHead() const { return fHead; }
-    Node* internalGetTail() const { return fTail; }
-    void internalDetachCache(Node*);
-    void internalAttachToHead(Node*);
+    void detach(Shard*, Node*);
+    void attachToHead(Shard*, Node*);
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
-    // and attempt to purge caches to match.
+    // and attempt to purge caches to match. Takes each shard's lock in turn; the caller must
+    // not hold any.
     // Returns number of bytes freed.
-    size_t internalPurge(size_t minBytesNeeded = 0);
+    size_t purge(size_t minBytesNeeded = 0);
+    size_t internalPurge(size_t minBytesNeeded);
 
     void forEachStrike(std::function<void(const SkStrike&)> visitor) const;
 
-    mutable SkSpinlock fLock;
-    Node*              fHead{nullptr};
-    Node*              fTail{nullptr};
-    size_t             fTotalMemoryUsed{0};
-    size_t             fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
-    int32_t            fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
-    int32_t            fCacheCount{0};
-    int32_t            fPointSizeLimit{SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT};
+    Shard                 fShards[kShardCount];
+
+    // Only one thread purges at a time. Budget totals are kept outside the shards so that
+    // checking them doesn't need any lock. fUseCount stamps each strike as it is attached, which
+    // orders strikes across shards for purging.
+    SkSpinlock            fPurgeLock;
+    std::atomic<uint64_t> fUseCount{0};
+    std::atomic<size_t>   fTotalMemoryUsed{0};
+    std::atomic<int32_t>  fCacheCount{0};
+    std::atomic<size_t>   fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
+    std::atomic<int32_t>  fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
+    std::atomic<int32_t>  fPointSizeLimit{SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT};
+
+    mutable SkSpinlock            fPersistentCacheLock;
+    sk_sp<SkPersistentGlyphCache> fPersistentCache;
 };
 
 using SkExclusiveStrikePtr = SkStrikeCache::ExclusiveStrikePtr;
@@ -0,0 +1,273 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkThreadedBMPDevice.h"
+
+#include "SkPath.h"
+#include "SkRRect.h"
+#include "SkSpecialImage.h"
+#include "SkTLazy.h"
+#include "SkTaskGroup.h"
+#include "SkVertices.h"
+
+SkThreadedBMPDevice::DrawElement::DrawElement(DrawFn&& drawFn, const SkMatrix& matrix,
+                                              const SkRasterClip& rc)
+    : fDrawFn(std::move(drawFn))
+    , fMatrix(matrix)
+    , fRC(rc) {}
+
+SkThreadedBMPDevice::SkThreadedBMPDevice(const SkBitmap& bitmap, int tiles, SkExecutor* executor)
+    : INHERITED(bitmap)
+    , fExecutor(executor ? executor : &SkExecutor::GetDefault()) {
+    // Like SkDrawTiler, keep each tile under 8K so that supersampled coordinates fit in SkFixed.
+    constexpr int kMaxDim = 8192 - 1;
+
+    const int width  = bitmap.width(),
+              height = bitmap.height();
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    int rows = SkTMax(tiles, (height + kMaxDim - 1) / kMaxDim);
+    rows = SkTMin(rows, height);
+    const int cols = (width + kMaxDim - 1) / kMaxDim;
+
+    fTiles.resize(rows * cols);
+    for (int y = 0; y < rows; ++y) {
+        const int top    = SkToInt((int64_t)height *  y      / rows),
+                  bottom = SkToInt((int64_t)height * (y + 1) / rows);
+        for (int x = 0; x < cols; ++x) {
+            const int left  = SkToInt((int64_t)width *  x      / cols),
+                      right = SkToInt((int64_t)width * (x + 1) / cols);
+            fTiles[y * cols + x].fBounds = SkIRect::MakeLTRB(left, top, right, bottom);
+        }
+    }
+}
+
+SkThreadedBMPDevice::~SkThreadedBMPDevice() {
+    this->flush();
+}
+
+void SkThreadedBMPDevice::recordDraw(const SkRect* localBounds, DrawFn&& drawFn) {
+    const SkRasterClip& rc = fRCStack.rc();
+    if (rc.isEmpty()) {
+        return;
+    }
+
+    SkIRect devBounds = rc.getBounds();
+    if (localBounds) {
+        // Outset by a pixel to account for antialiasing and hairlines.
+        const SkRect drawBounds = this->ctm().mapRect(*localBounds).makeOutset(1, 1);
+        if (drawBounds.isFinite() && !devBounds.intersect(drawBounds.roundOut())) {
+            return;
+        }
+    }
+    this->recordDeviceDraw(devBounds, std::move(drawFn));
+}
+
+void SkThreadedBMPDevice::recordDeviceDraw(const SkIRect& devBounds, DrawFn&& drawFn) {
+    const DrawElement* element = nullptr;
+    for (Tile& tile : fTiles) {
+        if (!SkIRect::Intersects(tile.fBounds, devBounds)) {
+            continue;
+        }
+        if (!element) {
+            element = fAlloc.make<DrawElement>(std::move(drawFn), this->ctm(), fRCStack.rc());
+            fPendingCount++;
+        }
+        tile.fElements.push_back(element);
+    }
+}
+
+void SkThreadedBMPDevice::drawTile(const SkPixmap& root, const Tile& tile) const {
+    SkDraw draw;
+    if (tile.fElements.empty() || !root.extractSubset(&draw.fDst, tile.fBounds)) {
+        return;
+    }
+
+    SkMatrix matrix;
+    SkRasterClip rc;
+    draw.fMatrix = &matrix;
+    draw.fRC = &rc;
+
+    const SkIRect tileClip = SkIRect::MakeWH(draw.fDst.width(), draw.fDst.height());
+    for (const DrawElement* element : tile.fElements) {
+        matrix = element->fMatrix;
+        matrix.postTranslate(SkIntToScalar(-tile.fBounds.fLeft),
+                             SkIntToScalar(-tile.fBounds.fTop));
+        element->fRC.translate(-tile.fBounds.fLeft, -tile.fBounds.fTop, &rc);
+        if (rc.op(tileClip, SkRegion::kIntersect_Op)) {
+            element->fDrawFn(draw);
+        }
+    }
+}
+
+void SkThreadedBMPDevice::flush() {
+    if (0 == fPendingCount) {
+        return;
+    }
+
+    // Bypass our own onAccessPixels(), which would try to flush again.
+    SkPixmap root;
+    if (INHERITED::onAccessPixels(&root)) {
+        SkTaskGroup(*fExecutor).batch(SkToInt(fTiles.size()), [&](int i) {
+            this->drawTile(root, fTiles[i]);
+        });
+    }
+
+    for (Tile& tile : fTiles) {
+        tile.fElements.clear();
+    }
+    fAlloc.reset();
+    fPendingCount = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkThreadedBMPDevice::drawPaint(const SkPaint& paint) {
+    this->recordDraw(nullptr, [paint](const SkDraw& draw) {
+        draw.drawPaint(paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawPoints(SkCanvas::PointMode mode, size_t count,
+                                     const SkPoint pts[], const SkPaint& paint) {
+    std::vector<SkPoint> points(pts, pts + count);
+    this->recordDraw(nullptr, [mode, points, paint](const SkDraw& draw) {
+        draw.drawPoints(mode, points.size(), points.data(), paint, nullptr);
+    });
+}
+
+void SkThreadedBMPDevice::drawRect(const SkRect& r, const SkPaint& paint) {
+    SkRect storage;
+    const SkRect* bounds = paint.canComputeFastBounds() ? &paint.computeFastBounds(r, &storage)
+                                                        : nullptr;
+    this->recordDraw(bounds, [r, paint](const SkDraw& draw) {
+        draw.drawRect(r, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
+#ifdef SK_IGNORE_BLURRED_RRECT_OPT
+    INHERITED::drawRRect(rrect, paint);
+#else
+    SkRect storage;
+    const SkRect* bounds = paint.canComputeFastBounds()
+                         ? &paint.computeFastBounds(rrect.getBounds(), &storage)
+                         : nullptr;
+    this->recordDraw(bounds, [rrect, paint](const SkDraw& draw) {
+        draw.drawRRect(rrect, paint);
+    });
+#endif
+}
+
+void SkThreadedBMPDevice::drawPath(const SkPath& path, const SkPaint& paint, bool) {
+    SkRect storage;
+    const SkRect* bounds = nullptr;
+    if (!path.isInverseFillType() && paint.canComputeFastBounds()) {
+        bounds = &paint.computeFastBounds(path.getBounds(), &storage);
+    }
+    // The path is shared by every tile, so it is never mutable.
+    this->recordDraw(bounds, [path, paint](const SkDraw& draw) {
+        draw.drawPath(path, paint, nullptr, false);
+    });
+}
+
+void SkThreadedBMPDevice::drawBitmap(const SkBitmap& bitmap, const SkMatrix& matrix,
+                                     const SkRect* dstOrNull, const SkPaint& paint) {
+    SkRect localBounds, storage;
+    if (dstOrNull) {
+        localBounds = *dstOrNull;
+    } else {
+        matrix.mapRect(&localBounds, SkRect::MakeIWH(bitmap.width(), bitmap.height()));
+    }
+    const SkRect* bounds = paint.canComputeFastBounds()
+                         ? &paint.computeFastBounds(localBounds, &storage)
+                         : nullptr;
+
+    SkTLazy<SkRect> dst;
+    if (dstOrNull) {
+        dst.init(*dstOrNull);
+    }
+    this->recordDraw(bounds, [bitmap, matrix, dst, paint](const SkDraw& draw) {
+        draw.drawBitmap(bitmap, matrix, dst.getMaybeNull(), paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& paint) {
+    // Sprites ignore the CTM, so their bounds are already in device space.
+    SkIRect devBounds = fRCStack.rc().getBounds();
+    const SkRect spriteBounds = SkRect::MakeXYWH(x, y, bitmap.width(), bitmap.height());
+    if (paint.canComputeFastBounds()) {
+        SkRect storage;
+        const SkRect& drawBounds = paint.computeFastBounds(spriteBounds, &storage);
+        if (!devBounds.intersect(drawBounds.roundOut())) {
+            return;
+        }
+    }
+    this->recordDeviceDraw(devBounds, [bitmap, x, y, paint](const SkDraw& draw) {
+        draw.drawSprite(bitmap, x, y, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawGlyphRunList(const SkGlyphRunList& glyphRunList) {
+    // The glyph run list and the glyph painter are only valid on this thread, for this call.
+    this->flush();
+    INHERITED::drawGlyphRunList(glyphRunList);
+}
+
+void SkThreadedBMPDevice::drawVertices(const SkVertices* vertices, const SkVertices::Bone bones[],
+                                       int boneCount, SkBlendMode bmode, const SkPaint& paint) {
+    sk_sp<SkVertices> verts = sk_ref_sp(vertices);
+    std::vector<SkVertices::Bone> boneCopy(bones, bones + boneCount);
+    this->recordDraw(&vertices->bounds(), [verts, boneCopy, bmode, paint](const SkDraw& draw) {
+        draw.drawVertices(verts->mode(), verts->vertexCount(), verts->positions(),
+                          verts->texCoords(), verts->colors(), verts->boneIndices(),
+                          verts->boneWeights(), bmode, verts->indices(), verts->indexCount(),
+                          paint, boneCopy.data(), SkToInt(boneCopy.size()));
+    });
+}
+
+void SkThreadedBMPDevice::drawDevice(SkBaseDevice* device, int x, int y, const SkPaint& paint) {
+    // Drawing a device with coverage writes straight into our pixels.
+    if (static_cast<SkBitmapDevice*>(device)->accessCoverage()) {
+        this->flush();
+    }
+    INHERITED::drawDevice(device, x, y, paint);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+sk_sp<SkSpecialImage> SkThreadedBMPDevice::snapSpecial() {
+    this->flush();
+    return INHERITED::snapSpecial();
+}
+
+sk_sp<SkSpecialImage> SkThreadedBMPDevice::snapBackImage(const SkIRect& bounds) {
+    this->flush();
+    return INHERITED::snapBackImage(bounds);
+}
+
+bool SkThreadedBMPDevice::onReadPixels(const SkPixmap& pm, int x, int y) {
+    this->flush();
+    return INHERITED::onReadPixels(pm, x, y);
+}
+
+bool SkThreadedBMPDevice::onWritePixels(const SkPixmap& pm, int x, int y) {
+    this->flush();
+    return INHERITED::onWritePixels(pm, x, y);
+}
+
+bool SkThreadedBMPDevice::onPeekPixels(SkPixmap* pmap) {
+    this->flush();
+    return INHERITED::onPeekPixels(pmap);
+}
+
+bool SkThreadedBMPDevice::onAccessPixels(SkPixmap* pmap) {
+    this->flush();
+    return INHERITED::onAccessPixels(pmap);
+}
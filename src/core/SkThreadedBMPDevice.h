@@ -0,0 +1,101 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkThreadedBMPDevice_DEFINED
+#define SkThreadedBMPDevice_DEFINED
+
+#include "SkArenaAlloc.h"
+#include "SkBitmapDevice.h"
+#include "SkDraw.h"
+#include "SkExecutor.h"
+#include "SkRasterClip.h"
+
+#include <functional>
+#include <vector>
+
+/**
+ *  An SkBitmapDevice that defers its draws and rasterizes them in parallel.
+ *
+ *  The device is split into horizontal bands ("tiles"). Every draw is recorded once, along with
+ *  a snapshot of its matrix and clip, and appended to the command list of each tile its device
+ *  bounds touch. flush() then rasterizes every tile on the executor, each tile replaying its own
+ *  commands in record order. Tiles never share pixels, so the result is deterministic and
+ *  independent of the number of threads.
+ *
+ *  Any operation that needs the pixels (readPixels, peekPixels, snapSpecial, ...) flushes first.
+ *  Text is rasterized on the calling thread after a flush, since the glyph painter is not
+ *  thread-safe.
+ */
+class SkThreadedBMPDevice : public SkBitmapDevice {
+public:
+    // If executor is null, tiles are rasterized on SkExecutor::GetDefault().
+    SkThreadedBMPDevice(const SkBitmap& bitmap, int tiles, SkExecutor* executor = nullptr);
+    ~SkThreadedBMPDevice() override;
+
+    int tileCount() const { return SkToInt(fTiles.size()); }
+
+    // Rasterizes all recorded draws. Blocks until every tile has been drawn.
+    void flush() override;
+
+protected:
+    void drawPaint(const SkPaint& paint) override;
+    void drawPoints(SkCanvas::PointMode mode, size_t count,
+                    const SkPoint[], const SkPaint& paint) override;
+    void drawRect(const SkRect& r, const SkPaint& paint) override;
+    void drawRRect(const SkRRect& rr, const SkPaint& paint) override;
+    void drawPath(const SkPath&, const SkPaint&, bool pathIsMutable) override;
+    void drawSprite(const SkBitmap&, int x, int y, const SkPaint&) override;
+    void drawGlyphRunList(const SkGlyphRunList& glyphRunList) override;
+    void drawVertices(const SkVertices*, const SkVertices::Bone bones[], int boneCount, SkBlendMode,
+                      const SkPaint& paint) override;
+    void drawDevice(SkBaseDevice*, int x, int y, const SkPaint&) override;
+    void drawBitmap(const SkBitmap&, const SkMatrix&, const SkRect* dstOrNull,
+                    const SkPaint&) override;
+
+    sk_sp<SkSpecialImage> snapSpecial() override;
+    sk_sp<SkSpecialImage> snapBackImage(const SkIRect&) override;
+
+    bool onReadPixels(const SkPixmap&, int x, int y) override;
+    bool onWritePixels(const SkPixmap&, int, int) override;
+    bool onPeekPixels(SkPixmap*) override;
+    bool onAccessPixels(SkPixmap*) override;
+
+    SkExecutor* imageFilterExecutor() const override { return fExecutor; }
+
+private:
+    using DrawFn = std::function<void(const SkDraw&)>;
+
+    struct DrawElement {
+        DrawElement(DrawFn&&, const SkMatrix&, const SkRasterClip&);
+
+        DrawFn       fDrawFn;
+        SkMatrix     fMatrix;
+        SkRasterClip fRC;
+    };
+
+    struct Tile {
+        SkIRect                         fBounds;
+        std::vector<const DrawElement*> fElements;
+    };
+
+    // Records a draw. If localBounds is null the draw may touch everything inside the clip.
+    void recordDraw(const SkRect* localBounds, DrawFn&& drawFn);
+
+    // Records a draw whose device bounds are already known.
+    void recordDeviceDraw(const SkIRect& devBounds, DrawFn&& drawFn);
+
+    void drawTile(const SkPixmap& root, const Tile& tile) const;
+
+    SkExecutor*       fExecutor;
+    std::vector<Tile> fTiles;
+    SkArenaAlloc      fAlloc{4096};
+    int               fPendingCount = 0;
+
+    typedef SkBitmapDevice INHERITED;
+};
+
+#endif // SkThreadedBMPDevice_DEFINED
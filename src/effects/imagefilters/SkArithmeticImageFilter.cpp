@@ -163,11 +163,14 @@ static bool intersect(SkPixmap* dst, SkPixmap* src, int srcDx, int srcDy) {
 sk_sp<SkSpecialImage> ArithmeticImageFilterImpl::onFilterImage(SkSpecialImage* source,
                                                                const Context& ctx,
                                                                SkIPoint* offset) const {
-    SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> background(this->filterInput(0, source, ctx, &backgroundOffset));
-
-    SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> foreground(this->filterInput(1, source, ctx, &foregroundOffset));
+    sk_sp<SkSpecialImage> inputs[2];
+    SkIPoint inputOffsets[2] = { SkIPoint::Make(0, 0), SkIPoint::Make(0, 0) };
+    this->filterInputs(2, source, ctx, inputs, inputOffsets);
+
+    sk_sp<SkSpecialImage> background = std::move(inputs[0]),
+                          foreground = std::move(inputs[1]);
+    const SkIPoint backgroundOffset = inputOffsets[0],
+                   foregroundOffset = inputOffsets[1];
 
     SkIRect foregroundBounds = SkIRect::EmptyIRect();
     if (foreground) {
@@ -12,6 +12,7 @@
 #include "SkArenaAlloc.h"
 #include "SkAutoPixmapStorage.h"
 #include "SkBitmap.h"
+#include "SkCanvas.h"
 #include "SkColorData.h"
 #include "SkImageFilterPriv.h"
 #include "SkTFitsIn.h"
@@ -145,6 +146,10 @@ static GrTextureDomain::Mode to_texture_domain_mode(SkBlurImageFilter::TileMode
 }
 #endif
 
+// The largest sigma calculate_window() handles; see below. cpu_blur() does larger blurs at a lower
+// resolution.
+static constexpr double kMaxCPUSigma = 136.0;
+
 // This is defined by the SVG spec:
 // https://drafts.fxtf.org/filter-effects/#feGaussianBlurElement
 static int calculate_window(double sigma) {
@@ -160,7 +165,7 @@ static int calculate_window(double sigma) {
     //
     //   window = floor(sigma * 3 * sqrt(2 * kPi) / 4 + 0.5)
     //   For window <= 255, the largest value for sigma is 136.
-    sigma = SkTPin(sigma, 0.0, 136.0);
+    sigma = SkTPin(sigma, 0.0, kMaxCPUSigma);
     auto possibleWindow = static_cast<int>(floor(sigma * 3 * sqrt(2 * kPi) / 4 + 0.5));
     return std::max(1, possibleWindow);
 }
@@ -450,11 +455,102 @@ static sk_sp<SkSpecialImage> copy_image_with_bounds(
                                           dst, &source->props());
 }
 
+static sk_sp<SkSpecialImage> cpu_blur(
+        const SkImageFilter::Context& ctx, SkVector sigma,
+        SkSpecialImage *source, const sk_sp<SkSpecialImage> &input,
+        SkIRect srcBounds, SkIRect dstBounds);
+
+// For sigmas too large for calculate_window(), blur a copy of the source scaled down by a power
+// of two, and scale the result back up. A blur that wide leaves nothing at the frequencies the
+// downsample loses.
+static sk_sp<SkSpecialImage> downsampled_cpu_blur(
+        const SkImageFilter::Context& ctx, SkVector sigma,
+        SkSpecialImage *source, const sk_sp<SkSpecialImage> &input,
+        SkIRect srcBounds, SkIRect dstBounds) {
+    // (Once the source is a single pixel there is nothing to gain from going smaller.)
+    int scale = 1;
+    while (std::max(sigma.x(), sigma.y()) / scale > kMaxCPUSigma &&
+           scale < std::max(srcBounds.width(), srcBounds.height())) {
+        scale *= 2;
+    }
+
+    SkBitmap inputBM;
+    if (!input->getROPixels(&inputBM)) {
+        return nullptr;
+    }
+
+    if (inputBM.colorType() != kN32_SkColorType) {
+        return nullptr;
+    }
+
+    SkPixmap inputPixmap, srcPixmap;
+    if (!inputBM.peekPixels(&inputPixmap) || !inputPixmap.extractSubset(&srcPixmap, srcBounds)) {
+        return nullptr;
+    }
+
+    // Round the small size up, so the scale is at most the power of two in each direction.
+    int smallW = (srcBounds.width()  + scale - 1) / scale,
+        smallH = (srcBounds.height() + scale - 1) / scale;
+    SkScalar scaleX = SkIntToScalar(srcBounds.width())  / smallW,
+             scaleY = SkIntToScalar(srcBounds.height()) / smallH;
+
+    SkBitmap small;
+    if (!small.tryAllocPixels(srcPixmap.info().makeWH(smallW, smallH)) ||
+        !srcPixmap.scalePixels(small.pixmap(), kMedium_SkFilterQuality)) {
+        return nullptr;
+    }
+    small.setImmutable();
+
+    // In the small image's space, the source is all of it, and the destination is mapped by
+    // the same scale.
+    SkIRect smallDstBounds = SkRect::MakeLTRB((dstBounds.left()   - srcBounds.left()) / scaleX,
+                                              (dstBounds.top()    - srcBounds.top())  / scaleY,
+                                              (dstBounds.right()  - srcBounds.left()) / scaleX,
+                                              (dstBounds.bottom() - srcBounds.top())  / scaleY)
+                             .roundOut();
+    SkVector smallSigma = SkVector::Make(std::min(sigma.x() / scaleX, (SkScalar)kMaxCPUSigma),
+                                         std::min(sigma.y() / scaleY, (SkScalar)kMaxCPUSigma));
+
+    sk_sp<SkSpecialImage> smallResult = cpu_blur(
+            ctx, smallSigma, source,
+            SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(smallW, smallH), small,
+                                           &source->props()),
+            SkIRect::MakeWH(smallW, smallH), smallDstBounds);
+    SkBitmap smallResultBM;
+    if (!smallResult || !smallResult->getROPixels(&smallResultBM)) {
+        return nullptr;
+    }
+
+    SkBitmap dst;
+    if (!dst.tryAllocPixels(inputBM.info().makeWH(dstBounds.width(), dstBounds.height()))) {
+        return nullptr;
+    }
+    dst.eraseColor(0);
+
+    // Scale the small result back up over the destination.
+    SkCanvas canvas(dst);
+    canvas.translate(smallDstBounds.left() * scaleX + srcBounds.left() - dstBounds.left(),
+                     smallDstBounds.top()  * scaleY + srcBounds.top()  - dstBounds.top());
+    canvas.scale(scaleX, scaleY);
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    paint.setFilterQuality(kLow_SkFilterQuality);
+    canvas.drawBitmap(smallResultBM, 0, 0, &paint);
+
+    return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(dstBounds.width(),
+                                                          dstBounds.height()),
+                                          dst, &source->props());
+}
+
 // TODO: Implement CPU backend for different fTileMode.
 static sk_sp<SkSpecialImage> cpu_blur(
-        SkVector sigma,
+        const SkImageFilter::Context& ctx, SkVector sigma,
         SkSpecialImage *source, const sk_sp<SkSpecialImage> &input,
         SkIRect srcBounds, SkIRect dstBounds) {
+    if (sigma.x() > kMaxCPUSigma || sigma.y() > kMaxCPUSigma) {
+        return downsampled_cpu_blur(ctx, sigma, source, input, srcBounds, dstBounds);
+    }
+
     auto windowW = calculate_window(sigma.x()),
          windowH = calculate_window(sigma.y());
 
@@ -491,13 +587,17 @@ static sk_sp<SkSpecialImage> cpu_blur(
         return nullptr;
     }
 
-    auto bufferSizeW = calculate_buffer(windowW),
-         bufferSizeH = calculate_buffer(windowH);
+    auto bufferSizeW = calculate_buffer(windowW);
 
-    // The amount 1024 is enough for buffers up to 10 sigma. The tmp bitmap will be
-    // allocated on the heap.
-    SkSTArenaAlloc<1024> alloc;
-    Sk4u* buffer = alloc.makeArrayDefault<Sk4u>(std::max(bufferSizeW, bufferSizeH));
+    // Each row is blurred independently, so bands of them may run concurrently.
+    // Each band gets its own buffer; 1024 bytes is enough for buffers up to 10 sigma.
+    auto blur_lines = [&ctx](int bufferSize, int lineCount, int lineLength,
+                             const std::function<void(Sk4u*, int, int)>& blur) {
+        SkImageFilterForBands(ctx, lineCount, lineLength, [&](int begin, int end) {
+            SkSTArenaAlloc<1024> alloc;
+            blur(alloc.makeArrayDefault<Sk4u>(bufferSize), begin, end);
+        });
+    };
 
     // Basic Plan: The three cases to handle
     // * Horizontal and Vertical - blur horizontally while copying values from the source to
@@ -539,19 +639,29 @@ static sk_sp<SkSpecialImage> cpu_blur(
         intermediateWidth = dstW;
         intermediateDst = static_cast<uint32_t *>(dst.getPixels());
 
-        blur_one_direction(
-                buffer, windowW,
-                srcBounds.left(), srcBounds.right(), dstBounds.right(),
-                static_cast<uint32_t *>(src.getPixels()), 1, src.rowBytesAsPixels(), srcH,
-                intermediateSrc, 1, intermediateRowBytesAsPixels);
+        blur_lines(bufferSizeW, srcH, dstW, [&](Sk4u* buffer, int begin, int end) {
+            blur_one_direction(
+                    buffer, windowW,
+                    srcBounds.left(), srcBounds.right(), dstBounds.right(),
+                    src.getAddr32(0, begin), 1, src.rowBytesAsPixels(), end - begin,
+                    intermediateSrc + begin * intermediateRowBytesAsPixels,
+                    1, intermediateRowBytesAsPixels);
+        });
     }
 
     if (windowH > 1) {
-        blur_one_direction(
-                buffer, windowH,
-                srcBounds.top(), srcBounds.bottom(), dstBounds.bottom(),
-                intermediateSrc, intermediateRowBytesAsPixels, 1, intermediateWidth,
-                intermediateDst, dst.rowBytesAsPixels(), 1);
+        // Going down one column at a time would touch a new cache line for every pixel, so the
+        // columns are blurred a tile at a time, a row at a time. Bands of columns may run
+        // concurrently. This gives the same results as blur_one_direction().
+        auto borderH = calculate_border(windowH);
+        SkImageFilterForBands(ctx, intermediateWidth, dstH, [&](int begin, int end) {
+            SkOpts::box_blur_columns(
+                    reinterpret_cast<const uint8_t*>(intermediateSrc + begin),
+                    intermediateRowBytesAsPixels * (ptrdiff_t)sizeof(uint32_t),
+                    srcBounds.top() - borderH, srcBounds.bottom() - borderH,
+                    reinterpret_cast<uint8_t*>(intermediateDst + begin), (ptrdiff_t)dst.rowBytes(),
+                    dstBounds.bottom(), 4 * (end - begin), windowH, false);
+        });
     }
 
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(dstBounds.width(),
@@ -605,7 +715,7 @@ sk_sp<SkSpecialImage> SkBlurImageFilterImpl::onFilterImage(SkSpecialImage* sourc
     } else
 #endif
     {
-        result = cpu_blur(sigma, source, input, inputBounds, dstBounds);
+        result = cpu_blur(ctx, sigma, source, input, inputBounds, dstBounds);
     }
 
     // Return the resultOffset if the blur succeeded.
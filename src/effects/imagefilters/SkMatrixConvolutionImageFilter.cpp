@@ -427,7 +427,14 @@ sk_sp<SkSpecialImage> SkMatrixConvolutionImageFilter::onFilterImage(SkSpecialIma
 
     this->filterBorderPixels(inputBM, &dst, dstContentOffset, top, srcBounds);
     this->filterBorderPixels(inputBM, &dst, dstContentOffset, left, srcBounds);
-    this->filterInteriorPixels(inputBM, &dst, dstContentOffset, interior, srcBounds);
+    // The interior is most of the work, and its rows are independent.
+    const int kernelArea = fKernelSize.width() * fKernelSize.height();
+    SkImageFilterForBands(ctx, SkTMax(0, interior.height()), interior.width() * kernelArea,
+                          [&](int begin, int end) {
+        SkIRect band = SkIRect::MakeLTRB(interior.left(),  interior.top() + begin,
+                                         interior.right(), interior.top() + end);
+        this->filterInteriorPixels(inputBM, &dst, dstContentOffset, band, srcBounds);
+    });
     this->filterBorderPixels(inputBM, &dst, dstContentOffset, right, srcBounds);
     this->filterBorderPixels(inputBM, &dst, dstContentOffset, bottom, srcBounds);
 
@@ -69,20 +69,25 @@ void SkMorphologyImageFilter::flatten(SkWriteBuffer& buffer) const {
     buffer.writeInt(fRadius.fHeight);
 }
 
-static void call_proc_X(SkMorphologyImageFilter::Proc procX,
+// Each row (for X) or column (for Y) is independent, so these may split the work into bands.
+static void call_proc_X(const SkImageFilter::Context& ctx, SkMorphologyImageFilter::Proc procX,
                         const SkBitmap& src, SkBitmap* dst,
                         int radiusX, const SkIRect& bounds) {
-    procX(src.getAddr32(bounds.left(), bounds.top()), dst->getAddr32(0, 0),
-          radiusX, bounds.width(), bounds.height(),
-          src.rowBytesAsPixels(), dst->rowBytesAsPixels());
+    SkImageFilterForBands(ctx, bounds.height(), bounds.width(), [&](int begin, int end) {
+        procX(src.getAddr32(bounds.left(), bounds.top() + begin), dst->getAddr32(0, begin),
+              radiusX, bounds.width(), end - begin,
+              src.rowBytesAsPixels(), dst->rowBytesAsPixels());
+    });
 }
 
-static void call_proc_Y(SkMorphologyImageFilter::Proc procY,
+static void call_proc_Y(const SkImageFilter::Context& ctx, SkMorphologyImageFilter::Proc procY,
                         const SkPMColor* src, int srcRowBytesAsPixels, SkBitmap* dst,
                         int radiusY, const SkIRect& bounds) {
-    procY(src, dst->getAddr32(0, 0),
-          radiusY, bounds.height(), bounds.width(),
-          srcRowBytesAsPixels, dst->rowBytesAsPixels());
+    SkImageFilterForBands(ctx, bounds.width(), bounds.height(), [&](int begin, int end) {
+        procY(src + begin, dst->getAddr32(begin, 0),
+              radiusY, bounds.height(), end - begin,
+              srcRowBytesAsPixels, dst->rowBytesAsPixels());
+    });
 }
 
 SkRect SkMorphologyImageFilter::computeFastBounds(const SkRect& src) const {
@@ -734,15 +739,15 @@ sk_sp<SkSpecialImage> SkMorphologyImageFilter::onFilterImage(SkSpecialImage* sou
             return nullptr;
         }
 
-        call_proc_X(procX, inputBM, &tmp, width, srcBounds);
+        call_proc_X(ctx, procX, inputBM, &tmp, width, srcBounds);
         SkIRect tmpBounds = SkIRect::MakeWH(srcBounds.width(), srcBounds.height());
-        call_proc_Y(procY,
+        call_proc_Y(ctx, procY,
                     tmp.getAddr32(tmpBounds.left(), tmpBounds.top()), tmp.rowBytesAsPixels(),
                     &dst, height, tmpBounds);
     } else if (width > 0) {
-        call_proc_X(procX, inputBM, &dst, width, srcBounds);
+        call_proc_X(ctx, procX, inputBM, &dst, width, srcBounds);
     } else if (height > 0) {
-        call_proc_Y(procY,
+        call_proc_Y(ctx, procY,
                     inputBM.getAddr32(srcBounds.left(), srcBounds.top()),
                     inputBM.rowBytesAsPixels(),
                     &dst, height, srcBounds);
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBoxBlur_opts_DEFINED
+#define SkBoxBlur_opts_DEFINED
+
+#include "SkNx.h"
+#include "SkTemplates.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace SK_OPTS_NS {
+
+// Copies up to four bytes in or out of the lanes of an Sk4u, for the ragged right edge of a tile.
+static inline Sk4u box_blur_load(const uint8_t* src, int n) {
+    if (n >= 4) {
+        return SkNx_cast<uint32_t>(Sk4b::Load(src));
+    }
+    uint8_t bytes[4] = {0, 0, 0, 0};
+    memcpy(bytes, src, n);
+    return SkNx_cast<uint32_t>(Sk4b::Load(bytes));
+}
+
+static inline void box_blur_store(uint8_t* dst, int n, const Sk4u& v) {
+    if (n >= 4) {
+        SkNx_cast<uint8_t>(v).store(dst);
+        return;
+    }
+    uint8_t bytes[4];
+    SkNx_cast<uint8_t>(v).store(bytes);
+    memcpy(dst, bytes, n);
+}
+
+// Blurs down the columns of a band of bytes with the three pass box filter approximation of a
+// Gaussian described in SkBlurImageFilter.cpp, combined into a single pass. Each byte is a lane
+// of its own, so an 8888 pixel is four lanes, and an A8 pixel one.
+//
+// Walking one column at a time, as the horizontal blur walks rows, would touch a new cache line
+// for every pixel. Instead the band is cut into tiles of kTileLanes lanes, and each tile is walked
+// a row at a time, four lanes to an Sk4u, with its running sums and circular buffers kept in a
+// small scratch array that stays in L1.
+//
+// Rows are numbered as in dst. The source rows are [srcStart, srcEnd), and are read from src
+// onwards, srcStart being the first. Output is written to dst rows [0, dstEnd): rows above
+// srcStart are cleared, and rows past srcEnd see zeros. srcRB and dstRB may be negative, to
+// walk up the image, and src and dst may be the same band, as long as src rows are read no
+// later than the dst rows written over them.
+//
+// SkBlurImageFilter rounds by starting the last sum at half the divisor; SkMaskBlurFilter rounds
+// the 32.32 product instead. roundProduct selects the latter, so that both get the same results
+// as their scalar code.
+static void box_blur_columns(const uint8_t* src, ptrdiff_t srcRB, int srcStart, int srcEnd,
+                             uint8_t* dst, ptrdiff_t dstRB, int dstEnd,
+                             int lanes, int window, bool roundProduct) {
+    SkASSERT(window > 1);
+    constexpr int kTileLanes = 64;  // One cache line of each row.
+
+    const int pass0Count = window - 1,
+              pass1Count = window - 1,
+              pass2Count = (window & 1) == 1 ? window - 1 : window;
+
+    const uint32_t window2 = window * window,
+                   window3 = window2 * window,
+                   divisor = (window & 1) == 1 ? window3 : window3 + window2;
+    const Sk4u weight = static_cast<uint32_t>(std::round(1.0 / divisor * (1ull << 32)));
+    const uint32_t half = roundProduct ? 0 : (divisor + 1) / 2;
+
+    // sum0, sum1 and sum2 for each lane, then the three circular buffers, a row of lanes each.
+    SkAutoTMalloc<uint32_t> scratch(kTileLanes * (3 + pass0Count + pass1Count + pass2Count));
+    uint32_t* sum0    = scratch.get();
+    uint32_t* sum1    = sum0 + kTileLanes;
+    uint32_t* sum2    = sum1 + kTileLanes;
+    uint32_t* buffer0 = sum2 + kTileLanes;
+    uint32_t* buffer1 = buffer0 + pass0Count * kTileLanes;
+    uint32_t* buffer2 = buffer1 + pass1Count * kTileLanes;
+    uint32_t* buffer2End = buffer2 + pass2Count * kTileLanes;
+
+    for (int x = 0; x < lanes; x += kTileLanes) {
+        const int tileLanes = std::min(kTileLanes, lanes - x);
+
+        std::fill(sum0, sum2, 0u);
+        std::fill(sum2, buffer0, half);
+        std::fill(buffer0, buffer2End, 0u);
+        uint32_t* buffer0Cursor = buffer0;
+        uint32_t* buffer1Cursor = buffer1;
+        uint32_t* buffer2Cursor = buffer2;
+
+        // Moves the window one row on, with srcRow as the leading edge (or zeros if null), and
+        // writes the result to dstRow unless it is null.
+        auto processRow = [&](const uint8_t* srcRow, uint8_t* dstRow) {
+            for (int i = 0; i < tileLanes; i += 4) {
+                const int n = tileLanes - i;
+                Sk4u leadingEdge = srcRow ? box_blur_load(srcRow + i, n) : Sk4u(0);
+                Sk4u s0 = Sk4u::Load(sum0 + i) + leadingEdge,
+                     s1 = Sk4u::Load(sum1 + i) + s0,
+                     s2 = Sk4u::Load(sum2 + i) + s1;
+
+                if (dstRow) {
+                    Sk4u value = s2.mulHi(weight);
+                    if (roundProduct) {
+                        // Add the carry out of adding half to the low 32 bits of the product.
+                        value = value + ((s2 * weight) >> 31);
+                    }
+                    box_blur_store(dstRow + i, n, value);
+                }
+
+                (s2 - Sk4u::Load(buffer2Cursor + i)).store(sum2 + i);
+                s1.store(buffer2Cursor + i);
+                (s1 - Sk4u::Load(buffer1Cursor + i)).store(sum1 + i);
+                s0.store(buffer1Cursor + i);
+                (s0 - Sk4u::Load(buffer0Cursor + i)).store(sum0 + i);
+                leadingEdge.store(buffer0Cursor + i);
+            }
+            auto advance = [](uint32_t* cursor, uint32_t* start, uint32_t* end) {
+                cursor += kTileLanes;
+                return cursor < end ? cursor : start;
+            };
+            buffer0Cursor = advance(buffer0Cursor, buffer0, buffer1);
+            buffer1Cursor = advance(buffer1Cursor, buffer1, buffer2);
+            buffer2Cursor = advance(buffer2Cursor, buffer2, buffer2End);
+        };
+
+        const uint8_t* srcRow = src + x;
+              uint8_t* dstRow = dst + x;
+        int srcIdx = srcStart,
+            dstIdx = 0;
+
+        // The destination rows are not affected by the source; clear them.
+        while (dstIdx < std::min(srcIdx, dstEnd)) {
+            memset(dstRow, 0, tileLanes);
+            dstRow += dstRB;
+            dstIdx++;
+        }
+
+        // The source starts above the destination. Accumulate the rows above it.
+        while (dstIdx > srcIdx) {
+            processRow(srcIdx < srcEnd ? srcRow : nullptr, nullptr);
+            srcRow += srcRB;
+            srcIdx++;
+        }
+
+        // Source and destination are in step.
+        const int loopEnd = std::min(dstEnd, srcEnd);
+        while (dstIdx < loopEnd) {
+            processRow(srcRow, dstRow);
+            srcRow += srcRB;
+            dstRow += dstRB;
+            dstIdx++;
+        }
+
+        // Past the end of the source.
+        while (dstIdx < dstEnd) {
+            processRow(nullptr, dstRow);
+            dstRow += dstRB;
+            dstIdx++;
+        }
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkBoxBlur_opts_DEFINED
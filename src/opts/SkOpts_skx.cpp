@@ -0,0 +1,26 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkOpts.h"
+
+#define SK_OPTS_NS skx
+#include "SkSwizzler_opts.h"
+#include "SkUtils_opts.h"
+
+namespace SkOpts {
+    void Init_skx() {
+        RGBA_to_BGRA = SK_OPTS_NS::RGBA_to_BGRA;
+        RGBA_to_rgbA = SK_OPTS_NS::RGBA_to_rgbA;
+        RGBA_to_bgrA = SK_OPTS_NS::RGBA_to_bgrA;
+
+        memset16 = SK_OPTS_NS::memset16;
+        memset32 = SK_OPTS_NS::memset32;
+        memset64 = SK_OPTS_NS::memset64;
+
+        // hash_fn stays as it is: SKX has no wider CRC32, and hashes should not depend on the CPU.
+    }
+}
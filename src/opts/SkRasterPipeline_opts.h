@@ -2198,6 +2198,19 @@ STAGE(callback, SkRasterPipeline_CallbackCtx* c) {
     load4(c->read_from,0, &r,&g,&b,&a);
 }
 
+STAGE(interpreter, SkRasterPipeline_InterpreterCtx* c) {
+    constexpr int S = SkRasterPipeline_kMaxStride;
+    unaligned_store(c->rgba + 0*S, r);
+    unaligned_store(c->rgba + 1*S, g);
+    unaligned_store(c->rgba + 2*S, b);
+    unaligned_store(c->rgba + 3*S, a);
+    c->fn(c, tail ? tail : N);
+    r = unaligned_load<F>(c->rgba + 0*S);
+    g = unaligned_load<F>(c->rgba + 1*S);
+    b = unaligned_load<F>(c->rgba + 2*S);
+    a = unaligned_load<F>(c->rgba + 3*S);
+}
+
 STAGE(gauss_a_to_rgba, Ctx::None) {
     // x = 1 - x;
     // exp(-x * x * 4) - 0.018f;
@@ -3381,6 +3394,7 @@ STAGE_GP(bilerp_clamp_8888, const SkRasterPipeline_GatherCtx* ctx) {
 // If a pipeline uses these stages, it'll boot it out of lowp into highp.
 #define NOT_IMPLEMENTED(st) static void (*st)(void) = nullptr;
     NOT_IMPLEMENTED(callback)
+    NOT_IMPLEMENTED(interpreter)
     NOT_IMPLEMENTED(unbounded_set_rgb)
     NOT_IMPLEMENTED(unbounded_uniform_color)
     NOT_IMPLEMENTED(unpremul)
@@ -10,7 +10,6 @@
 #include "SkColorData.h"
 #include "SkData.h"
 #include "SkDeflate.h"
-#include "SkExecutor.h"
 #include "SkImage.h"
 #include "SkImageInfoPriv.h"
 #include "SkJpegInfo.h"
@@ -137,11 +136,9 @@ static void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndir
 static void do_deflated_image(const SkPixmap& pm,
                               SkPDFDocument* doc,
                               bool isOpaque,
-                              SkPDFIndirectReference ref) {
-    SkPDFIndirectReference sMask;
-    if (!isOpaque) {
-        sMask = doc->reserveRef();
-    }
+                              SkPDFIndirectReference ref,
+                              SkPDFIndirectReference sMask) {
+    SkASSERT(isOpaque == !sMask);
     SkDynamicMemoryWStream buffer;
     SkDeflateWStream deflateWStream(&buffer);
     const char* colorSpace = "DeviceGray";
@@ -193,8 +190,8 @@ static void do_deflated_image(const SkPixmap& pm,
     }
 }
 
-static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
-                    SkPDFIndirectReference ref) {
+// Returns true if the encoded data is a JPEG that can be embedded in the PDF as is.
+static bool is_embeddable_jpeg(const SkData* data, SkISize size, bool* yuv) {
     SkISize jpegSize;
     SkEncodedInfo::Color jpegColorType;
     SkEncodedOrigin exifOrientation;
@@ -202,11 +199,17 @@ static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
                        &jpegColorType, &exifOrientation)) {
         return false;
     }
-    bool yuv = jpegColorType == SkEncodedInfo::kYUV_Color;
-    bool goodColorType = yuv || jpegColorType == SkEncodedInfo::kGray_Color;
-    if (jpegSize != size  // Sanity check.
-            || !goodColorType
-            || kTopLeft_SkEncodedOrigin != exifOrientation) {
+    *yuv = jpegColorType == SkEncodedInfo::kYUV_Color;
+    bool goodColorType = *yuv || jpegColorType == SkEncodedInfo::kGray_Color;
+    return jpegSize == size  // Sanity check.
+           && goodColorType
+           && kTopLeft_SkEncodedOrigin == exifOrientation;
+}
+
+static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
+                    SkPDFIndirectReference ref) {
+    bool yuv;
+    if (!is_embeddable_jpeg(data.get(), size, &yuv)) {
         return false;
     }
     #ifdef SK_PDF_BASE85_BINARY
@@ -217,7 +220,7 @@ static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
 
     emit_image_stream(doc, ref,
                       [&data](SkWStream* dst) { dst->write(data->data(), data->size()); },
-                      jpegSize, yuv ? "DeviceRGB" : "DeviceGray",
+                      size, yuv ? "DeviceRGB" : "DeviceGray",
                       SkPDFIndirectReference(), SkToInt(data->size()), true);
     return true;
 }
@@ -245,28 +248,28 @@ static SkBitmap to_pixels(const SkImage* image) {
     return bm;
 }
 
-void serialize_image(const SkImage* img,
-                     int encodingQuality,
-                     SkPDFDocument* doc,
-                     SkPDFIndirectReference ref) {
-    SkASSERT(img);
-    SkASSERT(doc);
+static void serialize_image(const SkImage* img,
+                            int encodingQuality,
+                            SkPDFDocument* doc,
+                            SkPDFIndirectReference ref,
+                            SkPDFIndirectReference sMask) {
     SkASSERT(encodingQuality >= 0);
-    SkISize dimensions = img->dimensions();
-    sk_sp<SkData> data = img->refEncodedData();
-    if (data && do_jpeg(std::move(data), doc, dimensions, ref)) {
-        return;
-    }
     SkBitmap bm = to_pixels(img);
     SkPixmap pm = bm.pixmap();
     bool isOpaque = pm.isOpaque() || pm.computeIsOpaque();
+    SkASSERT(isOpaque || sMask);
+    if (isOpaque && sMask) {
+        // The pixels turned out to be opaque, so the reserved soft mask is left empty.
+        doc->emit(SkPDFDict(), sMask);
+        sMask = SkPDFIndirectReference();
+    }
     if (encodingQuality <= 100 && isOpaque) {
         sk_sp<SkData> data = img->encodeToData(SkEncodedImageFormat::kJPEG, encodingQuality);
-        if (data && do_jpeg(std::move(data), doc, dimensions, ref)) {
+        if (data && do_jpeg(std::move(data), doc, img->dimensions(), ref)) {
             return;
         }
     }
-    do_deflated_image(pm, doc, isOpaque, ref);
+    do_deflated_image(pm, doc, isOpaque, ref, sMask);
 }
 
 SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
@@ -275,16 +278,22 @@ SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
     SkASSERT(img);
     SkASSERT(doc);
     SkPDFIndirectReference ref = doc->reserveRef();
-    if (SkExecutor* executor = doc->executor()) {
-        SkRef(img);
-        doc->incrementJobCount();
-        executor->add([img, encodingQuality, doc, ref]() {
-            serialize_image(img, encodingQuality, doc, ref);
-            SkSafeUnref(img);
-            doc->signalJobComplete();
+    sk_sp<SkData> data = img->refEncodedData();
+    bool yuv;
+    if (data && is_embeddable_jpeg(data.get(), img->dimensions(), &yuv)) {
+        SkISize dimensions = img->dimensions();
+        doc->addJob({ref}, [data, doc, dimensions, ref]() {
+            do_jpeg(data, doc, dimensions, ref);
         });
         return ref;
     }
-    serialize_image(img, encodingQuality, doc, ref);
+    // The soft mask is reserved from the image's alpha type rather than its pixels, so that
+    // decoding stays in the job and the reference is the same with or without an executor.
+    SkPDFIndirectReference sMask = img->isOpaque() ? SkPDFIndirectReference() : doc->reserveRef();
+    SkRef(img);
+    doc->addJob({ref, sMask}, [img, encodingQuality, doc, ref, sMask]() {
+        serialize_image(img, encodingQuality, doc, ref, sMask);
+        SkSafeUnref(img);
+    });
     return ref;
 }
@@ -8,6 +8,7 @@
 #include "SkPDFDocument.h"
 #include "SkPDFDocumentPriv.h"
 
+#include "SkExecutor.h"
 #include "SkMakeUnique.h"
 #include "SkPDFDevice.h"
 #include "SkPDFDocument.h"
@@ -37,12 +38,16 @@ static size_t difference(size_t minuend, size_t subtrahend) {
 }
 
 void SkPDFOffsetMap::markStartOfObject(int referenceNumber, const SkWStream* s) {
+    this->markStartOfObject(referenceNumber, s->bytesWritten());
+}
+
+void SkPDFOffsetMap::markStartOfObject(int referenceNumber, size_t bytesWritten) {
     SkASSERT(referenceNumber > 0);
     size_t index = SkToSizeT(referenceNumber - 1);
     if (index >= fOffsets.size()) {
         fOffsets.resize(index + 1);
     }
-    fOffsets[index] = SkToInt(difference(s->bytesWritten(), fBaseOffset));
+    fOffsets[index] = SkToInt(difference(bytesWritten, fBaseOffset));
 }
 
 int SkPDFOffsetMap::objectCount() const {
@@ -80,12 +85,16 @@ static void serializeHeader(SkPDFOffsetMap* offsetMap, SkWStream* wStream) {
 }
 #undef SKPDF_MAGIC
 
+static void write_object_header(SkPDFIndirectReference ref, SkWStream* s) {
+    s->writeDecAsText(ref.fValue);
+    s->writeText(" 0 obj\n");  // Generation number is always 0.
+}
+
 static void begin_indirect_object(SkPDFOffsetMap* offsetMap,
                                   SkPDFIndirectReference ref,
                                   SkWStream* s) {
     offsetMap->markStartOfObject(ref.fValue, s);
-    s->writeDecAsText(ref.fValue);
-    s->writeText(" 0 obj\n");  // Generation number is always 0.
+    write_object_header(ref, s);
 }
 
 static void end_indirect_object(SkWStream* s) { s->writeText("\nendobj\n"); }
@@ -205,23 +214,101 @@ SkPDFDocument::~SkPDFDocument() {
     this->close();
 }
 
+// Objects written while earlier jobs are still running, and waiting to follow them.
+struct SkPDFDocument::PendingOutput {
+    SkDynamicMemoryWStream              fData;
+    std::vector<std::pair<int, size_t>> fObjects;          // Reference number, offset in fData.
+    bool                                fForJob = false;
+    bool                                fDone = false;     // Nothing more will be written.
+};
+
 SkPDFIndirectReference SkPDFDocument::emit(const SkPDFObject& object, SkPDFIndirectReference ref){
-    object.emitObject(this->beginObject(ref));
-    this->endObject();
+    PendingOutput* pending;
+    object.emitObject(this->beginObject(ref, &pending));
+    this->endObject(pending);
     return ref;
 }
 
-SkWStream* SkPDFDocument::beginObject(SkPDFIndirectReference ref) {
+SkWStream* SkPDFDocument::beginObject(SkPDFIndirectReference ref, PendingOutput** pending) {
     fMutex.acquire();
-    begin_indirect_object(&fOffsetMap, ref, this->getStream());
-    return this->getStream();
+    if (PendingOutput** jobOutput = fPendingByRef.find(ref.fValue)) {
+        *pending = *jobOutput;
+        fPendingByRef.remove(ref.fValue);
+    } else if (!fPendingOutputs.empty()) {
+        fPendingOutputs.push_back(skstd::make_unique<PendingOutput>());
+        *pending = fPendingOutputs.back().get();
+    } else {
+        *pending = nullptr;
+        begin_indirect_object(&fOffsetMap, ref, this->getStream());
+        return this->getStream();
+    }
+    fMutex.release();
+
+    // Nothing else writes to this output until it is done.
+    SkWStream* stream = &(*pending)->fData;
+    (*pending)->fObjects.push_back({ref.fValue, stream->bytesWritten()});
+    write_object_header(ref, stream);
+    return stream;
 };
 
-void SkPDFDocument::endObject() {
-    end_indirect_object(this->getStream());
-    fMutex.release();
+void SkPDFDocument::endObject(PendingOutput* pending) {
+    if (!pending) {
+        end_indirect_object(this->getStream());
+        fMutex.release();
+        return;
+    }
+    end_indirect_object(&pending->fData);
+    if (!pending->fForJob) {
+        SkAutoMutexAcquire autoMutexAcquire(fMutex);
+        pending->fDone = true;
+        this->flushPendingOutputs();
+    }
 };
 
+void SkPDFDocument::flushPendingOutputs() {
+    SkWStream* stream = this->getStream();
+    while (!fPendingOutputs.empty() && fPendingOutputs.front()->fDone) {
+        PendingOutput* output = fPendingOutputs.front().get();
+        const size_t start = stream->bytesWritten();
+        for (const auto& object : output->fObjects) {
+            fOffsetMap.markStartOfObject(object.first, start + object.second);
+        }
+        output->fData.writeToAndReset(stream);
+        fPendingOutputs.pop_front();
+    }
+}
+
+void SkPDFDocument::addJob(std::initializer_list<SkPDFIndirectReference> refs,
+                           std::function<void()> job) {
+    if (!fExecutor) {
+        job();
+        return;
+    }
+
+    PendingOutput* pending;
+    {
+        SkAutoMutexAcquire autoMutexAcquire(fMutex);
+        fPendingOutputs.push_back(skstd::make_unique<PendingOutput>());
+        pending = fPendingOutputs.back().get();
+        pending->fForJob = true;
+        for (SkPDFIndirectReference ref : refs) {
+            if (ref) {
+                fPendingByRef.set(ref.fValue, pending);
+            }
+        }
+    }
+    fJobCount++;
+    fExecutor->add([this, pending, job]() {
+        job();
+        {
+            SkAutoMutexAcquire autoMutexAcquire(fMutex);
+            pending->fDone = true;
+            this->flushPendingOutputs();
+        }
+        fSemaphore.signal();
+    });
+}
+
 static SkSize operator*(SkISize u, SkScalar s) { return SkSize{u.width() * s, u.height() * s}; }
 static SkSize operator*(SkSize u, SkScalar s) { return SkSize{u.width() * s, u.height() * s}; }
 
@@ -490,14 +577,11 @@ void SkPDFDocument::onClose(SkWStream* stream) {
     this->waitForJobs();
     {
         SkAutoMutexAcquire autoMutexAcquire(fMutex);
+        SkASSERT(fPendingOutputs.empty() && 0 == fPendingByRef.count());
         serialize_footer(fOffsetMap, this->getStream(), fInfoDict, docCatalogRef, fUUID);
     }
 }
 
-void SkPDFDocument::incrementJobCount() { fJobCount++; }
-
-void SkPDFDocument::signalJobComplete() { fSemaphore.signal(); }
-
 void SkPDFDocument::waitForJobs() {
      // fJobCount can increase while we wait.
      while (fJobCount > 0) {
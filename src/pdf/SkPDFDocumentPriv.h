@@ -16,6 +16,9 @@
 #include "SkTHash.h"
 
 #include <atomic>
+#include <deque>
+#include <functional>
+#include <initializer_list>
 #include <vector>
 #include <memory>
 
@@ -40,6 +43,7 @@ class SkPDFOffsetMap {
 public:
     void markStartOfDocument(const SkWStream*);
     void markStartOfObject(int referenceNumber, const SkWStream*);
+    void markStartOfObject(int referenceNumber, size_t bytesWritten);
     int objectCount() const;
     int emitCrossReferenceTable(SkWStream* s) const;
 private:
@@ -73,12 +77,13 @@ public:
 
     template <typename T>
     void emitStream(const SkPDFDict& dict, T writeStream, SkPDFIndirectReference ref) {
-        SkWStream* stream = this->beginObject(ref);
+        PendingOutput* pending;
+        SkWStream* stream = this->beginObject(ref, &pending);
         dict.emitObject(stream);
         stream->writeText(" stream\n");
         writeStream(stream);
         stream->writeText("\nendstream");
-        this->endObject();
+        this->endObject(pending);
     }
 
     const SkPDF::Metadata& metadata() const { return fMetadata; }
@@ -90,8 +95,16 @@ public:
     SkPDFIndirectReference reserveRef() { return SkPDFIndirectReference{fNextObjectNumber++}; }
 
     SkExecutor* executor() const { return fExecutor; }
-    void incrementJobCount();
-    void signalJobComplete();
+
+    /**
+       Runs job on the executor, or right away if there is none. refs are
+       the objects job emits. Their output is written to the document in
+       the order jobs are added, not the order they finish, so the document
+       is the same however the jobs are scheduled. Any other object emitted
+       while a job is pending waits behind it the same way.
+     */
+    void addJob(std::initializer_list<SkPDFIndirectReference> refs, std::function<void()> job);
+
     size_t currentPageIndex() { return fPages.size(); }
     size_t pageCount() { return fPageRefs.size(); }
 
@@ -134,9 +147,18 @@ private:
     SkMutex fMutex;
     SkSemaphore fSemaphore;
 
+    // Output waiting for earlier jobs to finish, oldest first. Guarded by fMutex.
+    struct PendingOutput;
+    std::deque<std::unique_ptr<PendingOutput>> fPendingOutputs;
+    SkTHashMap<int, PendingOutput*> fPendingByRef;
+
     void waitForJobs();
-    SkWStream* beginObject(SkPDFIndirectReference);
-    void endObject();
+    // If pending is set to null, the object is written directly to the document with fMutex held
+    // until endObject().
+    SkWStream* beginObject(SkPDFIndirectReference, PendingOutput** pending);
+    void endObject(PendingOutput* pending);
+    // Writes out the finished outputs at the front of fPendingOutputs. Requires fMutex.
+    void flushPendingOutputs();
 };
 
 #endif  // SkPDFDocumentPriv_DEFINED
@@ -9,7 +9,6 @@
 
 #include "SkData.h"
 #include "SkDeflate.h"
-#include "SkExecutor.h"
 #include "SkMakeUnique.h"
 #include "SkPDFDocumentPriv.h"
 #include "SkPDFUnion.h"
@@ -467,17 +466,15 @@ SkPDFIndirectReference SkPDFStreamOut(std::unique_ptr<SkPDFDict> dict,
                                       SkPDFDocument* doc,
                                       bool deflate) {
     SkPDFIndirectReference ref = doc->reserveRef();
-    if (SkExecutor* executor = doc->executor()) {
+    if (doc->executor()) {
         SkPDFDict* dictPtr = dict.release();
         SkStreamAsset* contentPtr = content.release();
         // Pass ownership of both pointers into a std::function, which should
         // only be executed once.
-        doc->incrementJobCount();
-        executor->add([dictPtr, contentPtr, deflate, doc, ref]() {
+        doc->addJob({ref}, [dictPtr, contentPtr, deflate, doc, ref]() {
             serialize_stream(dictPtr, contentPtr, deflate, doc, ref);
             delete dictPtr;
             delete contentPtr;
-            doc->signalJobComplete();
         });
         return ref;
     }
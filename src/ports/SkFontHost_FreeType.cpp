@@ -295,6 +295,11 @@ struct SkFaceRec {
     // Manually keep track of when a named variation is requested for 2.6.1 until 2.7.1.
     bool fNamedVariationSpecified;
 
+    // A private face belongs to one scaler context and is not in the gFaceRecHead list, so it can
+    // be used without holding gFTMutex. Opening and closing it still need the lock, as they
+    // touch the library.
+    bool fPrivate;
+
     SkFaceRec(std::unique_ptr<SkStreamAsset> stream, uint32_t fontID);
 };
 
@@ -320,7 +325,7 @@ extern "C" {
 
 SkFaceRec::SkFaceRec(std::unique_ptr<SkStreamAsset> stream, uint32_t fontID)
         : fNext(nullptr), fSkStream(std::move(stream)), fRefCnt(1), fFontID(fontID)
-        , fAxesCount(0), fNamedVariationSpecified(false)
+        , fAxesCount(0), fNamedVariationSpecified(false), fPrivate(false)
 {
     sk_bzero(&fFTStream, sizeof(fFTStream));
     fFTStream.size = fSkStream->getLength();
@@ -375,20 +380,10 @@ static void ft_face_setup_axes(SkFaceRec* rec, const SkFontData& data) {
 
 // Will return nullptr on failure
 // Caller must lock gFTMutex before calling this function.
-static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
+static std::unique_ptr<SkFaceRec> open_ft_face(const SkTypeface* typeface) {
     gFTMutex.assertHeld();
 
     const SkFontID fontID = typeface->uniqueID();
-    SkFaceRec* cachedRec = gFaceRecHead;
-    while (cachedRec) {
-        if (cachedRec->fFontID == fontID) {
-            SkASSERT(cachedRec->fFace);
-            cachedRec->fRefCnt += 1;
-            return cachedRec;
-        }
-        cachedRec = cachedRec->fNext;
-    }
-
     std::unique_ptr<SkFontData> data = typeface->makeFontData();
     if (nullptr == data || !data->hasStream()) {
         return nullptr;
@@ -430,7 +425,29 @@ static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
     if (!rec->fFace->charmap) {
         FT_Select_Charmap(rec->fFace.get(), FT_ENCODING_MS_SYMBOL);
     }
+    return rec;
+}
+
+// Will return nullptr on failure
+// Caller must lock gFTMutex before calling this function.
+static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
+    gFTMutex.assertHeld();
+
+    const SkFontID fontID = typeface->uniqueID();
+    SkFaceRec* cachedRec = gFaceRecHead;
+    while (cachedRec) {
+        if (cachedRec->fFontID == fontID) {
+            SkASSERT(cachedRec->fFace);
+            cachedRec->fRefCnt += 1;
+            return cachedRec;
+        }
+        cachedRec = cachedRec->fNext;
+    }
 
+    std::unique_ptr<SkFaceRec> rec = open_ft_face(typeface);
+    if (!rec) {
+        return nullptr;
+    }
     rec->fNext = gFaceRecHead;
     gFaceRecHead = rec.get();
     return rec.release();
@@ -441,6 +458,11 @@ static SkFaceRec* ref_ft_face(const SkTypeface* typeface) {
 extern /*static*/ void unref_ft_face(SkFaceRec* faceRec) {
     gFTMutex.assertHeld();
 
+    if (faceRec->fPrivate) {
+        delete faceRec;
+        return;
+    }
+
     SkFaceRec*  rec = gFaceRecHead;
     SkFaceRec*  prev = nullptr;
     while (rec) {
@@ -493,15 +515,20 @@ private:
 
 class SkScalerContext_FreeType : public SkScalerContext_FreeType_Base {
 public:
+    // A context with a private face has an FT_Face of its own, and doesn't take gFTMutex to use
+    // it.
     SkScalerContext_FreeType(sk_sp<SkTypeface>,
                              const SkScalerContextEffects&,
-                             const SkDescriptor* desc);
+                             const SkDescriptor* desc,
+                             bool privateFace = false);
     ~SkScalerContext_FreeType() override;
 
     bool success() const {
         return fFTSize != nullptr && fFace != nullptr;
     }
 
+    std::unique_ptr<SkScalerContext> makeConcurrentContext(const SkDescriptor&) const override;
+
 protected:
     unsigned generateGlyphCount() override;
     uint16_t generateCharToGlyph(SkUnichar uni) override;
@@ -515,7 +542,7 @@ private:
     using UnrefFTFace = SkFunctionWrapper<void, SkFaceRec, unref_ft_face>;
     std::unique_ptr<SkFaceRec, UnrefFTFace> fFaceRec;
 
-    FT_Face   fFace;  // Borrowed face from gFaceRecHead.
+    FT_Face   fFace;  // Borrowed face from gFaceRecHead, or a private one.
     FT_Size   fFTSize;  // The size on the fFace for this scaler.
     FT_Int    fStrikeIndex;
 
@@ -533,6 +560,9 @@ private:
     bool      fDoLinearMetrics;
     bool      fLCDIsVert;
 
+    // The mutex that guards fFace: gFTMutex, unless the face is private.
+    SkBaseMutex* faceMutex() const { return fFaceRec->fPrivate ? nullptr : &gFTMutex; }
+
     FT_Error setupSize();
     void getBBoxForCurrentGlyph(const SkGlyph* glyph, FT_BBox* bbox,
                                 bool snapToPixelBoundary = false);
@@ -826,7 +856,8 @@ static FT_Int chooseBitmapStrike(FT_Face face, FT_F26Dot6 scaleY) {
 
 SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface> typeface,
                                                    const SkScalerContextEffects& effects,
-                                                   const SkDescriptor* desc)
+                                                   const SkDescriptor* desc,
+                                                   bool privateFace)
     : SkScalerContext_FreeType_Base(std::move(typeface), effects, desc)
     , fFace(nullptr)
     , fFTSize(nullptr)
@@ -835,7 +866,15 @@ SkScalerContext_FreeType::SkScalerContext_FreeType(sk_sp<SkTypeface> typeface,
     SkAutoMutexAcquire  ac(gFTMutex);
     SkASSERT_RELEASE(ref_ft_library());
 
-    fFaceRec.reset(ref_ft_face(this->getTypeface()));
+    if (privateFace) {
+        std::unique_ptr<SkFaceRec> rec = open_ft_face(this->getTypeface());
+        if (rec) {
+            rec->fPrivate = true;
+        }
+        fFaceRec.reset(rec.release());
+    } else {
+        fFaceRec.reset(ref_ft_face(this->getTypeface()));
+    }
 
     // load the font file
     if (nullptr == fFaceRec) {
@@ -1018,11 +1057,23 @@ SkScalerContext_FreeType::~SkScalerContext_FreeType() {
     unref_ft_library();
 }
 
+std::unique_ptr<SkScalerContext> SkScalerContext_FreeType::makeConcurrentContext(
+        const SkDescriptor& desc) const {
+    auto c = skstd::make_unique<SkScalerContext_FreeType>(
+            sk_ref_sp(this->getTypeface()), this->getEffects(), &desc, true);
+    if (!c->success()) {
+        return nullptr;
+    }
+    return std::move(c);
+}
+
 /*  We call this before each use of the fFace, since we may be sharing
     this face with other context (at different sizes).
 */
 FT_Error SkScalerContext_FreeType::setupSize() {
-    gFTMutex.assertHeld();
+    if (!fFaceRec->fPrivate) {
+        gFTMutex.assertHeld();
+    }
     FT_Error err = FT_Activate_Size(fFTSize);
     if (err != 0) {
         return err;
@@ -1036,7 +1087,7 @@ unsigned SkScalerContext_FreeType::generateGlyphCount() {
 }
 
 uint16_t SkScalerContext_FreeType::generateCharToGlyph(SkUnichar uni) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->faceMutex());
     return SkToU16(FT_Get_Char_Index( fFace, uni ));
 }
 
@@ -1048,7 +1099,7 @@ bool SkScalerContext_FreeType::generateAdvance(SkGlyph* glyph) {
         return false;
     }
 
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->faceMutex());
 
     if (this->setupSize()) {
         glyph->zeroMetrics();
@@ -1153,7 +1204,7 @@ bool SkScalerContext_FreeType::shouldSubpixelBitmap(const SkGlyph& glyph, const
 }
 
 void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->faceMutex());
 
     glyph->fMaskFormat = fRec.fMaskFormat;
 
@@ -1309,7 +1360,7 @@ static void clear_glyph_image(const SkGlyph& glyph) {
 }
 
 void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->faceMutex());
 
     if (this->setupSize()) {
         clear_glyph_image(glyph);
@@ -1342,7 +1393,7 @@ void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
 bool SkScalerContext_FreeType::generatePath(SkGlyphID glyphID, SkPath* path) {
     SkASSERT(path);
 
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->faceMutex());
 
     // FT_IS_SCALABLE is documented to mean the face contains outline glyphs.
     if (!FT_IS_SCALABLE(fFace) || this->setupSize()) {
@@ -1383,7 +1434,7 @@ void SkScalerContext_FreeType::generateFontMetrics(SkFontMetrics* metrics) {
         return;
     }
 
-    SkAutoMutexAcquire ac(gFTMutex);
+    SkAutoMutexAcquire ac(this->faceMutex());
 
     if (this->setupSize()) {
         sk_bzero(metrics, sizeof(*metrics));
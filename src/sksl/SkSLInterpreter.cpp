@@ -25,6 +25,8 @@
 #include "ir/SkSLVariableReference.h"
 #include "SkRasterPipeline.h"
 
+#include <type_traits>
+
 namespace SkSL {
 
 static constexpr int UNINITIALIZED = 0xDEADBEEF;
@@ -487,6 +489,367 @@ void Interpreter::run() {
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static_assert(Interpreter::VECTOR_WIDTH == SkRasterPipeline_kMaxStride,
+              "runStriped() should handle a full raster pipeline stride");
+
+void Interpreter::runStriped(const ByteCodeFunction& f, int N, Value args[], int stride,
+                             Value inputs[]) {
+    SkASSERT(N > 0 && N <= VECTOR_WIDTH);
+    const int end = (int) f.fCode.size();
+    fIP = 0;
+    fCurrentFunction = &f;
+    fLaneCount = N;
+    fWaitingIP = end;
+    for (int i = 0; i < VECTOR_WIDTH; ++i) {
+        fLaneMask[i] = i < N;
+        fLaneIP[i] = i < N ? 0 : end;
+    }
+
+    // Unused lanes are zeroed so that they never hold anything that could trap.
+    LaneValue lanes;
+    fLaneStack.clear();
+    for (int slot = 0; slot < f.fParameterCount; ++slot) {
+        for (int i = 0; i < VECTOR_WIDTH; ++i) {
+            lanes.fLane[i] = i < N ? args[slot * stride + i] : Value(0);
+        }
+        this->pushLanes(lanes);
+    }
+    for (int i = 0; i < VECTOR_WIDTH; ++i) {
+        lanes.fLane[i] = Value((int) UNINITIALIZED);
+    }
+    for (int i = 0; i < f.fLocalCount; ++i) {
+        this->pushLanes(lanes);
+    }
+    fLaneGlobals.assign(f.fOwner.fGlobalCount, lanes);
+    for (int i = f.fOwner.fInputSlots.size() - 1; i >= 0; --i) {
+        LaneValue& global = fLaneGlobals[f.fOwner.fInputSlots[i]];
+        for (int lane = 0; lane < VECTOR_WIDTH; ++lane) {
+            global.fLane[lane] = inputs[i];
+        }
+    }
+
+    for (;;) {
+        // Rejoin the lanes waiting here, or switch to the waiting lanes once this group is done.
+        if (fIP >= fWaitingIP) {
+            for (int i = 0; i < VECTOR_WIDTH; ++i) {
+                if (fLaneMask[i]) {
+                    fLaneIP[i] = fIP;
+                }
+            }
+            if (!this->scheduleLanes()) {
+                break;
+            }
+        }
+        this->nextStriped();
+    }
+
+    int offset = 0;
+    for (const auto& p : f.fDeclaration.fParameters) {
+        int count = p->fType.columns() * p->fType.rows();
+        if (p->fModifiers.fFlags & Modifiers::kOut_Flag) {
+            for (int slot = offset; slot < offset + count; ++slot) {
+                for (int i = 0; i < N; ++i) {
+                    args[slot * stride + i] = fLaneStack[slot].fLane[i];
+                }
+            }
+        }
+        offset += count;
+    }
+}
+
+bool Interpreter::scheduleLanes() {
+    const int end = (int) fCurrentFunction->fCode.size();
+    int next = end;
+    for (int i = 0; i < VECTOR_WIDTH; ++i) {
+        next = SkTMin(next, fLaneIP[i]);
+    }
+    if (next >= end) {
+        return false;
+    }
+
+    // Running the lowest instruction pointer first guarantees that lanes which skipped ahead (out
+    // of an if, or past a loop) are caught up with before anything after that point runs. Since
+    // branches only happen between statements, every lane has the same stack depth here.
+    fIP = next;
+    fWaitingIP = end;
+    for (int i = 0; i < VECTOR_WIDTH; ++i) {
+        fLaneMask[i] = fLaneIP[i] == next;
+        if (!fLaneMask[i] && fLaneIP[i] < end) {
+            fWaitingIP = SkTMin(fWaitingIP, fLaneIP[i]);
+        }
+    }
+    return true;
+}
+
+void Interpreter::pushLanes(const LaneValue& v) {
+    fLaneStack.push_back(v);
+}
+
+Interpreter::LaneValue Interpreter::popLanes() {
+    LaneValue v = fLaneStack.back();
+    fLaneStack.pop_back();
+    return v;
+}
+
+void Interpreter::storeLanes(LaneValue* dst, const LaneValue& v) const {
+    for (int i = 0; i < VECTOR_WIDTH; ++i) {
+        if (fLaneMask[i]) {
+            dst->fLane[i] = v.fLane[i];
+        }
+    }
+}
+
+// Combines the top 'count' stack slots with the 'count' slots below them, lane by lane.
+template <typename Fn>
+void Interpreter::binaryLanes(int count, Fn fn) {
+    size_t base = fLaneStack.size() - 2 * count;
+    for (int c = 0; c < count; ++c) {
+        LaneValue& a = fLaneStack[base + c];
+        const LaneValue& b = fLaneStack[base + count + c];
+        for (int i = 0; i < VECTOR_WIDTH; ++i) {
+            a.fLane[i] = fn(a.fLane[i], b.fLane[i]);
+        }
+    }
+    fLaneStack.resize(base + count);
+}
+
+// Applies fn to each lane of the top 'count' stack slots, in place.
+template <typename Fn>
+void Interpreter::unaryLanes(int count, Fn fn) {
+    for (size_t slot = fLaneStack.size() - count; slot < fLaneStack.size(); ++slot) {
+        for (int i = 0; i < VECTOR_WIDTH; ++i) {
+            fLaneStack[slot].fLane[i] = fn(fLaneStack[slot].fLane[i]);
+        }
+    }
+}
+
+#define STRIPED_BINARY_OP(inst, field, op)                                           \
+    case ByteCodeInstruction::inst:                                                  \
+        this->binaryLanes(count, [](Value a, Value b) { return Value(a.field op b.field); }); \
+        break;
+
+// Integer division is guarded so that lanes holding stale or masked-off values can never trap.
+#define STRIPED_DIVIDE_OP(inst, type, field, op)                                     \
+    case ByteCodeInstruction::inst:                                                  \
+        this->binaryLanes(count, [](Value a, Value b) {                              \
+            return (b.field == 0 || (std::is_signed<type>::value && b.field == (type) -1)) \
+                   ? Value((type) 0) : Value((type) (a.field op b.field));           \
+        });                                                                          \
+        break;
+
+void Interpreter::nextStriped() {
+    this->nextStripedVector(1);
+}
+
+void Interpreter::nextStripedVector(int count) {
+    ByteCodeInstruction inst = (ByteCodeInstruction) this->read8();
+    switch (inst) {
+        STRIPED_BINARY_OP(kAddI, fSigned, +)
+        STRIPED_BINARY_OP(kAddF, fFloat, +)
+        STRIPED_BINARY_OP(kAndB, fBool, &&)
+        STRIPED_BINARY_OP(kAndI, fSigned, &)
+        case ByteCodeInstruction::kBranch: {
+            int target = this->read16();
+            for (int i = 0; i < VECTOR_WIDTH; ++i) {
+                if (fLaneMask[i]) {
+                    fLaneIP[i] = target;
+                }
+            }
+            fIP = target;
+            if (target > fWaitingIP) {
+                this->scheduleLanes();
+            }
+            break;
+        }
+        STRIPED_BINARY_OP(kCompareIEQ, fSigned, ==)
+        STRIPED_BINARY_OP(kCompareFEQ, fFloat, ==)
+        STRIPED_BINARY_OP(kCompareINEQ, fSigned, !=)
+        STRIPED_BINARY_OP(kCompareFNEQ, fFloat, !=)
+        STRIPED_BINARY_OP(kCompareSGT, fSigned, >)
+        STRIPED_BINARY_OP(kCompareUGT, fUnsigned, >)
+        STRIPED_BINARY_OP(kCompareFGT, fFloat, >)
+        STRIPED_BINARY_OP(kCompareSGTEQ, fSigned, >=)
+        STRIPED_BINARY_OP(kCompareUGTEQ, fUnsigned, >=)
+        STRIPED_BINARY_OP(kCompareFGTEQ, fFloat, >=)
+        STRIPED_BINARY_OP(kCompareSLT, fSigned, <)
+        STRIPED_BINARY_OP(kCompareULT, fUnsigned, <)
+        STRIPED_BINARY_OP(kCompareFLT, fFloat, <)
+        STRIPED_BINARY_OP(kCompareSLTEQ, fSigned, <=)
+        STRIPED_BINARY_OP(kCompareULTEQ, fUnsigned, <=)
+        STRIPED_BINARY_OP(kCompareFLTEQ, fFloat, <=)
+        case ByteCodeInstruction::kConditionalBranch: {
+            int target = this->read16();
+            LaneValue cond = this->popLanes();
+            bool any = false,
+                 all = true;
+            for (int i = 0; i < VECTOR_WIDTH; ++i) {
+                if (fLaneMask[i]) {
+                    any |=  cond.fLane[i].fBool;
+                    all &= cond.fLane[i].fBool;
+                }
+            }
+            if (!any) {
+                break;
+            }
+            for (int i = 0; i < VECTOR_WIDTH; ++i) {
+                if (fLaneMask[i]) {
+                    fLaneIP[i] = cond.fLane[i].fBool ? target : fIP;
+                }
+            }
+            if (all && target <= fWaitingIP) {
+                fIP = target;
+            } else {
+                this->scheduleLanes();
+            }
+            break;
+        }
+        case ByteCodeInstruction::kDebugPrint: {
+            LaneValue v = this->popLanes();
+            for (int i = 0; i < VECTOR_WIDTH; ++i) {
+                if (fLaneMask[i]) {
+                    printf("Debug[%d]: %d(int), %d(uint), %f(float)\n", i, v.fLane[i].fSigned,
+                           v.fLane[i].fUnsigned, v.fLane[i].fFloat);
+                }
+            }
+            break;
+        }
+        STRIPED_DIVIDE_OP(kDivideS, int32_t, fSigned, /)
+        STRIPED_DIVIDE_OP(kDivideU, uint32_t, fUnsigned, /)
+        STRIPED_BINARY_OP(kDivideF, fFloat, /)
+        case ByteCodeInstruction::kDup:
+            this->pushLanes(fLaneStack.back());
+            break;
+        case ByteCodeInstruction::kDupDown: {
+            int dupCount = this->read8();
+            for (int i = 0; i < dupCount; ++i) {
+                fLaneStack.insert(fLaneStack.end() - i - dupCount - 1,
+                                  fLaneStack[fLaneStack.size() - i - 1]);
+            }
+            break;
+        }
+        case ByteCodeInstruction::kFloatToInt:
+            this->unaryLanes(count, [](Value v) { return Value((int32_t) v.fFloat); });
+            break;
+        case ByteCodeInstruction::kSignedToFloat:
+            this->unaryLanes(count, [](Value v) { return Value((float) v.fSigned); });
+            break;
+        case ByteCodeInstruction::kUnsignedToFloat:
+            this->unaryLanes(count, [](Value v) { return Value((float) v.fUnsigned); });
+            break;
+        case ByteCodeInstruction::kLoad: {
+            // Addresses are always immediates, so every lane holds the same target.
+            int target = this->popLanes().fLane[0].fSigned;
+            for (int i = 0; i < count; ++i) {
+                SkASSERT(target + i < (int) fLaneStack.size());
+                this->pushLanes(fLaneStack[target + i]);
+            }
+            break;
+        }
+        case ByteCodeInstruction::kLoadGlobal: {
+            int target = this->read8();
+            for (int i = 0; i < count; ++i) {
+                SkASSERT(target + i < (int) fLaneGlobals.size());
+                this->pushLanes(fLaneGlobals[target + i]);
+            }
+            break;
+        }
+        case ByteCodeInstruction::kLoadSwizzle: {
+            int target = this->popLanes().fLane[0].fSigned;
+            int swizzleCount = this->read8();
+            for (int i = 0; i < swizzleCount; ++i) {
+                int slot = target + fCurrentFunction->fCode[fIP + i];
+                SkASSERT(slot < (int) fLaneStack.size());
+                this->pushLanes(fLaneStack[slot]);
+            }
+            fIP += swizzleCount;
+            break;
+        }
+        STRIPED_BINARY_OP(kMultiplyS, fSigned, *)
+        STRIPED_BINARY_OP(kMultiplyU, fUnsigned, *)
+        STRIPED_BINARY_OP(kMultiplyF, fFloat, *)
+        case ByteCodeInstruction::kNot:
+            this->unaryLanes(count, [](Value v) { return Value(!v.fBool); });
+            break;
+        case ByteCodeInstruction::kNegateF:
+            this->unaryLanes(count, [](Value v) { return Value(-v.fFloat); });
+            break;
+        case ByteCodeInstruction::kNegateS:
+            this->unaryLanes(count, [](Value v) {
+                return Value((int32_t) (0u - v.fUnsigned));
+            });
+            break;
+        STRIPED_BINARY_OP(kOrB, fBool, ||)
+        STRIPED_BINARY_OP(kOrI, fSigned, |)
+        case ByteCodeInstruction::kPop:
+            fLaneStack.resize(fLaneStack.size() - this->read8());
+            break;
+        case ByteCodeInstruction::kPushImmediate: {
+            LaneValue v;
+            Value immediate((int) this->read32());
+            for (int i = 0; i < VECTOR_WIDTH; ++i) {
+                v.fLane[i] = immediate;
+            }
+            this->pushLanes(v);
+            break;
+        }
+        STRIPED_DIVIDE_OP(kRemainderS, int32_t, fSigned, %)
+        STRIPED_DIVIDE_OP(kRemainderU, uint32_t, fUnsigned, %)
+        case ByteCodeInstruction::kStore: {
+            int target = fLaneStack[fLaneStack.size() - count - 1].fLane[0].fSigned + count;
+            for (int i = count - 1; i >= 0; --i) {
+                SkASSERT(target - 1 < (int) fLaneStack.size());
+                this->storeLanes(&fLaneStack[--target], fLaneStack.back());
+                fLaneStack.pop_back();
+            }
+            fLaneStack.pop_back();
+            break;
+        }
+        case ByteCodeInstruction::kStoreGlobal: {
+            int target = fLaneStack[fLaneStack.size() - count - 1].fLane[0].fSigned + count;
+            for (int i = count - 1; i >= 0; --i) {
+                SkASSERT(target - 1 < (int) fLaneGlobals.size());
+                this->storeLanes(&fLaneGlobals[--target], fLaneStack.back());
+                fLaneStack.pop_back();
+            }
+            fLaneStack.pop_back();
+            break;
+        }
+        case ByteCodeInstruction::kStoreSwizzle: {
+            int swizzleCount = this->read8();
+            int target = fLaneStack[fLaneStack.size() - swizzleCount - 1].fLane[0].fSigned;
+            for (int i = swizzleCount - 1; i >= 0; --i) {
+                int slot = target + fCurrentFunction->fCode[fIP + i];
+                SkASSERT(slot < (int) fLaneStack.size());
+                this->storeLanes(&fLaneStack[slot], fLaneStack.back());
+                fLaneStack.pop_back();
+            }
+            fLaneStack.pop_back();
+            fIP += swizzleCount;
+            break;
+        }
+        STRIPED_BINARY_OP(kSubtractI, fSigned, -)
+        STRIPED_BINARY_OP(kSubtractF, fFloat, -)
+        case ByteCodeInstruction::kSwizzle: {
+            LaneValue vec[4];
+            for (int i = this->read8() - 1; i >= 0; --i) {
+                vec[i] = this->popLanes();
+            }
+            for (int i = this->read8() - 1; i >= 0; --i) {
+                this->pushLanes(vec[this->read8()]);
+            }
+            break;
+        }
+        case ByteCodeInstruction::kVector:
+            this->nextStripedVector(this->read8());
+            break;
+        default:
+            printf("unsupported instruction %d\n", (int) inst);
+            SkASSERT(false);
+    }
+}
+
 } // namespace
 
 #endif
@@ -56,13 +56,52 @@ public:
     , fByteCode(std::move(byteCode))
     , fReturnValue(0) {}
 
+    // The largest number of invocations runStriped() can evaluate at once. Matches
+    // SkRasterPipeline_kMaxStride, so a whole pipeline stride can be handled in a single call.
+    static constexpr int VECTOR_WIDTH = 16;
+
     /**
      * Invokes the specified function with the given arguments, returning its return value. 'out'
      * and 'inout' parameters will result in the 'args' array being modified.
      */
     Value run(const ByteCodeFunction& f, Value args[], Value inputs[]);
 
+    /**
+     * Invokes the specified function N times (N <= VECTOR_WIDTH) in lock step, one invocation per
+     * lane. Each instruction is decoded once and applied to every lane. Lanes that disagree on a
+     * branch are masked off and picked up again once control flow reconverges.
+     *
+     * Arguments are stored planar: parameter slot 's' of invocation 'i' is args[s * stride + i].
+     * 'out' and 'inout' parameters are written back the same way. 'inputs' is shared by all lanes.
+     */
+    void runStriped(const ByteCodeFunction& f, int N, Value args[], int stride, Value inputs[]);
+
 private:
+    struct LaneValue {
+        Value fLane[VECTOR_WIDTH];
+    };
+
+    void pushLanes(const LaneValue& v);
+
+    LaneValue popLanes();
+
+    // Stores v into dst for the lanes that are currently executing.
+    void storeLanes(LaneValue* dst, const LaneValue& v) const;
+
+    template <typename Fn>
+    void binaryLanes(int count, Fn fn);
+
+    template <typename Fn>
+    void unaryLanes(int count, Fn fn);
+
+    void nextStriped();
+
+    void nextStripedVector(int count);
+
+    // Moves the lanes that just branched to their new instruction pointers, then selects the
+    // lanes with the lowest instruction pointer to run next. Returns false when every lane is done.
+    bool scheduleLanes();
+
     StackIndex stackAlloc(int count);
 
     uint8_t read8();
@@ -94,6 +133,14 @@ private:
     std::vector<Value> fGlobals;
     std::vector<Value> fStack;
     Value fReturnValue;
+
+    // State for runStriped().
+    int fLaneCount;
+    bool fLaneMask[VECTOR_WIDTH];
+    int fLaneIP[VECTOR_WIDTH];
+    int fWaitingIP;
+    std::vector<LaneValue> fLaneGlobals;
+    std::vector<LaneValue> fLaneStack;
 };
 
 } // namespace
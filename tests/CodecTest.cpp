@@ -18,6 +18,7 @@
 #include "SkColorSpacePriv.h"
 #include "SkData.h"
 #include "SkEncodedImageFormat.h"
+#include "SkExecutor.h"
 #include "SkFrontBufferedStream.h"
 #include "SkImage.h"
 #include "SkImageGenerator.h"
@@ -1802,3 +1803,80 @@ DEF_TEST(Codec_crbug807324, r) {
         }
     }
 }
+
+static void check_banded_decode(skiatest::Reporter* r, sk_sp<SkData> data, SkExecutor* executor) {
+    std::unique_ptr<SkCodec> expectedCodec(SkCodec::MakeFromData(data));
+    std::unique_ptr<SkCodec> codec(SkCodec::MakeFromData(data));
+    if (!codec || !expectedCodec) {
+        ERRORF(r, "Failed to create codec\n");
+        return;
+    }
+
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap expected, actual;
+    expected.allocPixels(info);
+    actual.allocPixels(info);
+    const auto expectedResult = expectedCodec->getPixels(expected.pixmap());
+    const auto result = codec->getPixelsInBands(info, actual.getPixels(), actual.rowBytes(),
+                                                nullptr, executor);
+    REPORTER_ASSERT(r, result == expectedResult);
+    REPORTER_ASSERT(r, md5(expected) == md5(actual));
+
+    // The codec is still usable for a regular decode afterwards.
+    REPORTER_ASSERT(r, codec->getPixels(actual.pixmap()) == expectedResult);
+    REPORTER_ASSERT(r, md5(expected) == md5(actual));
+}
+
+DEF_TEST(Codec_getPixelsInBands, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (const char* path : { "images/mandrill_512_q075.jpg",
+                              "images/mandrill_512.png",
+                              "images/plane_interlaced.png",
+                              "images/color_wheel.jpg" }) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        check_banded_decode(r, data, executor.get());
+        check_banded_decode(r, data, nullptr);
+
+        // Truncated images fall back to a regular decode, filling the missing rows.
+        check_banded_decode(r, SkData::MakeSubset(data.get(), 0, data->size() / 2),
+                            executor.get());
+    }
+}
+
+DEF_TEST(Codec_DecodeBatch, r) {
+    const char* paths[] = { "images/mandrill_512_q075.jpg", "images/mandrill_128.png",
+                            "images/color_wheel.jpg", "images/plane.png" };
+    constexpr int kCount = SK_ARRAY_COUNT(paths);
+
+    std::unique_ptr<SkCodec> codecs[kCount];
+    SkBitmap bitmaps[kCount];
+    SkCodec::BatchItem items[kCount];
+    for (int i = 0; i < kCount; ++i) {
+        codecs[i] = SkCodec::MakeFromData(GetResourceAsData(paths[i]));
+        if (!codecs[i]) {
+            return;
+        }
+        bitmaps[i].allocPixels(codecs[i]->getInfo().makeColorType(kN32_SkColorType));
+        items[i] = { codecs[i].get(), bitmaps[i].info(), bitmaps[i].getPixels(),
+                     bitmaps[i].rowBytes(), nullptr, SkCodec::kUnimplemented };
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (SkExecutor* e : { executor.get(), (SkExecutor*)nullptr }) {
+        for (int count : { kCount, 1 }) {
+            SkCodec::DecodeBatch(items, count, e);
+            for (int i = 0; i < count; ++i) {
+                REPORTER_ASSERT(r, items[i].fResult == SkCodec::kSuccess, "%s", paths[i]);
+
+                SkBitmap expected;
+                expected.allocPixels(bitmaps[i].info());
+                auto codec = SkCodec::MakeFromData(GetResourceAsData(paths[i]));
+                REPORTER_ASSERT(r, codec->getPixels(expected.pixmap()) == SkCodec::kSuccess);
+                REPORTER_ASSERT(r, md5(expected) == md5(bitmaps[i]), "%s", paths[i]);
+            }
+        }
+    }
+}
@@ -5,8 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include "SkArenaAlloc.h"
+#include "SkBitmap.h"
 #include "SkBlitter.h"
+#include "SkCanvas.h"
+#include "SkEdgeBuilder.h"
+#include "SkExecutor.h"
 #include "SkPath.h"
+#include "SkPathPriv.h"
+#include "SkRasterClip.h"
 #include "SkRegion.h"
 #include "SkScan.h"
 #include "Test.h"
@@ -46,3 +53,145 @@ DEF_TEST(FillPathInverse, reporter) {
 
     REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+// Filling a very complex path in bands on other threads should match filling it in one go.
+DEF_TEST(FillPathBanded, reporter) {
+    // Slanted strips, and a circle flattened to a fine polygon, each with enough points to be
+    // banded. Their edges have fractional ends and cross every seam between bands.
+    SkPath strips;
+    for (int i = 0; i < 36; ++i) {
+        for (int j = 0; j < 256; ++j) {
+            SkPoint pt = { 6 * i + 0.3f + j * 0.15f, 0.4f + j * 2.0f };
+            if (j == 0) {
+                strips.moveTo(pt);
+            } else {
+                strips.lineTo(pt);
+            }
+        }
+        for (int j = 255; j >= 0; --j) {
+            strips.lineTo(6 * i + 3.55f + j * 0.15f, 1.7f + j * 2.0f);
+        }
+        strips.close();
+    }
+    SkPath circle;
+    for (int i = 0; i < 1 << 14; ++i) {
+        SkPoint pt = { 128.4f + 120 * SkScalarCos(i * SK_ScalarPI / (1 << 13)),
+                       255.7f + 250 * SkScalarSin(i * SK_ScalarPI / (1 << 13)) };
+        if (i == 0) {
+            circle.moveTo(pt);
+        } else {
+            circle.lineTo(pt);
+        }
+    }
+    circle.close();
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    auto draw = [](const SkPath& path, SkExecutor* bandExecutor, SkBitmap* coverage) {
+        coverage->allocPixels(SkImageInfo::MakeA8(256, 512));
+        coverage->eraseColor(SK_ColorTRANSPARENT);
+        SkSTArenaAlloc<2048> alloc;
+        SkBlitter* blitter = SkBlitter::Choose(coverage->pixmap(), SkMatrix::I(), SkPaint(),
+                                               &alloc);
+        SkScan::AnalyticAntiFillPath(path, SkRasterClip(coverage->info().bounds()), blitter,
+                                     bandExecutor);
+    };
+
+    // Both paths are 512 rows tall, so they are filled in 16 bands of 32 rows. Each band clips
+    // the edges that cross its seams. A clipped edge gets new fixed point ends and slope, and
+    // its coverage of the rows beside the seam is summed from two pieces, each rounded on its
+    // own, so those rows may be off by up to two levels. Everywhere else must match exactly.
+    for (const SkPath& path : { strips, circle }) {
+        SkBitmap expected, actual;
+        draw(path, nullptr, &expected);
+        draw(path, executor.get(), &actual);
+
+        int seamDiff = 0, otherDiff = 0;
+        for (int y = 0; y < expected.height(); ++y) {
+            const int  seam       = SkTPin((y + 16) / 32 * 32, 32, 480);
+            const bool besideSeam = SkTAbs(y - seam) <= 1;
+            for (int x = 0; x < expected.width(); ++x) {
+                int diff = SkTAbs(*expected.getAddr8(x, y) - *actual.getAddr8(x, y));
+                if (besideSeam) {
+                    seamDiff = SkTMax(seamDiff, diff);
+                } else {
+                    otherDiff = SkTMax(otherDiff, diff);
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, seamDiff <= 2, "difference %d beside a seam", seamDiff);
+        REPORTER_ASSERT(reporter, otherDiff == 0, "difference %d between seams", otherDiff);
+    }
+}
+
+// Filling a polygon under integer translations reuses the edges cached on its SkPathRef, and
+// draws the same as filling the translated polygon.
+DEF_TEST(FillPathEdgeCache, reporter) {
+    // Eighths of a pixel survive being moved exactly, so both ways see the same points.
+    SkPath path;
+    for (int i = 0; i < 512; ++i) {
+        SkScalar r = (i & 1) ? 40 : 90;
+        SkPoint pt = { SkScalarRoundToScalar(8 * r * SkScalarCos(i * SK_ScalarPI / 256)) / 8,
+                       SkScalarRoundToScalar(8 * r * SkScalarSin(i * SK_ScalarPI / 256)) / 8 };
+        if (i == 0) {
+            path.moveTo(pt + SkPoint{100, 100});
+        } else {
+            path.lineTo(pt + SkPoint{100, 100});
+        }
+    }
+    REPORTER_ASSERT(reporter, SkEdgeBuilder::CanCacheEdges(path));
+
+    for (bool aa : { false, true }) {
+        SkPaint paint;
+        paint.setAntiAlias(aa);
+
+        SkBitmap expected, actual;
+        expected.allocN32Pixels(256, 256);
+        actual.allocN32Pixels(256, 256);
+        for (SkIPoint offset : { SkIPoint{3, 5}, SkIPoint{-7, 20}, SkIPoint{30, -2} }) {
+            SkPath moved;
+            path.offset(SkIntToScalar(offset.fX), SkIntToScalar(offset.fY), &moved);
+            expected.eraseColor(SK_ColorWHITE);
+            SkCanvas(expected).drawPath(moved, paint);
+
+            actual.eraseColor(SK_ColorWHITE);
+            SkCanvas canvas(actual);
+            canvas.translate(SkIntToScalar(offset.fX), SkIntToScalar(offset.fY));
+            canvas.drawPath(path, paint);
+
+            REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                                  expected.computeByteSize()));
+        }
+
+        // The first draw only notes the path; later ones keep and reuse its edges.
+        sk_sp<SkEdgeCache> cache = SkPathPriv::EdgeCache(path);
+        REPORTER_ASSERT(reporter, cache && cache->fEdges && cache->fCount > 0);
+    }
+
+    // Far from the origin, filling in the path's own coordinates would meet the scan converters'
+    // limits, so the path is transformed as usual and still lands on the device.
+    SkPath far;
+    path.offset(0, 20000, &far);
+    for (bool aa : { false, true }) {
+        SkPaint paint;
+        paint.setAntiAlias(aa);
+
+        SkBitmap expected, actual;
+        expected.allocN32Pixels(256, 256);
+        expected.eraseColor(SK_ColorWHITE);
+        SkCanvas(expected).drawPath(path, paint);
+
+        actual.allocN32Pixels(256, 256);
+        actual.eraseColor(SK_ColorWHITE);
+        SkCanvas canvas(actual);
+        canvas.translate(0, -20000);
+        canvas.drawPath(far, paint);
+
+        REPORTER_ASSERT(reporter, actual.getColor(100, 100) == SK_ColorBLACK);
+        REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                              expected.computeByteSize()));
+    }
+
+    // Changing the path drops its edges.
+    path.lineTo(0, 0);
+    REPORTER_ASSERT(reporter, !SkPathPriv::EdgeCache(path));
+}
@@ -15,6 +15,7 @@
 #include "SkComposeImageFilter.h"
 #include "SkDisplacementMapEffect.h"
 #include "SkDropShadowImageFilter.h"
+#include "SkExecutor.h"
 #include "SkGradientShader.h"
 #include "SkImage.h"
 #include "SkImageFilterPriv.h"
@@ -974,6 +975,89 @@ DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ImageFilterMergeResultSize_Gpu, reporter, ctx
     test_imagefilter_merge_result_size(reporter, ctxInfo.grContext());
 }
 
+DEF_TEST(ImageFilterExecutor, reporter) {
+    // Filtering with an executor runs independent inputs concurrently and splits large filters
+    // into bands; either way the pixels should match filtering on one thread.
+    const int size = 300;
+    SkBitmap gradient = make_gradient_circle(size, size);
+    sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(size, size),
+                                                             gradient));
+
+    const SkScalar kernel[9] = { 1, 1, 1, 1, -7, 1, 1, 1, 1 };
+    sk_sp<SkImageFilter> blur = SkBlurImageFilter::Make(6, 3, nullptr);
+    sk_sp<SkImageFilter> filters[] = {
+        blur,
+        SkDilateImageFilter::Make(4, 2, blur),
+        SkErodeImageFilter::Make(1, 5, nullptr),
+        SkMatrixConvolutionImageFilter::Make(SkISize::Make(3, 3), kernel, 0.3f, 0.1f,
+                                             SkIPoint::Make(1, 1),
+                                             SkMatrixConvolutionImageFilter::kClamp_TileMode,
+                                             true, nullptr, nullptr),
+        SkOffsetImageFilter::Make(7, -3, blur),
+        blur,
+    };
+    sk_sp<SkImageFilter> dag = SkXfermodeImageFilter::Make(
+            SkBlendMode::kSrcOver,
+            SkMergeImageFilter::Make(filters, SK_ARRAY_COUNT(filters)),
+            SkArithmeticImageFilter::Make(0.25f, 0.5f, 0.5f, 0, true, filters[1], filters[3],
+                                          nullptr),
+            nullptr);
+
+    auto filter = [&](SkExecutor* executor) {
+        SkImageFilter::OutputProperties noColorSpace(kN32_SkColorType, nullptr);
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(size, size), nullptr,
+                                   noColorSpace, executor);
+        SkIPoint offset;
+        SkBitmap bm;
+        sk_sp<SkSpecialImage> result(dag->filterImage(src.get(), ctx, &offset));
+        if (result) {
+            result->getROPixels(&bm);
+        }
+        return bm;
+    };
+
+    SkBitmap expected = filter(nullptr);
+    REPORTER_ASSERT(reporter, !expected.drawsNothing());
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (int i = 0; i < 3; i++) {
+        SkBitmap actual = filter(executor.get());
+        REPORTER_ASSERT(reporter, ToolUtils::equal_pixels(expected, actual));
+    }
+}
+
+DEF_TEST(ImageFilterBlurDownsampled, reporter) {
+    // Sigmas too large for the CPU blur's box windows are blurred at a lower resolution rather
+    // than clamped. Either way, the center of a blurred white square should get about as much of
+    // the Gaussian as falls on the square.
+    const int size = 256;
+    SkBitmap white;
+    white.allocN32Pixels(size, size);
+    white.eraseColor(SK_ColorWHITE);
+    sk_sp<SkSpecialImage> src(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(size, size), white));
+
+    SkImageFilter::OutputProperties noColorSpace(kN32_SkColorType, nullptr);
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(size, size), nullptr,
+                               noColorSpace);
+    for (SkScalar sigma : { 100.0f, 300.0f }) {
+        SkIPoint offset;
+        sk_sp<SkSpecialImage> result(
+                SkBlurImageFilter::Make(sigma, sigma, nullptr)->filterImage(src.get(), ctx,
+                                                                            &offset));
+        SkBitmap bm;
+        if (!result || !result->getROPixels(&bm)) {
+            ERRORF(reporter, "sigma %g: no result", sigma);
+            continue;
+        }
+
+        double fraction = erf(size / 2 / (sigma * sqrt(2.0)));
+        int expected = (int)round(fraction * fraction * 255),
+            actual   = SkGetPackedA32(*bm.getAddr32(size / 2 - offset.fX, size / 2 - offset.fY));
+        REPORTER_ASSERT(reporter, SkTAbs(expected - actual) <= 12,
+                        "sigma %g: expected alpha %d, got %d", sigma, expected, actual);
+    }
+}
+
 static void draw_blurred_rect(SkCanvas* canvas) {
     SkPaint filterPaint;
     filterPaint.setColor(SK_ColorWHITE);
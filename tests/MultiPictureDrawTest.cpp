@@ -0,0 +1,69 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkMultiPictureDraw.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static sk_sp<SkPicture> make_picture(SkColor color, SkScalar offset) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(64, 64);
+    SkPaint paint;
+    paint.setColor(color);
+    canvas->drawRect(SkRect::MakeXYWH(offset, offset, 32, 32), paint);
+    paint.setColor(SK_ColorBLACK);
+    paint.setAntiAlias(true);
+    canvas->drawCircle(32, 32, offset / 2 + 4, paint);
+    return recorder.finishRecordingAsPicture();
+}
+
+static bool surfaces_match(SkSurface* a, SkSurface* b) {
+    SkBitmap bmA, bmB;
+    bmA.allocPixels(a->getCanvas()->imageInfo());
+    bmB.allocPixels(b->getCanvas()->imageInfo());
+    if (!a->readPixels(bmA, 0, 0) || !b->readPixels(bmB, 0, 0)) {
+        return false;
+    }
+    return 0 == memcmp(bmA.getPixels(), bmB.getPixels(), bmA.computeByteSize());
+}
+
+DEF_TEST(MultiPictureDraw_Raster, r) {
+    constexpr int kSurfaces = 8;
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+    sk_sp<SkPicture> pictures[] = {
+        make_picture(SK_ColorRED, 4),
+        make_picture(SK_ColorGREEN, 16),
+        make_picture(SK_ColorBLUE, 28),
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (SkExecutor* exec : { executor.get(), static_cast<SkExecutor*>(nullptr) }) {
+        sk_sp<SkSurface> expected[kSurfaces], actual[kSurfaces];
+        SkMultiPictureDraw mpd(kSurfaces, exec);
+        for (int i = 0; i < kSurfaces; ++i) {
+            expected[i] = SkSurface::MakeRaster(info);
+            actual[i] = SkSurface::MakeRaster(info);
+
+            // Several pictures land on the same canvas; they must still draw in order.
+            SkMatrix matrix = SkMatrix::MakeTrans(SkIntToScalar(i), 0);
+            for (int p = 0; p <= i % 3; ++p) {
+                const SkPicture* picture = pictures[(i + p) % 3].get();
+                expected[i]->getCanvas()->drawPicture(picture, &matrix, nullptr);
+                mpd.add(actual[i]->getCanvas(), picture, &matrix);
+            }
+        }
+        mpd.draw(true);
+
+        for (int i = 0; i < kSurfaces; ++i) {
+            REPORTER_ASSERT(r, surfaces_match(expected[i].get(), actual[i].get()), "surface %d", i);
+        }
+    }
+}
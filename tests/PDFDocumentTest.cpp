@@ -256,3 +256,43 @@ DEF_TEST(SkPDF_abort_jobs, rep) {
     doc->abort();
 }
 
+
+static sk_sp<SkData> make_pdf_with_images(SkExecutor* executor) {
+    SkBitmap translucent, opaque;
+    translucent.allocN32Pixels(64, 64);
+    opaque.allocN32Pixels(64, 64);
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            *translucent.getAddr32(x, y) = SkPreMultiplyARGB(4 * y, 4 * x, 0, 0xFF);
+            *opaque.getAddr32(x, y) = SkPreMultiplyARGB(0xFF, 0, 4 * x, 4 * y);
+        }
+    }
+    SkPDF::Metadata metadata;
+    metadata.fExecutor = executor;
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+    for (int i = 0; i < 8; ++i) {
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        canvas->drawColor(SkColorSetARGB(0xFF, 0x00, (uint8_t)(32 * i), 0x00));
+        // Alternate whether the translucent or the opaque image is seen first.
+        canvas->drawBitmap(i % 2 ? translucent : opaque, 10.0f * i, 0);
+        canvas->drawBitmap(i % 2 ? opaque : translucent, 0, 10.0f * i);
+        // New generation IDs keep the document from reusing the images on the next page.
+        translucent.notifyPixelsChanged();
+        opaque.notifyPixelsChanged();
+        doc->endPage();
+    }
+    doc->close();
+    return stream.detachAsData();
+}
+
+// Jobs finish in any order, but their output must be written in the order they were started.
+DEF_TEST(SkPDF_executor_deterministic, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_executor_deterministic, r);
+    sk_sp<SkData> expected = make_pdf_with_images(nullptr);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (int i = 0; i < 2; ++i) {
+        sk_sp<SkData> actual = make_pdf_with_images(executor.get());
+        REPORTER_ASSERT(r, expected->equals(actual.get()));
+    }
+}
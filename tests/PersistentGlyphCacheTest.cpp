@@ -0,0 +1,254 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkFont.h"
+#include "SkPath.h"
+#include "SkPersistentGlyphCache.h"
+#include "SkStream.h"
+#include "SkStrikeCache.h"
+#include "SkTypeface.h"
+#include "Test.h"
+#include "ToolUtils.h"
+
+#include <vector>
+
+static constexpr SkGlyphID kGlyphCount = 20;
+
+struct GlyphSnapshot {
+    SkGlyph              fGlyph{SkPackedGlyphID()};
+    std::vector<uint8_t> fImage;
+    bool                 fHasPath;
+    SkPath               fPath;
+};
+
+// Draws every glyph through a strike made by cache, and records what it produced.
+static std::vector<GlyphSnapshot> snapshot(SkStrikeCache* cache) {
+    SkFont font(ToolUtils::create_portable_typeface(), 24);
+
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I(), &ad, &effects);
+    auto strike = cache->findOrCreateStrikeExclusive(*desc, effects, *font.getTypefaceOrDefault());
+
+    std::vector<GlyphSnapshot> glyphs(kGlyphCount);
+    for (SkGlyphID id = 0; id < kGlyphCount; ++id) {
+        const SkGlyph& glyph = strike->getGlyphIDMetrics(id);
+        GlyphSnapshot& snap = glyphs[id];
+        snap.fGlyph = glyph;
+        snap.fGlyph.fImage = nullptr;
+        snap.fGlyph.fPathData = nullptr;
+        if (const void* image = strike->findImage(glyph)) {
+            auto bytes = static_cast<const uint8_t*>(image);
+            snap.fImage.assign(bytes, bytes + glyph.computeImageSize());
+        }
+        const SkPath* path = strike->findPath(glyph);
+        snap.fHasPath = path != nullptr;
+        if (path) {
+            snap.fPath = *path;
+        }
+    }
+    return glyphs;
+}
+
+static bool same_glyph(const GlyphSnapshot& a, const GlyphSnapshot& b) {
+    return a.fGlyph.fAdvanceX   == b.fGlyph.fAdvanceX
+        && a.fGlyph.fAdvanceY   == b.fGlyph.fAdvanceY
+        && a.fGlyph.fWidth      == b.fGlyph.fWidth
+        && a.fGlyph.fHeight     == b.fGlyph.fHeight
+        && a.fGlyph.fTop        == b.fGlyph.fTop
+        && a.fGlyph.fLeft       == b.fGlyph.fLeft
+        && a.fGlyph.fMaskFormat == b.fGlyph.fMaskFormat
+        && a.fImage             == b.fImage
+        && a.fHasPath           == b.fHasPath
+        && a.fPath              == b.fPath;
+}
+
+static sk_sp<SkData> write(const SkPersistentGlyphCache& cache) {
+    SkDynamicMemoryWStream stream;
+    SkAssertResult(cache.write(&stream));
+    return stream.detachAsData();
+}
+
+DEF_TEST(PersistentGlyphCache_RoundTrip, r) {
+    // Rasterize without a persistent cache, then with an empty one, filling it in.
+    std::vector<GlyphSnapshot> expected;
+    {
+        SkStrikeCache strikeCache;
+        expected = snapshot(&strikeCache);
+    }
+
+    sk_sp<SkPersistentGlyphCache> cache = SkPersistentGlyphCache::Make(nullptr);
+    {
+        SkStrikeCache strikeCache;
+        strikeCache.setPersistentGlyphCache(cache);
+        std::vector<GlyphSnapshot> actual = snapshot(&strikeCache);
+        for (SkGlyphID id = 0; id < kGlyphCount; ++id) {
+            REPORTER_ASSERT(r, same_glyph(expected[id], actual[id]), "glyph %d", id);
+        }
+    }
+    REPORTER_ASSERT(r, 1 == cache->countStrikes());
+    sk_sp<SkData> data = write(*cache);
+
+    // Read it back; every glyph should now come from the file, and match.
+    sk_sp<SkPersistentGlyphCache> reread = SkPersistentGlyphCache::Make(data);
+    REPORTER_ASSERT(r, 1 == reread->countStrikes());
+    {
+        SkStrikeCache strikeCache;
+        strikeCache.setPersistentGlyphCache(reread);
+        std::vector<GlyphSnapshot> actual = snapshot(&strikeCache);
+        for (SkGlyphID id = 0; id < kGlyphCount; ++id) {
+            REPORTER_ASSERT(r, same_glyph(expected[id], actual[id]), "glyph %d", id);
+        }
+    }
+
+    // Nothing new was learned, so writing again gives the same file.
+    sk_sp<SkData> rewritten = write(*reread);
+    REPORTER_ASSERT(r, data->equals(rewritten.get()));
+}
+
+DEF_TEST(PersistentGlyphCache_BadData, r) {
+    sk_sp<SkPersistentGlyphCache> cache = SkPersistentGlyphCache::Make(nullptr);
+    {
+        SkStrikeCache strikeCache;
+        strikeCache.setPersistentGlyphCache(cache);
+        snapshot(&strikeCache);
+    }
+    sk_sp<SkData> data = write(*cache);
+    REPORTER_ASSERT(r, 1 == SkPersistentGlyphCache::Make(data)->countStrikes());
+
+    // Every truncation is rejected.
+    for (size_t size = 0; size < data->size(); size += 4) {
+        auto truncated = SkData::MakeSubset(data.get(), 0, size);
+        REPORTER_ASSERT(r, 0 == SkPersistentGlyphCache::Make(truncated)->countStrikes());
+    }
+
+    // So is a corrupted key or record.
+    for (size_t offset : { (size_t)20, data->size() / 2 }) {
+        sk_sp<SkData> corrupt = SkData::MakeWithCopy(data->data(), data->size());
+        static_cast<uint8_t*>(corrupt->writable_data())[offset] ^= 0xFF;
+        sk_sp<SkPersistentGlyphCache> cache = SkPersistentGlyphCache::Make(corrupt);
+        // An empty cache is still usable.
+        SkStrikeCache strikeCache;
+        strikeCache.setPersistentGlyphCache(cache);
+        snapshot(&strikeCache);
+    }
+
+    const char garbage[] = "not a glyph cache, but long enough to have a header";
+    auto bad = SkPersistentGlyphCache::Make(SkData::MakeWithCopy(garbage, sizeof(garbage)));
+    REPORTER_ASSERT(r, 0 == bad->countStrikes());
+}
+
+// Relearning the metrics of a glyph whose path came from the file must keep that path.
+DEF_TEST(PersistentGlyphCache_AddMetricsKeepsPath, r) {
+    SkFont font(ToolUtils::create_portable_typeface(), 24);
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I(), &ad, &effects);
+    const SkTypeface& typeface = *font.getTypefaceOrDefault();
+
+    SkStrikeCache strikeCache;
+    auto scalerStrike = strikeCache.findOrCreateStrikeExclusive(*desc, effects, typeface);
+    const SkGlyph& glyph = scalerStrike->getGlyphIDMetrics(3);
+
+    SkPath path;
+    path.addCircle(10, 20, 5);
+    path.addRect(SkRect::MakeLTRB(-3, -4, 7, 9));
+
+    sk_sp<SkPersistentGlyphCache> cache = SkPersistentGlyphCache::Make(nullptr);
+    cache->findOrCreateStrike(*desc, typeface)->addPath(glyph.getPackedID(), &path);
+    sk_sp<SkPersistentGlyphCache> reread = SkPersistentGlyphCache::Make(write(*cache));
+
+    reread->findOrCreateStrike(*desc, typeface)->addMetrics(glyph);
+    sk_sp<SkPersistentGlyphCache> rewritten = SkPersistentGlyphCache::Make(write(*reread));
+
+    SkPersistentGlyphCache::Strike* strike = rewritten->findOrCreateStrike(*desc, typeface);
+    REPORTER_ASSERT(r, 1 == strike->countGlyphs());
+    SkPath readPath;
+    bool hasPath = false;
+    REPORTER_ASSERT(r, strike->findPath(glyph.getPackedID(), &readPath, &hasPath));
+    REPORTER_ASSERT(r, hasPath);
+    REPORTER_ASSERT(r, readPath == path);
+
+    SkGlyph readGlyph(glyph.getPackedID());
+    REPORTER_ASSERT(r, strike->findMetrics(&readGlyph));
+    REPORTER_ASSERT(r, readGlyph.fAdvanceX == glyph.fAdvanceX);
+    REPORTER_ASSERT(r, readGlyph.fWidth == glyph.fWidth);
+}
+
+DEF_TEST(PersistentGlyphCache_ByteLimit, r) {
+    sk_sp<SkPersistentGlyphCache> cache = SkPersistentGlyphCache::Make(nullptr);
+    cache->setAddedByteLimit(0);
+    std::vector<GlyphSnapshot> expected;
+    {
+        SkStrikeCache strikeCache;
+        expected = snapshot(&strikeCache);
+    }
+    {
+        // Past the limit, glyphs are still drawn, just not recorded.
+        SkStrikeCache strikeCache;
+        strikeCache.setPersistentGlyphCache(cache);
+        std::vector<GlyphSnapshot> actual = snapshot(&strikeCache);
+        for (SkGlyphID id = 0; id < kGlyphCount; ++id) {
+            REPORTER_ASSERT(r, same_glyph(expected[id], actual[id]), "glyph %d", id);
+        }
+    }
+    REPORTER_ASSERT(r, 0 == cache->getAddedBytesUsed());
+
+    cache->setAddedByteLimit(SK_DEFAULT_PERSISTENT_GLYPH_CACHE_LIMIT);
+    {
+        SkStrikeCache strikeCache;
+        strikeCache.setPersistentGlyphCache(cache);
+        snapshot(&strikeCache);
+    }
+    REPORTER_ASSERT(r, cache->getAddedBytesUsed() > 0);
+    REPORTER_ASSERT(r, cache->getAddedBytesUsed() <= SK_DEFAULT_PERSISTENT_GLYPH_CACHE_LIMIT);
+}
+
+// A record with only metrics must still hold a valid format and image size.
+DEF_TEST(PersistentGlyphCache_BadMetrics, r) {
+    SkFont font(ToolUtils::create_portable_typeface(), 24);
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I(), &ad, &effects);
+    const SkTypeface& typeface = *font.getTypefaceOrDefault();
+
+    SkStrikeCache strikeCache;
+    auto scalerStrike = strikeCache.findOrCreateStrikeExclusive(*desc, effects, typeface);
+    const SkGlyph& glyph = scalerStrike->getGlyphIDMetrics(3);
+
+    sk_sp<SkPersistentGlyphCache> cache = SkPersistentGlyphCache::Make(nullptr);
+    cache->findOrCreateStrike(*desc, typeface)->addMetrics(glyph);
+    sk_sp<SkData> data = write(*cache);
+    REPORTER_ASSERT(r, 1 == SkPersistentGlyphCache::Make(data)->countStrikes());
+
+    // With no images or paths, the file ends with the glyph's record.
+    using Record = SkPersistentGlyphCache::Strike::Record;
+    const size_t recordOffset = data->size() - sizeof(Record);
+
+    void (*corruptions[])(Record*) = {
+        [](Record* rec) { rec->fMaskFormat = 0xFF; },
+        [](Record* rec) { rec->fWidth = kMaxGlyphWidth; },
+        [](Record* rec) { rec->fHeight = 0xFFFF; },
+    };
+    for (auto corruption : corruptions) {
+        sk_sp<SkData> corrupt = SkData::MakeWithCopy(data->data(), data->size());
+        Record rec;
+        memcpy(&rec, corrupt->bytes() + recordOffset, sizeof(Record));
+        REPORTER_ASSERT(r, rec.fPackedID == glyph.getPackedID().value());
+        REPORTER_ASSERT(r, rec.fFlags == Record::kMetrics_Flag);
+        corruption(&rec);
+        memcpy(static_cast<uint8_t*>(corrupt->writable_data()) + recordOffset, &rec,
+               sizeof(Record));
+        REPORTER_ASSERT(r, 0 == SkPersistentGlyphCache::Make(corrupt)->countStrikes());
+    }
+}
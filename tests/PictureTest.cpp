@@ -15,6 +15,7 @@
 #include "SkColor.h"
 #include "SkData.h"
 #include "SkFontStyle.h"
+#include "SkImage.h"
 #include "SkImageInfo.h"
 #include "SkMatrix.h"
 #include "SkMiniRecorder.h"
@@ -845,6 +846,10 @@ DEF_TEST(Picture_RecordsFlush, r) {
     auto skp = pic->serialize();
     auto back = SkPicture::MakeFromData(skp->data(), skp->size());
     REPORTER_ASSERT(r, back->approximateOpCount() == pic->approximateOpCount());
+
+    // Mapped pictures count their ops without recording them.
+    auto mapped = SkPicture::MakeFromMappedData(skp);
+    REPORTER_ASSERT(r, mapped->approximateOpCount() == pic->approximateOpCount());
 }
 
 DEF_TEST(Placeholder, r) {
@@ -879,3 +884,78 @@ DEF_TEST(Picture_empty_serial, reporter) {
     REPORTER_ASSERT(reporter, pic2);
 }
 
+
+static sk_sp<SkPicture> make_mapped_test_picture() {
+    SkBitmap bm;
+    bm.allocN32Pixels(8, 8);
+    bm.eraseColor(SK_ColorBLUE);
+    *bm.getAddr32(3, 3) = SK_ColorRED;
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bm);
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(20, 20));
+    canvas->drawCircle(5, 5, 4, SkPaint());
+    sk_sp<SkPicture> nested = recorder.finishRecordingAsPicture();
+
+    canvas = recorder.beginRecording(SkRect::MakeWH(64, 64));
+    SkPaint paint;
+    paint.setColor(SK_ColorGREEN);
+    canvas->drawRect(SkRect::MakeXYWH(1, 2, 30, 20), paint);
+    canvas->drawImage(image, 30, 30);
+    SkPath path;
+    path.moveTo(0, 60);
+    path.lineTo(30, 40);
+    path.lineTo(40, 64);
+    canvas->drawPath(path, paint);
+    canvas->translate(40, 5);
+    canvas->drawPicture(nested);
+    canvas->translate(0, 25);
+    canvas->drawPicture(nested);
+    return recorder.finishRecordingAsPicture();
+}
+
+static void draw_picture_to(SkBitmap* bm, const SkPicture* pic) {
+    bm->allocN32Pixels(64, 64);
+    bm->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bm);
+    canvas.drawPicture(pic);
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    return 0 == memcmp(a.getPixels(), b.getPixels(), a.computeByteSize());
+}
+
+DEF_TEST(Picture_MakeFromMappedData, r) {
+    sk_sp<SkData> skp = make_mapped_test_picture()->serialize();
+
+    SkBitmap expected;
+    sk_sp<SkPicture> copied = SkPicture::MakeFromData(skp.get());
+    REPORTER_ASSERT(r, copied);
+    draw_picture_to(&expected, copied.get());
+
+    SkBitmap actual;
+    sk_sp<SkPicture> mapped = SkPicture::MakeFromMappedData(skp);
+    REPORTER_ASSERT(r, mapped);
+    REPORTER_ASSERT(r, mapped->cullRect() == copied->cullRect());
+    draw_picture_to(&actual, mapped.get());
+    REPORTER_ASSERT(r, same_pixels(expected, actual));
+
+    // A mapped picture serializes back to an equivalent SKP.
+    sk_sp<SkPicture> roundTrip = SkPicture::MakeFromData(mapped->serialize().get());
+    REPORTER_ASSERT(r, roundTrip);
+    draw_picture_to(&actual, roundTrip.get());
+    REPORTER_ASSERT(r, same_pixels(expected, actual));
+
+    // If the data isn't 4-byte aligned, we fall back to copying.
+    sk_sp<SkData> storage = SkData::MakeUninitialized(skp->size() + 1);
+    memcpy((char*)storage->writable_data() + 1, skp->data(), skp->size());
+    sk_sp<SkPicture> misaligned =
+            SkPicture::MakeFromMappedData(SkData::MakeSubset(storage.get(), 1, skp->size()));
+    REPORTER_ASSERT(r, misaligned);
+    draw_picture_to(&actual, misaligned.get());
+    REPORTER_ASSERT(r, same_pixels(expected, actual));
+
+    // Truncated data must fail cleanly.
+    REPORTER_ASSERT(r, !SkPicture::MakeFromMappedData(SkData::MakeSubset(skp.get(), 0, 40)));
+    REPORTER_ASSERT(r, !SkPicture::MakeFromMappedData(nullptr));
+}
@@ -5,8 +5,10 @@
  * found in the LICENSE file.
  */
 
+#include "SkPackedRTree.h"
 #include "SkRTree.h"
 #include "SkRandom.h"
+#include "SkTSort.h"
 #include "Test.h"
 
 static const int NUM_RECTS = 200;
@@ -89,3 +91,63 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+DEF_TEST(PackedRTree, reporter) {
+    SkRandom rand;
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (size_t i = 0; i < NUM_ITERATIONS; ++i) {
+        SkPackedRTree tree;
+        REPORTER_ASSERT(reporter, 0 == tree.getCount());
+
+        for (int j = 0; j < NUM_RECTS; j++) {
+            rects[j] = random_rect(rand);
+        }
+        tree.insert(rects.get(), NUM_RECTS);
+
+        // search() reports hits in index order; visit() reports the same hits in tree order.
+        for (size_t q = 0; q < NUM_QUERIES; ++q) {
+            SkRect query = random_rect(rand);
+            SkTDArray<int> hits;
+            tree.search(query, &hits);
+            REPORTER_ASSERT(reporter, verify_query(query, rects, hits));
+
+            SkTDArray<int> visited;
+            tree.visit(query, [&](int index) { visited.push_back(index); });
+            if (!visited.isEmpty()) {
+                SkTQSort(visited.begin(), visited.end() - 1);
+            }
+            REPORTER_ASSERT(reporter, visited == hits);
+        }
+        REPORTER_ASSERT(reporter, NUM_RECTS == tree.getCount());
+    }
+}
+
+DEF_TEST(PackedRTree_Degenerate, reporter) {
+    // Concentric and identical rects give the split heuristic nothing to work with.
+    SkAutoTMalloc<SkRect> rects(NUM_RECTS);
+    for (int shape = 0; shape < 2; ++shape) {
+        for (int j = 0; j < NUM_RECTS; j++) {
+            rects[j] = shape ? SkRect::MakeWH(10, 10) : SkRect::MakeWH(j + 1.0f, j + 1.0f);
+        }
+        rects[NUM_RECTS / 2].setEmpty();  // Empty rects are never reported.
+
+        SkPackedRTree tree;
+        tree.insert(rects.get(), NUM_RECTS);
+        REPORTER_ASSERT(reporter, NUM_RECTS - 1 == tree.getCount());
+
+        SkRandom rand;
+        for (size_t q = 0; q < NUM_QUERIES; ++q) {
+            SkRect query = random_rect(rand);
+            SkTDArray<int> hits;
+            tree.search(query, &hits);
+            REPORTER_ASSERT(reporter, verify_query(query, rects, hits));
+        }
+    }
+
+    SkPackedRTree empty;
+    empty.insert(rects.get(), 0);
+    SkTDArray<int> hits;
+    empty.search(SkRect::MakeWH(100, 100), &hits);
+    REPORTER_ASSERT(reporter, hits.isEmpty());
+    REPORTER_ASSERT(reporter, empty.getRootBound().isEmpty());
+}
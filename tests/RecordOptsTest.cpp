@@ -16,6 +16,7 @@
 #include "SkRecords.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureImageFilter.h"
+#include "SkRecordDraw.h"
 #include "SkSurface.h"
 
 static const int W = 1920, H = 1080;
@@ -427,3 +428,186 @@ DEF_TEST(savelayer_srcmode_alpha, r) {
     do_savelayer_srcmode(r, 0x80FF0000);
 }
 
+
+DEF_TEST(RecordOpts_NoopCulledDraws, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint stroke;
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(20);
+
+    recorder.drawRect(SkRect::MakeXYWH( 10,  10, 10, 10), SkPaint());   // Inside.
+    recorder.drawRect(SkRect::MakeXYWH( 90,  90, 20, 20), SkPaint());   // Straddles the edge.
+    recorder.drawRect(SkRect::MakeXYWH(200, 200, 10, 10), SkPaint());   // Outside.
+    recorder.drawRect(SkRect::MakeXYWH(105,  10, 10, 10), stroke);       // Stroked into it.
+    recorder.translate(-150, -150);
+    recorder.drawRect(SkRect::MakeXYWH(200, 200, 10, 10), SkPaint());   // Moved inside.
+
+    SkRecordNoopCulledDraws(&record, SkRect::MakeWH(100, 100));
+
+    assert_type<SkRecords::DrawRect>(r, record, 0);
+    assert_type<SkRecords::DrawRect>(r, record, 1);
+    assert_type<SkRecords::NoOp>    (r, record, 2);
+    assert_type<SkRecords::DrawRect>(r, record, 3);
+    assert_type<SkRecords::Translate>(r, record, 4);
+    assert_type<SkRecords::DrawRect>(r, record, 5);
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDraws, r) {
+    SkPaint opaque, translucent, aa;
+    translucent.setAlpha(0x80);
+    aa.setAntiAlias(true);
+
+    const SkRect small = SkRect::MakeXYWH(20, 20, 10, 10),
+                 large = SkRect::MakeXYWH(10, 10, 50, 50);
+
+    {
+        // A later opaque rect covers an earlier one, even under a different matrix.
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+        recorder.drawRect(small, aa);
+        recorder.drawRect(SkRect::MakeXYWH(-10, -10, 5, 5), opaque);    // Elsewhere.
+        recorder.scale(2, 2);
+        recorder.drawRect(SkRect::MakeXYWH(5, 5, 25, 25), opaque);
+        SkRecordNoopOccludedDraws(&record);
+        assert_type<SkRecords::NoOp>    (r, record, 0);
+        assert_type<SkRecords::DrawRect>(r, record, 1);
+        assert_type<SkRecords::DrawRect>(r, record, 3);
+    }
+    {
+        // Translucent draws and draws reaching within a pixel of the edge don't cover.
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+        recorder.drawRect(small, opaque);
+        recorder.drawRect(large, translucent);
+        recorder.drawRect(SkRect::MakeXYWH(19.5f, 19.5f, 11, 11), opaque);
+        SkRecordNoopOccludedDraws(&record);
+        REPORTER_ASSERT(r, 3 == count_instances_of_type<SkRecords::DrawRect>(record));
+    }
+    {
+        // Nor do draws under a different clip, or an anti-aliased one.
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+        recorder.drawRect(small, opaque);
+        recorder.clipRect(SkRect::MakeWH(100, 100));
+        recorder.drawRect(large, opaque);
+        recorder.save();
+            recorder.clipRect(SkRect::MakeWH(99.5f, 99.5f), true);
+            recorder.drawRect(small, opaque);
+            recorder.drawRect(large, opaque);
+        recorder.restore();
+        SkRecordNoopOccludedDraws(&record);
+        REPORTER_ASSERT(r, 4 == count_instances_of_type<SkRecords::DrawRect>(record));
+    }
+    {
+        // An opaque DrawPaint covers everything, a blurred one nothing.
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+        recorder.drawRect(small, opaque);
+        recorder.drawRect(large, translucent);
+        recorder.drawPaint(opaque);
+        recorder.drawRect(small, opaque);
+        SkPaint blurred;
+        blurred.setImageFilter(SkBlurImageFilter::Make(3, 3, nullptr));
+        recorder.drawPaint(blurred);
+        SkRecordNoopOccludedDraws(&record);
+        assert_type<SkRecords::NoOp>     (r, record, 0);
+        assert_type<SkRecords::NoOp>     (r, record, 1);
+        assert_type<SkRecords::DrawPaint>(r, record, 2);
+        assert_type<SkRecords::DrawRect> (r, record, 3);
+    }
+    {
+        // An opaque image only covers its dst when its src lies within the image.  A 16x16 image
+        // drawn from (0,0,32,32) into (0,0,100,100) only paints (0,0,50,50).
+        sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(16, 16);
+        surface->getCanvas()->clear(SK_ColorRED);
+        sk_sp<SkImage> image = surface->makeImageSnapshot();
+
+        SkRecord record;
+        SkRecorder recorder(&record, W, H);
+        recorder.drawRect(SkRect::MakeXYWH(60, 60, 10, 10), opaque);
+        recorder.drawImageRect(image, SkRect::MakeWH(32, 32), SkRect::MakeWH(100, 100), nullptr);
+        SkRecordNoopOccludedDraws(&record);
+        assert_type<SkRecords::DrawRect>     (r, record, 0);
+        assert_type<SkRecords::DrawImageRect>(r, record, 1);
+
+        SkRecord inside;
+        SkRecorder insideRecorder(&inside, W, H);
+        insideRecorder.drawRect(SkRect::MakeXYWH(60, 60, 10, 10), opaque);
+        insideRecorder.drawImageRect(image, SkRect::MakeWH(16, 16), SkRect::MakeWH(100, 100),
+                                     nullptr);
+        SkRecordNoopOccludedDraws(&inside);
+        assert_type<SkRecords::NoOp>         (r, inside, 0);
+        assert_type<SkRecords::DrawImageRect>(r, inside, 1);
+    }
+}
+
+static sk_sp<SkImage> make_checker_image(int size) {
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(size, size);
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    SkPaint paint;
+    paint.setColor(0x800000FF);
+    for (int y = 0; y < size; y += 2) {
+        for (int x = y % 4; x < size; x += 4) {
+            canvas->drawRect(SkRect::MakeXYWH(x, y, 2, 2), paint);
+        }
+    }
+    return surface->makeImageSnapshot();
+}
+
+static SkBitmap draw_record(const SkRecord& record) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(100, 100);
+    SkCanvas canvas(bitmap);
+    canvas.clear(SK_ColorTRANSPARENT);
+    SkRecordDraw(record, &canvas, nullptr, nullptr, 0, nullptr, nullptr);
+    return bitmap;
+}
+
+DEF_TEST(RecordOpts_BatchImageRects, r) {
+    sk_sp<SkImage> image = make_checker_image(16);
+
+    SkPaint paint, aliased, blurred;
+    paint.setAlpha(0xC0);
+    paint.setFilterQuality(kLow_SkFilterQuality);
+    paint.setAntiAlias(true);
+    aliased = paint;
+    aliased.setAntiAlias(false);
+    blurred = paint;
+    blurred.setImageFilter(SkBlurImageFilter::Make(2, 2, nullptr));
+
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+    // These three batch, the overlap blending just as it would for separate draws.
+    recorder.drawImageRect(image, SkRect::MakeXYWH(0, 0, 30, 30), &paint);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(4, 4, 8, 8), SkRect::MakeXYWH(20, 20, 30, 30),
+                           &paint, SkCanvas::kFast_SrcRectConstraint);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(40.5f, 10, 20, 45), &paint);
+    // These don't batch: the GPU would draw the first with MSAA, and blur the second as a set.
+    recorder.drawImageRect(image, SkRect::MakeXYWH(0, 60, 20, 20), &aliased);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(0, 60, 20, 20), &aliased);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(0, 60, 20, 20), &blurred);
+    // These two batch again.
+    recorder.drawImageRect(image, SkRect::MakeXYWH(60, 60, 15, 20), &paint);
+    recorder.drawImageRect(image, SkRect::MakeXYWH(70, 70, 25.5f, 20), &paint);
+
+    SkBitmap expected = draw_record(record);
+
+    SkRecordBatchImageRects(&record);
+    record.defrag();
+
+    REPORTER_ASSERT(r, 5 == record.count());
+    auto set = assert_type<SkRecords::DrawEdgeAAImageSet>(r, record, 0);
+    REPORTER_ASSERT(r, set && 3 == set->count);
+    assert_type<SkRecords::DrawImageRect>(r, record, 1);
+    assert_type<SkRecords::DrawImageRect>(r, record, 2);
+    assert_type<SkRecords::DrawImageRect>(r, record, 3);
+    set = assert_type<SkRecords::DrawEdgeAAImageSet>(r, record, 4);
+    REPORTER_ASSERT(r, set && 2 == set->count);
+
+    SkBitmap actual = draw_record(record);
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.computeByteSize()));
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#if defined(SK_USING_SKPARAGRAPH)
+
+#include "SkExecutor.h"
+#include "SkParagraph.h"
+#include "SkParagraphBuilder.h"
+
+#include <string>
+#include <vector>
+
+static constexpr double kWidth = 200;
+
+// Two styles, so that an edit can land on the boundary between them.
+static SkTextStyle text_style(SkScalar size) {
+    SkTextStyle style;
+    style.setColor(SK_ColorBLACK);
+    style.setFontSize(size);
+    return style;
+}
+
+static std::unique_ptr<SkParagraph> build(sk_sp<SkFontCollection> fonts,
+                                          const std::string& text, size_t boundary) {
+    SkParagraphBuilder builder(SkParagraphStyle(), std::move(fonts));
+    builder.pushStyle(text_style(14));
+    builder.addText(text.substr(0, boundary));
+    builder.pop();
+    builder.pushStyle(text_style(20));
+    builder.addText(text.substr(boundary));
+    builder.pop();
+    return builder.Build();
+}
+
+static void check_same_layout(skiatest::Reporter* r, SkParagraph* edited, SkParagraph* fresh,
+                              size_t textSize) {
+    REPORTER_ASSERT(r, SkScalarNearlyEqual(edited->getHeight(), fresh->getHeight()));
+    REPORTER_ASSERT(r, SkScalarNearlyEqual(edited->getMinIntrinsicWidth(),
+                                           fresh->getMinIntrinsicWidth()));
+    REPORTER_ASSERT(r, SkScalarNearlyEqual(edited->getMaxIntrinsicWidth(),
+                                           fresh->getMaxIntrinsicWidth()));
+    REPORTER_ASSERT(r, SkScalarNearlyEqual(edited->getAlphabeticBaseline(),
+                                           fresh->getAlphabeticBaseline()));
+    REPORTER_ASSERT(r, SkScalarNearlyEqual(edited->getIdeographicBaseline(),
+                                           fresh->getIdeographicBaseline()));
+    REPORTER_ASSERT(r, edited->didExceedMaxLines() == fresh->didExceedMaxLines());
+
+    // Every line and style run shows up in the boxes of the whole text, and the others cut
+    // through the middle of runs and across the line breaks.
+    const unsigned ranges[][2] = {
+        { 0, (unsigned)textSize },
+        { 0, (unsigned)textSize / 3 },
+        { (unsigned)textSize / 4, (unsigned)textSize * 3 / 4 },
+        { (unsigned)textSize / 2, (unsigned)textSize },
+    };
+    for (auto range : ranges) {
+        for (auto height : { RectHeightStyle::kTight, RectHeightStyle::kMax }) {
+            auto a = edited->getRectsForRange(range[0], range[1], height, RectWidthStyle::kTight);
+            auto b = fresh->getRectsForRange(range[0], range[1], height, RectWidthStyle::kTight);
+            REPORTER_ASSERT(r, a.size() == b.size());
+            for (size_t i = 0; i < SkTMin(a.size(), b.size()); ++i) {
+                REPORTER_ASSERT(r, SkScalarNearlyEqual(a[i].rect.fLeft,   b[i].rect.fLeft));
+                REPORTER_ASSERT(r, SkScalarNearlyEqual(a[i].rect.fTop,    b[i].rect.fTop));
+                REPORTER_ASSERT(r, SkScalarNearlyEqual(a[i].rect.fRight,  b[i].rect.fRight));
+                REPORTER_ASSERT(r, SkScalarNearlyEqual(a[i].rect.fBottom, b[i].rect.fBottom));
+                REPORTER_ASSERT(r, a[i].direction == b[i].direction);
+            }
+        }
+    }
+}
+
+// Each edit only reshapes the lines it touches, so after every one the paragraph has to lay
+// out just like one built from scratch from the edited text.
+DEF_TEST(SkParagraph_UpdateText, r) {
+    auto fonts = sk_make_sp<SkFontCollection>();
+    std::string text = "The first style runs over\nthis line break, and then\n"
+                       "the second style takes over\nfor the last two lines.";
+    size_t boundary = text.find("break");
+
+    auto paragraph = build(fonts, text, boundary);
+    paragraph->layout(kWidth);
+
+    struct Edit {
+        size_t      from;
+        size_t      to;
+        std::string text;
+    };
+    const Edit edits[] = {
+        { boundary, boundary, "inserted " },             // At the boundary between styles.
+        { 20, text.find('\n') + 6, "" },                 // Across the first line break.
+        { 0, 3, "A" },                                   // At the start.
+        { 0, 0, "New line\n" },                          // A new first line.
+        { 0, 0, "" },                                    // Nothing at all.
+    };
+    for (const Edit& edit : edits) {
+        size_t from = SkTMin(edit.from, text.size());
+        size_t to = SkTPin(edit.to, from, text.size());
+
+        // Text replacing or inserted after the end of the first style's text takes that style.
+        bool first = from < to ? from < boundary : from <= boundary;
+        boundary = boundary - (SkTMin(to, boundary) - SkTMin(from, boundary))
+                            + (first ? edit.text.size() : 0);
+        text.replace(from, to - from, edit.text);
+
+        paragraph->updateText(from, to, edit.text);
+        paragraph->layout(kWidth);
+
+        auto fresh = build(fonts, text, boundary);
+        fresh->layout(kWidth);
+        check_same_layout(r, paragraph.get(), fresh.get(), text.size());
+    }
+
+    // And at the end, at a different width, so that every line is wrapped again.
+    size_t end = text.size();
+    paragraph->updateText(end - 1, end, "!");
+    text.replace(end - 1, 1, "!");
+    paragraph->layout(kWidth / 2);
+    auto fresh = build(fonts, text, boundary);
+    fresh->layout(kWidth / 2);
+    check_same_layout(r, paragraph.get(), fresh.get(), text.size());
+}
+
+// Paragraphs laid out together on a thread pool, sharing one font collection and repeating the
+// same text, have to come out just as they do laid out one at a time.
+DEF_TEST(SkParagraph_LayoutAll, r) {
+    const std::string texts[] = {
+        "A short one.",
+        "Several words long enough\nto wrap onto a few lines at this width.",
+        "The same words again and again, the same words again and again.",
+        "Numbers 0123456789 and punctuation: (like this), [this] and {this}!",
+    };
+    constexpr int kCount = 48;    // Several tasks' worth, each text many times over.
+
+    auto fonts = sk_make_sp<SkFontCollection>();
+    std::vector<std::unique_ptr<SkParagraph>> paragraphs;
+    std::vector<SkParagraph*> pointers;
+    for (int i = 0; i < kCount; ++i) {
+        const std::string& text = texts[i % SK_ARRAY_COUNT(texts)];
+        paragraphs.push_back(build(fonts, text, text.size() / 2));
+        pointers.push_back(paragraphs.back().get());
+    }
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkParagraph::LayoutAll(pointers, kWidth, *executor);
+
+    auto serialFonts = sk_make_sp<SkFontCollection>();
+    for (int i = 0; i < kCount; ++i) {
+        const std::string& text = texts[i % SK_ARRAY_COUNT(texts)];
+        auto serial = build(serialFonts, text, text.size() / 2);
+        serial->layout(kWidth);
+        check_same_layout(r, paragraphs[i].get(), serial.get(), text.size());
+    }
+}
+
+#endif  // SK_USING_SKPARAGRAPH
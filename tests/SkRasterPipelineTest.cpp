@@ -5,8 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include "SkArenaAlloc.h"
+#include "SkBitmap.h"
+#include "SkCoreBlitters.h"
+#include "SkGradientShader.h"
 #include "SkHalf.h"
+#include "SkPath.h"
+#include "SkRasterClip.h"
 #include "SkRasterPipeline.h"
+#include "SkScan.h"
 #include "SkTo.h"
 #include "Test.h"
 
@@ -158,6 +165,55 @@ DEF_TEST(SkRasterPipeline_tail, r) {
     }
 }
 
+DEF_TEST(SkRasterPipeline_tail_every_width, r) {
+    // Run through every tail of the widest stride, plus a full stride before it.
+    constexpr int kMax = 2*SkRasterPipeline_kMaxStride;
+
+    float    f32[kMax][4],  f32_out[kMax][4];
+    uint16_t f16[kMax][4],  f16_out[kMax][4];
+    uint32_t rgba[kMax],    rgba_out[kMax];
+    for (int i = 0; i < kMax; i++) {
+        for (int j = 0; j < 4; j++) {
+            f32[i][j] = 10*i + j;
+            f16[i][j] = h(0.25f * j + i / (float)kMax);
+        }
+        rgba[i] = 0x01020304 * (i+1);
+    }
+
+    SkRasterPipeline_MemoryCtx f32_src  = { &f32[0][0], 0 }, f32_dst  = { &f32_out[0][0], 0 },
+                               f16_src  = { &f16[0][0], 0 }, f16_dst  = { &f16_out[0][0], 0 },
+                               rgba_src = { rgba,       0 }, rgba_dst = { rgba_out,      0 };
+
+    for (int n = 1; n <= kMax; n++) {
+        memset(f32_out , 0xff, sizeof(f32_out ));
+        memset(f16_out , 0xff, sizeof(f16_out ));
+        memset(rgba_out, 0xff, sizeof(rgba_out));
+
+        SkRasterPipeline_<256> p32, p16, p8888;
+        p32.append(SkRasterPipeline::load_f32, &f32_src);
+        p32.append(SkRasterPipeline::store_f32, &f32_dst);
+        p32.run(0,0, n,1);
+        p16.append(SkRasterPipeline::load_f16, &f16_src);
+        p16.append(SkRasterPipeline::store_f16, &f16_dst);
+        p16.run(0,0, n,1);
+        p8888.append(SkRasterPipeline::load_8888, &rgba_src);
+        p8888.append(SkRasterPipeline::store_8888, &rgba_dst);
+        p8888.run(0,0, n,1);
+
+        // Pixels [0,n) are copied exactly, and nothing after them is touched.
+        REPORTER_ASSERT(r, !memcmp(f32_out , f32 , n*sizeof(f32[0])));
+        REPORTER_ASSERT(r, !memcmp(f16_out , f16 , n*sizeof(f16[0])));
+        REPORTER_ASSERT(r, !memcmp(rgba_out, rgba, n*sizeof(rgba[0])));
+        for (int i = n; i < kMax; i++) {
+            for (int j = 0; j < 4; j++) {
+                REPORTER_ASSERT(r, SkScalarIsNaN(f32_out[i][j]));
+                REPORTER_ASSERT(r, f16_out[i][j] == 0xffff);
+            }
+            REPORTER_ASSERT(r, rgba_out[i] == 0xffffffff);
+        }
+    }
+}
+
 DEF_TEST(SkRasterPipeline_lowp, r) {
     uint32_t rgba[64];
     for (int i = 0; i < 64; i++) {
@@ -202,3 +258,91 @@ DEF_TEST(SkRasterPipeline_lowp_clamp01, r) {
     p.append(SkRasterPipeline::store_8888, &ptr);
     p.run(0,0,1,1);
 }
+
+DEF_TEST(SkRasterPipeline_program, r) {
+    uint32_t src[4] = { 0xff0000ff, 0x8000ff00, 0x40ff0000, 0x00000000 },
+             dst[4] = { 0,0,0,0 };
+    SkRasterPipeline_MemoryCtx src_ctx = { src, 0 },
+                               dst_ctx = { dst, 0 };
+
+    SkRasterPipeline_<256> p;
+    p.append(SkRasterPipeline::load_8888, &src_ctx);
+    p.append(SkRasterPipeline::swap_rb);
+    p.append(SkRasterPipeline::store_8888, &dst_ctx);
+
+    // Every context must be found among those we pass.
+    SkRasterPipeline::Program program;
+    void* srcOnly[] = { &src_ctx };
+    REPORTER_ASSERT(r, !p.compileProgram(srcOnly, 1, &program));
+
+    void* ctxs[] = { &dst_ctx, &src_ctx };
+    REPORTER_ASSERT(r, p.compileProgram(ctxs, 2, &program));
+
+    // Filling the holes with other contexts runs the same stages over other memory.
+    uint32_t src2[4] = { 0x11223344, 0x55667788, 0x99aabbcc, 0xddeeff00 },
+             dst2[4] = { 0,0,0,0 };
+    SkRasterPipeline_MemoryCtx src2_ctx = { src2, 0 },
+                               dst2_ctx = { dst2, 0 };
+    void* ctxs2[] = { &dst2_ctx, &src2_ctx };
+
+    SkSTArenaAlloc<256> alloc;
+    program.instantiate(&alloc, ctxs)(0,0,4,1);
+    program.instantiate(&alloc, ctxs2)(0,0,4,1);
+
+    auto swap_rb = [](uint32_t c) {
+        return (c & 0xff00ff00) | (c >> 16 & 0xff) | (c & 0xff) << 16;
+    };
+    for (int i = 0; i < 4; i++) {
+        REPORTER_ASSERT(r, dst [i] == swap_rb(src [i]));
+        REPORTER_ASSERT(r, dst2[i] == swap_rb(src2[i]));
+    }
+}
+
+DEF_TEST(SkRasterPipeline_blitter_program_cache, r) {
+    // Draws many paints that share stages but not colors, shader matrices, or coverage, so most
+    // blit pipelines come from the program cache once it's warm.
+    auto draw = [](SkColorType ct, bool useProgramCache) {
+        SkImageInfo info = SkImageInfo::Make(64, 64, ct, kPremul_SkAlphaType);
+        SkBitmap bm;
+        bm.allocPixels(info);
+        bm.eraseColor(SK_ColorWHITE);
+        const SkRasterClip clip(info.bounds());
+        for (int i = 0; i < 40; i++) {
+            SkPaint paint;
+            paint.setColor(SkColorSetARGB(0x40 + 4*i, 6*i, 255 - 5*i, 3*i));
+            if (i % 3 == 0) {
+                const SkPoint pts[] = {{0, 0}, {(float)i, 64}};
+                const SkColor colors[] = {SK_ColorRED, SkColorSetA(SK_ColorBLUE, 4*i)};
+                paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                             SkTileMode::kClamp));
+            }
+            if (i % 5 == 0) {
+                paint.setBlendMode(SkBlendMode::kMultiply);
+            }
+            SkSTArenaAlloc<2048> alloc;
+            SkBlitter* blitter = SkCreateRasterPipelineBlitter(bm.pixmap(), paint, SkMatrix::I(),
+                                                               &alloc, useProgramCache);
+            const SkRect rect = SkRect::MakeXYWH(i * 1.3f, i * 0.7f, 20.5f, 9.25f);
+            SkPath circle;
+            circle.addCircle(i * 1.5f, 64 - i * 1.5f, 6.0f + i % 7);
+            if (i % 2 == 0) {
+                SkScan::AntiFillRect(rect, clip, blitter);
+                SkScan::AntiFillPath(circle, clip, blitter);
+            } else {
+                SkScan::FillRect(rect, clip, blitter);
+                SkScan::FillPath(circle, clip, blitter);
+            }
+        }
+        return bm;
+    };
+
+    for (SkColorType ct : { kRGBA_8888_SkColorType, kRGB_565_SkColorType,
+                            kRGBA_F16_SkColorType }) {
+        SkBitmap expected = draw(ct, false);
+        for (int run = 0; run < 2; run++) {
+            SkBitmap actual = draw(ct, true);
+            REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                           expected.computeByteSize()), "color type %d", ct);
+        }
+    }
+}
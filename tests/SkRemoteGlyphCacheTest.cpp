@@ -9,6 +9,7 @@
 #include "SkDraw.h"
 #include "SkGraphics.h"
 #include "SkMutex.h"
+#include "SkOSPath.h"
 #include "SkRemoteGlyphCache.h"
 #include "SkRemoteGlyphCacheImpl.h"
 #include "SkStrike.h"
@@ -959,3 +960,221 @@ DEF_TEST(SkRemoteGlyphCache_ReWriteGlyph, reporter) {
     // Must unlock everything on termination, otherwise valgrind complains about memory leaks.
     discardableManager->unlockAndDeleteAll();
 }
+
+DEF_TEST(SkRemoteGlyphCache_SharedGlyphPool, reporter) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return;
+    }
+    SkString poolPath = SkOSPath::Join(tmpDir.c_str(), "shared_glyph_pool");
+    auto writer = SkSharedGlyphPool::MakeWriter(poolPath.c_str());
+    REPORTER_ASSERT(reporter, writer);
+    if (!writer) return;
+
+    sk_sp<DiscardableManager> discardableManager = sk_make_sp<DiscardableManager>();
+    auto serverTf = SkTypeface::MakeFromName("monospace", SkFontStyle());
+    const int glyphCount = 10;
+
+    SkFont font;
+    font.setSize(24);
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    SkPaint paint;
+    const SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+    const SkScalerContextFlags flags = SkScalerContextFlags::kFakeGammaAndBoostContrast;
+
+    // What the server rasterizes, to compare against.
+    std::vector<std::vector<uint8_t>> expectedImages(glyphCount);
+    {
+        SkAutoDescriptor ad;
+        SkScalerContextRec rec;
+        SkScalerContextEffects effects;
+        font.setTypeface(serverTf);
+        SkScalerContext::MakeRecAndEffects(font, paint, props, flags, SkMatrix::I(),
+                                           &rec, &effects);
+        auto desc = SkScalerContext::AutoDescriptorGivenRecAndEffects(rec, effects, &ad);
+        auto context = serverTf->createScalerContext(effects, desc, false);
+        for (SkGlyphID id = 0; id < glyphCount; ++id) {
+            SkGlyph glyph{SkPackedGlyphID(id)};
+            context->getMetrics(&glyph);
+            expectedImages[id].resize(glyph.computeImageSize());
+            glyph.fImage = expectedImages[id].data();
+            context->getImage(glyph);
+        }
+    }
+
+    // Two servers, standing in for the connections to two clients, share the writer. The second
+    // finds every glyph already in the pool.
+    size_t poolSize = 0;
+    for (int i = 0; i < 2; ++i) {
+        SkStrikeServer server(discardableManager.get());
+        server.setGlyphPool(writer);
+        auto tfData = server.serializeTypeface(serverTf.get());
+
+        font.setTypeface(serverTf);
+        SkScalerContextEffects effects;
+        auto* cacheState = server.getOrCreateCache(paint, font, props, SkMatrix::I(), flags,
+                                                   &effects);
+        for (SkGlyphID id = 0; id < glyphCount; ++id) {
+            cacheState->addGlyph(SkPackedGlyphID(id), false);
+            cacheState->addGlyph(SkPackedGlyphID(id), true);
+        }
+        std::vector<uint8_t> serverStrikeData;
+        server.writeStrikeData(&serverStrikeData);
+        if (i == 0) {
+            poolSize = writer->size();
+            REPORTER_ASSERT(reporter, poolSize > 0);
+        }
+        REPORTER_ASSERT(reporter, writer->size() == poolSize);
+
+        // A client without the pool can't use the data.
+        {
+            SkStrikeCache strikeCache;
+            SkStrikeClient client(discardableManager, false, &strikeCache);
+            client.deserializeTypeface(tfData->data(), tfData->size());
+            REPORTER_ASSERT(reporter, !client.readStrikeData(serverStrikeData.data(),
+                                                             serverStrikeData.size()));
+        }
+
+        auto reader = SkSharedGlyphPool::MakeReader(poolPath.c_str());
+        REPORTER_ASSERT(reporter, reader);
+        if (!reader) break;
+        SkStrikeCache strikeCache;
+        SkStrikeClient client(discardableManager, false, &strikeCache);
+        client.setGlyphPool(reader);
+        auto clientTf = client.deserializeTypeface(tfData->data(), tfData->size());
+        REPORTER_ASSERT(reporter, client.readStrikeData(serverStrikeData.data(),
+                                                        serverStrikeData.size()));
+        REPORTER_ASSERT(reporter, reader->size() == poolSize);
+
+        SkAutoDescriptor ad;
+        SkScalerContextRec rec;
+        font.setTypeface(clientTf);
+        SkScalerContext::MakeRecAndEffects(font, paint, props, flags, SkMatrix::I(),
+                                           &rec, &effects);
+        auto desc = SkScalerContext::AutoDescriptorGivenRecAndEffects(rec, effects, &ad);
+        auto strike = strikeCache.findStrikeExclusive(*desc);
+        REPORTER_ASSERT(reporter, strike);
+        if (!strike) break;
+
+        for (SkGlyphID id = 0; id < glyphCount; ++id) {
+            const SkGlyph* glyph = strike->getRawGlyphByID(SkPackedGlyphID(id));
+            const auto& expected = expectedImages[id];
+            REPORTER_ASSERT(reporter, glyph->computeImageSize() == expected.size());
+            if (expected.empty()) continue;
+
+            // The image was not copied out of the pool.
+            const void* poolData;
+            auto mapping = reader->read(0, poolSize, 1, &poolData);
+            REPORTER_ASSERT(reporter, mapping);
+            auto image = static_cast<const uint8_t*>(glyph->fImage);
+            REPORTER_ASSERT(reporter, image >= mapping->bytes() &&
+                                      image + expected.size() <= mapping->bytes() + poolSize);
+            REPORTER_ASSERT(reporter, !memcmp(image, expected.data(), expected.size()),
+                            "glyph %d", id);
+            REPORTER_ASSERT(reporter, glyph->fPathData != nullptr);
+        }
+        strikeCache.validateGlyphCacheDataSize();
+    }
+
+    // Must unlock everything on termination, otherwise valgrind complains about memory leaks.
+    discardableManager->unlockAndDeleteAll();
+}
+
+DEF_TEST(SkRemoteGlyphCache_SharedGlyphPoolLimit, reporter) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return;
+    }
+
+    sk_sp<DiscardableManager> discardableManager = sk_make_sp<DiscardableManager>();
+    auto serverTf = SkTypeface::MakeFromName("monospace", SkFontStyle());
+    const int glyphCount = 10;
+
+    SkFont font;
+    font.setSize(24);
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    SkPaint paint;
+    const SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+    const SkScalerContextFlags flags = SkScalerContextFlags::kFakeGammaAndBoostContrast;
+
+    auto serialize = [&](sk_sp<SkSharedGlyphPool> pool, std::vector<uint8_t>* strikeData) {
+        SkStrikeServer server(discardableManager.get());
+        server.setGlyphPool(std::move(pool));
+        auto tfData = server.serializeTypeface(serverTf.get());
+        font.setTypeface(serverTf);
+        SkScalerContextEffects effects;
+        auto* cacheState = server.getOrCreateCache(paint, font, props, SkMatrix::I(), flags,
+                                                   &effects);
+        for (SkGlyphID id = 0; id < glyphCount; ++id) {
+            cacheState->addGlyph(SkPackedGlyphID(id), false);
+        }
+        server.writeStrikeData(strikeData);
+        return tfData;
+    };
+
+    // How big the pool grows with no limit to speak of.
+    SkString fullPath = SkOSPath::Join(tmpDir.c_str(), "shared_glyph_pool_full");
+    auto full = SkSharedGlyphPool::MakeWriter(fullPath.c_str());
+    REPORTER_ASSERT(reporter, full);
+    if (!full) return;
+    std::vector<uint8_t> fullStrikeData;
+    serialize(full, &fullStrikeData);
+    const size_t fullSize = full->size();
+    REPORTER_ASSERT(reporter, fullSize > 0);
+
+    // With half that, the pool stops short of the limit and the rest of the glyphs are inline.
+    SkString path = SkOSPath::Join(tmpDir.c_str(), "shared_glyph_pool_limited");
+    auto writer = SkSharedGlyphPool::MakeWriter(path.c_str(), fullSize / 2);
+    REPORTER_ASSERT(reporter, writer);
+    if (!writer) return;
+    std::vector<uint8_t> serverStrikeData;
+    auto tfData = serialize(writer, &serverStrikeData);
+    REPORTER_ASSERT(reporter, writer->size() <= fullSize / 2);
+
+    auto reader = SkSharedGlyphPool::MakeReader(path.c_str());
+    REPORTER_ASSERT(reporter, reader);
+    if (!reader) return;
+    SkStrikeCache strikeCache;
+    SkStrikeClient client(discardableManager, false, &strikeCache);
+    client.setGlyphPool(reader);
+    auto clientTf = client.deserializeTypeface(tfData->data(), tfData->size());
+    REPORTER_ASSERT(reporter, client.readStrikeData(serverStrikeData.data(),
+                                                    serverStrikeData.size()));
+
+    SkAutoDescriptor ad;
+    SkScalerContextRec rec;
+    SkScalerContextEffects effects;
+    font.setTypeface(serverTf);
+    SkScalerContext::MakeRecAndEffects(font, paint, props, flags, SkMatrix::I(), &rec, &effects);
+    auto serverDesc = SkScalerContext::AutoDescriptorGivenRecAndEffects(rec, effects, &ad);
+    auto context = serverTf->createScalerContext(effects, serverDesc, false);
+
+    SkAutoDescriptor clientAd;
+    font.setTypeface(clientTf);
+    SkScalerContext::MakeRecAndEffects(font, paint, props, flags, SkMatrix::I(), &rec, &effects);
+    auto clientDesc = SkScalerContext::AutoDescriptorGivenRecAndEffects(rec, effects, &clientAd);
+    auto strike = strikeCache.findStrikeExclusive(*clientDesc);
+    REPORTER_ASSERT(reporter, strike);
+    if (!strike) return;
+
+    // Every glyph arrives, whether from the pool or inline.
+    for (SkGlyphID id = 0; id < glyphCount; ++id) {
+        SkGlyph expected{SkPackedGlyphID(id)};
+        context->getMetrics(&expected);
+        std::vector<uint8_t> expectedImage(expected.computeImageSize());
+        expected.fImage = expectedImage.data();
+        context->getImage(expected);
+
+        const SkGlyph* glyph = strike->getRawGlyphByID(SkPackedGlyphID(id));
+        REPORTER_ASSERT(reporter, glyph->computeImageSize() == expectedImage.size());
+        if (expectedImage.empty()) continue;
+        REPORTER_ASSERT(reporter, glyph->fImage &&
+                                  !memcmp(glyph->fImage, expectedImage.data(),
+                                          expectedImage.size()),
+                        "glyph %d", id);
+    }
+    strikeCache.validateGlyphCacheDataSize();
+
+    // Must unlock everything on termination, otherwise valgrind complains about memory leaks.
+    discardableManager->unlockAndDeleteAll();
+}
@@ -10,6 +10,7 @@
 #include "SkBitmapProvider.h"
 #include "SkCanvas.h"
 #include "SkDiscardableMemoryPool.h"
+#include "SkExecutor.h"
 #include "SkGraphics.h"
 #include "SkMakeUnique.h"
 #include "SkMipMap.h"
@@ -17,6 +18,10 @@
 #include "SkPictureRecorder.h"
 #include "SkResourceCache.h"
 #include "SkSurface.h"
+#include "SkTaskGroup.h"
+
+#include <atomic>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////////////
 
@@ -291,3 +296,62 @@ DEF_TEST(ResourceCache_purge, reporter) {
         }
     }
 }
+
+static constexpr int kThreadedSharedID = 0xC0DE;
+
+static bool find_data_visitor(const SkResourceCache::Rec& baseRec, void* context) {
+    int* data = static_cast<int*>(context);
+    *data = static_cast<const TestRec&>(baseRec).fKey.fData;
+    return true;
+}
+
+static void count_threaded_visitor(const SkResourceCache::Rec& baseRec, void* context) {
+    const TestRec* rec = static_cast<const TestRec*>(&baseRec);
+    if (rec->fKey.getNamespace() == &gTestNamespace &&
+        rec->fKey.getSharedID() == kThreadedSharedID) {
+        *static_cast<int*>(context) += 1;
+    }
+}
+
+/*
+ *  Add to and find in the global cache from several threads at once.
+ */
+DEF_TEST(ResourceCache_threaded, reporter) {
+    constexpr int kThreads = 4;
+    constexpr int kRecsPerThread = 256;
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(kThreads);
+    std::vector<int> flags(kThreads * kRecsPerThread, 0);
+    std::atomic<int> found{0};
+
+    SkTaskGroup(*executor).batch(kThreads, [&](int thread) {
+        for (int i = 0; i < kRecsPerThread; ++i) {
+            const int data = thread * kRecsPerThread + i;
+            auto rec = skstd::make_unique<TestRec>(kThreadedSharedID, data, &flags[data]);
+            rec->fCanBePurged = true;
+            SkResourceCache::Add(rec.release());
+
+            // Unless something else has filled the cache since, we find what we just added.
+            int foundData = -1;
+            if (SkResourceCache::Find(TestKey(kThreadedSharedID, data), find_data_visitor,
+                                      &foundData)) {
+                REPORTER_ASSERT(reporter, foundData == data);
+                found++;
+            }
+        }
+    });
+    REPORTER_ASSERT(reporter, found > 0);
+    for (int f : flags) {
+        REPORTER_ASSERT(reporter, f & TestRec::kDidInstall);
+    }
+
+    int count = 0;
+    SkResourceCache::VisitAll(count_threaded_visitor, &count);
+    REPORTER_ASSERT(reporter, count <= kThreads * kRecsPerThread);
+
+    // Our recs can all be purged, from every shard.
+    SkResourceCache::PurgeAll();
+    count = 0;
+    SkResourceCache::VisitAll(count_threaded_visitor, &count);
+    REPORTER_ASSERT(reporter, 0 == count);
+}
@@ -40,6 +40,22 @@ void test(skiatest::Reporter* r, const char* src, float inR, float inG, float in
         REPORTER_ASSERT(r, inoutColor[1] == expectedG);
         REPORTER_ASSERT(r, inoutColor[2] == expectedB);
         REPORTER_ASSERT(r, inoutColor[3] == expectedA);
+
+        // Every lane of the striped interpreter should produce the same result.
+        constexpr int W = SkSL::Interpreter::VECTOR_WIDTH;
+        float in[4] = { inR, inG, inB, inA };
+        float striped[4 * W];
+        for (int c = 0; c < 4; ++c) {
+            for (int i = 0; i < W; ++i) {
+                striped[c * W + i] = in[c];
+            }
+        }
+        interpreter.runStriped(*main, W, (SkSL::Interpreter::Value*) striped, W, nullptr);
+        for (int c = 0; c < 4; ++c) {
+            for (int i = 0; i < W; ++i) {
+                REPORTER_ASSERT(r, striped[c * W + i] == inoutColor[c]);
+            }
+        }
     } else {
         printf("%s\n%s", src, compiler.errorText().c_str());
     }
@@ -198,3 +214,61 @@ DEF_TEST(SkSLInterpreterGlobal, r) {
     test(r, "int x; void main(inout half4 color) { x = 10; color.b = x; }", 1, 2, 3, 4, 1, 2, 10,
          4);
 }
+
+DEF_TEST(SkSLInterpreterStriped, r) {
+    // Lanes are given different colors so that they disagree on branches and loop trip counts.
+    const char* srcs[] = {
+        "void main(inout half4 color) { if (color.r > color.g) color.a = 1; else color.a = 2; }",
+        "void main(inout half4 color) { while (color.r < 5) color.r += 0.75; }",
+        "void main(inout half4 color) { while (true) { color.r += 0.5; "
+        "if (color.r > color.g) break; if (color.b > 1) continue; color.a += 1; } }",
+        "void main(inout half4 color) { do { color.g -= 1; color.a += color.g; } "
+        "while (color.g > color.r); }",
+        "void main(inout half4 color) {"
+        "    for (int i = 0; i < int(color.g); ++i) {"
+        "        if (i == int(color.b)) continue;"
+        "        for (int j = 0; j < i; ++j) color.r += j;"
+        "    }"
+        "}",
+    };
+    constexpr int W = SkSL::Interpreter::VECTOR_WIDTH;
+
+    for (const char* src : srcs) {
+        SkSL::Compiler compiler;
+        std::unique_ptr<SkSL::Program> program = compiler.convertProgram(
+                SkSL::Program::kPipelineStage_Kind, SkSL::String(src), SkSL::Program::Settings());
+        REPORTER_ASSERT(r, program);
+        if (!program) {
+            printf("%s\n%s", src, compiler.errorText().c_str());
+            continue;
+        }
+        std::unique_ptr<SkSL::ByteCode> byteCode = compiler.toByteCode(*program);
+        REPORTER_ASSERT(r, !compiler.errorCount());
+        SkSL::ByteCodeFunction* main = byteCode->fFunctions[0].get();
+        SkSL::Interpreter interpreter(std::move(program), std::move(byteCode));
+
+        for (int N : { 1, 3, W }) {
+            float expected[4 * W],
+                  striped[4 * W];
+            for (int i = 0; i < N; ++i) {
+                float color[4] = { i * 0.5f, 8.0f - i, (float) (i % 3), 0 };
+                for (int c = 0; c < 4; ++c) {
+                    striped[c * W + i] = color[c];
+                }
+                interpreter.run(*main, (SkSL::Interpreter::Value*) color, nullptr);
+                for (int c = 0; c < 4; ++c) {
+                    expected[c * W + i] = color[c];
+                }
+            }
+            interpreter.runStriped(*main, N, (SkSL::Interpreter::Value*) striped, W, nullptr);
+            for (int c = 0; c < 4; ++c) {
+                for (int i = 0; i < N; ++i) {
+                    if (striped[c * W + i] != expected[c * W + i]) {
+                        ERRORF(r, "%s\n    lane %d channel %d: expected %f, got %f", src, i, c,
+                               expected[c * W + i], striped[c * W + i]);
+                    }
+                }
+            }
+        }
+    }
+}
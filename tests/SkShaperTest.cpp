@@ -0,0 +1,90 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#if defined(SK_USING_SKSHAPER) && defined(SK_SHAPER_HARFBUZZ_AVAILABLE)
+
+#include "SkData.h"
+#include "SkFont.h"
+#include "SkSerialProcs.h"
+#include "SkShaper.h"
+#include "SkTextBlob.h"
+#include "ToolUtils.h"
+#include "../modules/skshaper/src/SkShaperPriv.h"
+
+#include <string.h>
+
+static sk_sp<SkData> shape(SkShaper* shaper, const char* utf8, const SkFont& font) {
+    SkTextBlobBuilderRunHandler handler(utf8, {0, 0});
+    shaper->shape(utf8, strlen(utf8), font, true, 100, &handler);
+    sk_sp<SkTextBlob> blob = handler.makeBlob();
+    return blob ? blob->serialize(SkSerialProcs()) : SkData::MakeEmpty();
+}
+
+// Other tests shape text on other threads through the same cache, so this only checks what holds
+// however their lookups interleave with ours, and leaves the cache's limit alone.
+DEF_TEST(SkShaper_ShapedRunCache, r) {
+    const char* kText = "Shaped once, then (most likely) found in the cache every time after.";
+    SkFont font(ToolUtils::create_portable_typeface(), 14);
+    std::unique_ptr<SkShaper> shaper = SkShaper::MakeShapeThenWrap();
+
+    SkShaper::ShapedRunCacheStats before = SkShaper::GetShapedRunCacheStats();
+    sk_sp<SkData> first = shape(shaper.get(), kText, font);
+    SkShaper::ShapedRunCacheStats between = SkShaper::GetShapedRunCacheStats();
+    sk_sp<SkData> second = shape(shaper.get(), kText, font);
+    SkShaper::ShapedRunCacheStats after = SkShaper::GetShapedRunCacheStats();
+
+    // Whether the runs come from HarfBuzz or from the cache, they come out the same.
+    REPORTER_ASSERT(r, first->equals(second.get()));
+
+    for (const SkShaper::ShapedRunCacheStats& stats : { before, between, after }) {
+        REPORTER_ASSERT(r, stats.fBytesUsed <= stats.fByteLimit);
+        REPORTER_ASSERT(r, stats.fCount >= 0 && (stats.fCount > 0) == (stats.fBytesUsed > 0));
+    }
+    // Each shaping looks its runs up, and the counts only ever grow.
+    if (before.fByteLimit > 0 && between.fByteLimit > 0) {
+        REPORTER_ASSERT(r, between.fHits + between.fMisses > before.fHits + before.fMisses);
+    }
+    if (between.fByteLimit > 0 && after.fByteLimit > 0) {
+        REPORTER_ASSERT(r, after.fHits + after.fMisses > between.fHits + between.fMisses);
+    }
+    REPORTER_ASSERT(r, after.fHits >= between.fHits && between.fHits >= before.fHits);
+    REPORTER_ASSERT(r, after.fMisses >= between.fMisses && between.fMisses >= before.fMisses);
+}
+
+// A cache of its own shows exactly what the second shaping finds.
+DEF_TEST(SkShaper_OwnShapedRunCache, r) {
+    const char* kText = "Shaped once, then found in the cache every time after.";
+    SkFont font(ToolUtils::create_portable_typeface(), 14);
+
+    std::unique_ptr<SkShaper> uncached =
+            SkShaperPriv::MakeShapeThenWrapWithOwnRunCache(0, nullptr);
+    sk_sp<SkData> expected = shape(uncached.get(), kText, font);
+
+    SkShaper::ShapedRunCacheStats stats;
+    memset(&stats, 0, sizeof(stats));
+    std::unique_ptr<SkShaper> shaper =
+            SkShaperPriv::MakeShapeThenWrapWithOwnRunCache(1024 * 1024, &stats);
+
+    sk_sp<SkData> first = shape(shaper.get(), kText, font);
+    const SkShaper::ShapedRunCacheStats afterFirst = stats;
+    REPORTER_ASSERT(r, first->equals(expected.get()));
+    REPORTER_ASSERT(r, 0 == afterFirst.fHits);
+    REPORTER_ASSERT(r, afterFirst.fMisses > 0);
+    REPORTER_ASSERT(r, afterFirst.fCount == (int)afterFirst.fMisses);
+    REPORTER_ASSERT(r, afterFirst.fBytesUsed > 0);
+
+    // Every run is found this time, and comes out as HarfBuzz shaped it.
+    sk_sp<SkData> second = shape(shaper.get(), kText, font);
+    REPORTER_ASSERT(r, second->equals(expected.get()));
+    REPORTER_ASSERT(r, stats.fHits == afterFirst.fMisses);
+    REPORTER_ASSERT(r, stats.fMisses == afterFirst.fMisses);
+    REPORTER_ASSERT(r, stats.fCount == afterFirst.fCount);
+}
+
+#endif
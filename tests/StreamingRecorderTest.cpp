@@ -0,0 +1,127 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkDrawable.h"
+#include "SkExecutor.h"
+#include "SkPath.h"
+#include "SkPictureRecorder.h"
+#include "SkSemaphore.h"
+#include "SkStreamingRecorder.h"
+#include "Test.h"
+
+namespace {
+
+class CircleDrawable : public SkDrawable {
+    SkRect onGetBounds() override { return SkRect::MakeWH(20, 20); }
+    void onDraw(SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setColor(SK_ColorMAGENTA);
+        canvas->drawCircle(10, 10, 8, paint);
+    }
+};
+
+}  // namespace
+
+static void draw_scene(SkCanvas* canvas) {
+    SkPictureRecorder recorder;
+    SkCanvas* picCanvas = recorder.beginRecording(SkRect::MakeWH(16, 16));
+    picCanvas->drawColor(SK_ColorCYAN);
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+    sk_sp<SkDrawable> drawable = sk_make_sp<CircleDrawable>();
+
+    SkPaint paint;
+    canvas->clear(SK_ColorWHITE);
+    for (int i = 0; i < 200; i++) {
+        // Saves, clips and matrices straddle chunk boundaries.
+        canvas->save();
+        canvas->translate(SkIntToScalar(i % 20) * 6, SkIntToScalar(i / 20) * 12);
+        canvas->clipRect(SkRect::MakeWH(40, 10));
+        paint.setColor(0xFF000000 | (i * 0x10305));
+        canvas->drawRect(SkRect::MakeXYWH(1, 1, 8, 8), paint);
+        if (i % 7 == 0) {
+            canvas->drawPicture(picture);
+        }
+        canvas->restore();
+    }
+
+    canvas->save();
+    canvas->setMatrix(SkMatrix::MakeTrans(50, 60));
+    canvas->drawDrawable(drawable.get());
+    canvas->restore();
+
+    SkPath path;
+    path.moveTo(10, 110);
+    path.cubicTo(40, 150, 80, 70, 120, 120);
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+    canvas->drawPath(path, paint);
+
+    // Left unbalanced on purpose; finish() restores it.
+    canvas->save();
+    canvas->scale(2, 2);
+    canvas->drawRect(SkRect::MakeXYWH(50, 50, 10, 10), paint);
+}
+
+static void check_streaming(skiatest::Reporter* r, SkExecutor* executor,
+                            const SkStreamingRecorder::Options& options) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(128, 128);
+
+    SkBitmap expected;
+    expected.allocPixels(info);
+    {
+        SkCanvas canvas(expected);
+        canvas.translate(3, 5);
+        draw_scene(&canvas);
+    }
+
+    SkBitmap actual;
+    actual.allocPixels(info);
+    SkCanvas canvas(actual);
+    canvas.translate(3, 5);
+    {
+        SkStreamingRecorder streamer(&canvas, SkRect::MakeWH(128, 128), executor, options);
+        draw_scene(streamer.getRecordingCanvas());
+        streamer.finish();
+        REPORTER_ASSERT(r, !streamer.getRecordingCanvas());
+    }
+    REPORTER_ASSERT(r, 1 == canvas.getSaveCount());
+    REPORTER_ASSERT(r, canvas.getTotalMatrix() == SkMatrix::MakeTrans(3, 5));
+
+    REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                   expected.computeByteSize()));
+}
+
+DEF_TEST(StreamingRecorder, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+
+    SkStreamingRecorder::Options options;
+    check_streaming(r, executor.get(), options);
+    check_streaming(r, nullptr, options);
+
+    // Tiny chunks, and a memory limit small enough that the recorder must wait for playback.
+    options.fOpsPerChunk = 3;
+    options.fMemoryLimit = 2048;
+    check_streaming(r, executor.get(), options);
+    check_streaming(r, nullptr, options);
+
+    // A limit smaller than any chunk still makes progress, one chunk at a time.
+    options.fOpsPerChunk = 1;
+    options.fMemoryLimit = 1;
+    check_streaming(r, executor.get(), options);
+
+    // Recording on the executor's only thread still makes progress: while it waits for
+    // playback, the recording thread runs the playback itself.
+    std::unique_ptr<SkExecutor> single = SkExecutor::MakeFIFOThreadPool(1);
+    SkSemaphore done;
+    single->add([&] {
+        check_streaming(r, single.get(), options);
+        done.signal();
+    });
+    done.wait();
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkExecutor.h"
+#include "SkFont.h"
+#include "SkStrikeCache.h"
+#include "SkTaskGroup.h"
+#include "SkTypeface.h"
+#include "Test.h"
+#include "ToolUtils.h"
+
+#include <vector>
+
+static SkExclusiveStrikePtr find_or_create(SkStrikeCache* cache, SkScalar size) {
+    SkFont font;
+    font.setSize(size);
+
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I(), &ad, &effects);
+    return cache->findOrCreateStrikeExclusive(*desc, effects, *font.getTypefaceOrDefault());
+}
+
+DEF_TEST(StrikeCache_CountBudget, r) {
+    constexpr int kLimit = 20;
+    SkStrikeCache cache;
+    cache.setCacheCountLimit(kLimit);
+
+    // These land in many different shards; the budget still applies to all of them together.
+    for (int i = 0; i < 10 * kLimit; ++i) {
+        auto strike = find_or_create(&cache, 8 + 0.25f * i);
+        REPORTER_ASSERT(r, strike);
+        REPORTER_ASSERT(r, cache.getCacheCountUsed() <= kLimit);
+    }
+    REPORTER_ASSERT(r, cache.getCacheCountUsed() > 0);
+    cache.validate();
+
+    // The most recently used strike is found again rather than recreated.
+    SkStrike* last;
+    {
+        auto strike = find_or_create(&cache, 8 + 0.25f * (10 * kLimit - 1));
+        last = strike.get();
+    }
+    {
+        auto strike = find_or_create(&cache, 8 + 0.25f * (10 * kLimit - 1));
+        REPORTER_ASSERT(r, strike.get() == last);
+    }
+
+    cache.purgeAll();
+    REPORTER_ASSERT(r, 0 == cache.getCacheCountUsed());
+    REPORTER_ASSERT(r, 0 == cache.getTotalMemoryUsed());
+    cache.validate();
+}
+
+DEF_TEST(StrikeCache_PurgeKeepsRecent, r) {
+    constexpr int kLimit = 20;
+    SkStrikeCache cache;
+    cache.setCacheCountLimit(kLimit);
+
+    for (int i = 0; i < kLimit; ++i) {
+        find_or_create(&cache, 8 + i);
+    }
+    REPORTER_ASSERT(r, kLimit == cache.getCacheCountUsed());
+
+    // One more goes over budget; the purge takes a quarter of the cache, oldest first, whichever
+    // shards those strikes are in.
+    find_or_create(&cache, 8 + kLimit);
+    const int kept = kLimit + 1 - (kLimit + 1) / 4;
+    REPORTER_ASSERT(r, kept == cache.getCacheCountUsed());
+
+    // Every recent strike is still there, so finding them all creates nothing new.
+    for (int i = kLimit; i > kLimit - kept; --i) {
+        REPORTER_ASSERT(r, find_or_create(&cache, 8 + i));
+        REPORTER_ASSERT(r, kept == cache.getCacheCountUsed(), "size %d", 8 + i);
+    }
+    cache.validate();
+}
+
+DEF_TEST(StrikeCache_Threaded, r) {
+    constexpr int kLimit = 64;
+    SkStrikeCache cache;
+    cache.setCacheCountLimit(kLimit);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(8);
+    SkTaskGroup(*executor).batch(32, [&](int task) {
+        for (int i = 0; i < 200; ++i) {
+            // Overlapping sizes, so tasks both share strikes and evict each other's.
+            auto strike = find_or_create(&cache, 8 + (task * 7 + i) % 100);
+            SkASSERT(strike);
+            strike->getGlyphIDMetrics(i % 50);
+        }
+    });
+
+    // A thread skips purging while another one is already at it, so the budget may be briefly
+    // exceeded. It is enforced again by the next purge.
+    cache.setCacheCountLimit(kLimit);
+    REPORTER_ASSERT(r, cache.getCacheCountUsed() <= kLimit);
+    cache.validate();
+    cache.validateGlyphCacheDataSize();
+}
+
+DEF_TEST(StrikeCache_PrefetchImages, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    for (auto typeface : { ToolUtils::create_portable_typeface(), SkTypeface::MakeDefault() }) {
+        SkFont font(typeface, 18);
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        font.setSubpixel(true);
+
+        // Enough glyphs to be split between threads, with repeats and subpixel positions.
+        std::vector<SkGlyphID> glyphs;
+        std::vector<SkPoint> positions;
+        for (int i = 0; i < 400; ++i) {
+            glyphs.push_back(font.unicharToGlyph(' ' + i % 95));
+            positions.push_back({0.25f * i, 10});
+        }
+
+        auto make_strike = [&](SkStrikeCache* cache) {
+            SkAutoDescriptor ad;
+            SkScalerContextEffects effects;
+            auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+                    font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                    SkScalerContextFlags::kNone, SkMatrix::I(), &ad, &effects);
+            return cache->findOrCreateStrikeExclusive(*desc, effects, *typeface);
+        };
+
+        SkStrikeCache lazyCache, prefetchCache;
+        auto lazy = make_strike(&lazyCache);
+        auto prefetched = make_strike(&prefetchCache);
+        prefetched->prefetchImages(SkSpan<const SkGlyphID>(glyphs.data(), glyphs.size()),
+                                   SkSpan<const SkPoint>(positions.data(), positions.size()),
+                                   executor.get());
+
+        for (size_t i = 0; i < glyphs.size(); ++i) {
+            const SkGlyph& expected = lazy->getGlyphMetrics(glyphs[i], positions[i]);
+            const SkGlyph& actual = prefetched->getGlyphMetrics(glyphs[i], positions[i]);
+            REPORTER_ASSERT(r, expected.getPackedID() == actual.getPackedID());
+            if (expected.isEmpty()) {
+                continue;
+            }
+            // Prefetching left nothing to do.
+            REPORTER_ASSERT(r, actual.fImage != nullptr);
+            const void* expectedImage = lazy->findImage(expected);
+            REPORTER_ASSERT(r, expected.computeImageSize() == actual.computeImageSize());
+            REPORTER_ASSERT(r, !memcmp(expectedImage, prefetched->findImage(actual),
+                                       expected.computeImageSize()), "glyph %d", glyphs[i]);
+        }
+        REPORTER_ASSERT(r, lazy->getMemoryUsed() == prefetched->getMemoryUsed());
+        prefetchCache.validateGlyphCacheDataSize();
+    }
+}
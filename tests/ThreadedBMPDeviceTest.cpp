@@ -0,0 +1,99 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkPath.h"
+#include "SkRRect.h"
+#include "SkThreadedBMPDevice.h"
+#include "Test.h"
+
+static void draw_scene(SkCanvas* canvas) {
+    canvas->clear(SK_ColorWHITE);
+
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    canvas->drawRect(SkRect::MakeXYWH(10, 10, 200, 150), paint);
+
+    canvas->save();
+    canvas->clipRect(SkRect::MakeXYWH(50, 40, 120, 300));
+    paint.setColor(0x8000FF00);
+    canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(20, 60, 220, 120), 16, 16), paint);
+    canvas->restore();
+
+    SkPath path;
+    path.moveTo(30, 250);
+    path.lineTo(240, 170);
+    path.lineTo(120, 310);
+    path.close();
+    paint.setColor(SK_ColorBLUE);
+    canvas->translate(7, 3);
+    canvas->drawPath(path, paint);
+
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(5);
+    paint.setColor(SK_ColorBLACK);
+    const SkPoint pts[] = { {0, 0}, {250, 300}, {250, 0} };
+    canvas->drawPoints(SkCanvas::kPolygon_PointMode, SK_ARRAY_COUNT(pts), pts, paint);
+
+    SkBitmap sprite;
+    sprite.allocN32Pixels(40, 70);
+    sprite.eraseColor(0xFF336699);
+    canvas->drawBitmap(sprite, 100, 120);
+}
+
+static void check_matches_raster(skiatest::Reporter* r, int tiles, SkExecutor* executor) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(256, 320);
+
+    SkBitmap expected;
+    expected.allocPixels(info);
+    SkCanvas expectedCanvas(expected);
+    draw_scene(&expectedCanvas);
+
+    SkBitmap actual;
+    actual.allocPixels(info);
+    {
+        SkCanvas canvas(sk_make_sp<SkThreadedBMPDevice>(actual, tiles, executor));
+        draw_scene(&canvas);
+        canvas.flush();
+    }
+
+    for (int y = 0; y < info.height(); ++y) {
+        for (int x = 0; x < info.width(); ++x) {
+            if (*expected.getAddr32(x, y) != *actual.getAddr32(x, y)) {
+                ERRORF(r, "%d tiles: mismatch at (%d, %d): 0x%08x vs 0x%08x", tiles, x, y,
+                       *expected.getAddr32(x, y), *actual.getAddr32(x, y));
+                return;
+            }
+        }
+    }
+}
+
+DEF_TEST(ThreadedBMPDevice, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (int tiles : { 1, 3, 8, 320, 1000 }) {
+        check_matches_raster(r, tiles, executor.get());
+    }
+    check_matches_raster(r, 4, nullptr);
+}
+
+DEF_TEST(ThreadedBMPDevice_ReadFlushes, r) {
+    SkBitmap bm;
+    bm.allocN32Pixels(64, 64);
+    bm.eraseColor(SK_ColorTRANSPARENT);
+
+    SkCanvas canvas(sk_make_sp<SkThreadedBMPDevice>(bm, 4));
+    canvas.drawColor(SK_ColorGREEN);
+
+    // readPixels must see the deferred draw without an explicit flush.
+    SkBitmap readback;
+    readback.allocN32Pixels(64, 64);
+    REPORTER_ASSERT(r, canvas.readPixels(readback, 0, 0));
+    REPORTER_ASSERT(r, *readback.getAddr32(0, 0) == SkPreMultiplyColor(SK_ColorGREEN));
+    REPORTER_ASSERT(r, *readback.getAddr32(63, 63) == SkPreMultiplyColor(SK_ColorGREEN));
+}
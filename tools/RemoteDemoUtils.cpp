@@ -0,0 +1,49 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "RemoteDemoUtils.h"
+
+#include <err.h>
+#include <unistd.h>
+
+bool write_SkData(int fd, const SkData& data) {
+    size_t size = data.size();
+    if (::write(fd, &size, sizeof(size)) != sizeof(size)) {
+        warn("Failed write %zu", size);
+        return false;
+    }
+
+    size_t totalWritten = 0;
+    while (totalWritten < size) {
+        ssize_t written = ::write(fd, data.bytes() + totalWritten, size - totalWritten);
+        if (written <= 0) {
+            warn("Failed write %zu", size);
+            return false;
+        }
+        totalWritten += written;
+    }
+    return true;
+}
+
+sk_sp<SkData> read_SkData(int fd) {
+    size_t size;
+    if (::read(fd, &size, sizeof(size)) != sizeof(size)) {
+        return nullptr;
+    }
+
+    auto out = SkData::MakeUninitialized(size);
+    auto data = (uint8_t*)out->writable_data();
+    size_t totalRead = 0;
+    while (totalRead < size) {
+        ssize_t sizeRead = ::read(fd, &data[totalRead], size - totalRead);
+        if (sizeRead <= 0) {
+            return nullptr;
+        }
+        totalRead += sizeRead;
+    }
+    return out;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef RemoteDemoUtils_DEFINED
+#define RemoteDemoUtils_DEFINED
+
+#include "SkData.h"
+#include "SkRemoteGlyphCache.h"
+
+// Pieces shared by remote_demo and shared_glyph_pool_demo, which run an SkStrikeServer and its
+// SkStrikeClients in different processes, talking over pipes.
+
+// Keeps every handle locked until purgeAll().
+class ServerDiscardableManager : public SkStrikeServer::DiscardableHandleManager {
+public:
+    SkDiscardableHandleId createHandle() override { return ++fNextHandleId; }
+    bool lockHandle(SkDiscardableHandleId handleId) override {
+        return handleId > fLastPurgedHandleId;
+    }
+    void purgeAll() { fLastPurgedHandleId = fNextHandleId; }
+
+private:
+    SkDiscardableHandleId fNextHandleId = 0u;
+    SkDiscardableHandleId fLastPurgedHandleId = 0u;
+};
+
+// Only lets strikes go while a ScopedPurgeCache is alive, and counts cache misses.
+class ClientDiscardableManager : public SkStrikeClient::DiscardableHandleManager {
+public:
+    class ScopedPurgeCache {
+    public:
+        ScopedPurgeCache(ClientDiscardableManager* manager) : fManager(manager) {
+            if (fManager) fManager->fAllowPurging = true;
+        }
+        ~ScopedPurgeCache() {
+            if (fManager) fManager->fAllowPurging = false;
+        }
+
+    private:
+        ClientDiscardableManager* fManager;
+    };
+
+    bool deleteHandle(SkDiscardableHandleId) override { return fAllowPurging; }
+    void notifyCacheMiss(SkStrikeClient::CacheMissType) override { fCacheMisses++; }
+
+    int cacheMisses() const { return fCacheMisses; }
+
+private:
+    bool fAllowPurging = false;
+    int  fCacheMisses = 0;
+};
+
+// Writes the size of data and then its bytes to fd. Returns false if that fails.
+bool write_SkData(int fd, const SkData& data);
+
+// Reads data written by write_SkData(), or returns nullptr if fd is closed or fails.
+sk_sp<SkData> read_SkData(int fd);
+
+#endif  // RemoteDemoUtils_DEFINED
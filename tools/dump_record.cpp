@@ -67,7 +67,7 @@ int main(int argc, char** argv) {
             SkRecordOptimize(&record);
         }
         if (FLAGS_optimize2) {
-            SkRecordOptimize2(&record);
+            SkRecordOptimize2(&record, src->cullRect());
         }
 
         dump(FLAGS_skps[i], w, h, record);
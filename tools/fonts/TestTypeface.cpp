@@ -14,6 +14,7 @@
 #include "SkFontPriv.h"
 #include "SkGlyph.h"
 #include "SkImageInfo.h"
+#include "SkMakeUnique.h"
 #include "SkMatrix.h"
 #include "SkOTUtils.h"
 #include "SkPaintPriv.h"
@@ -172,6 +173,12 @@ public:
         this->forceGenerateImageFromPath();
     }
 
+    // Everything comes from the typeface's paths, which never change.
+    std::unique_ptr<SkScalerContext> makeConcurrentContext(const SkDescriptor& desc) const override {
+        return skstd::make_unique<SkTestScalerContext>(
+                sk_ref_sp(this->getTestTypeface()), this->getEffects(), &desc);
+    }
+
 protected:
     TestTypeface* getTestTypeface() const {
         return static_cast<TestTypeface*>(this->getTypeface());
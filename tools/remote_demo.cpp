@@ -6,7 +6,6 @@
  */
 
 #include <chrono>
-#include <err.h>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -16,6 +15,7 @@
 #include <thread>
 #include <unistd.h>
 
+#include "RemoteDemoUtils.h"
 #include "SkGraphics.h"
 #include "SkRemoteGlyphCache.h"
 #include "SkScalerContext.h"
@@ -26,92 +26,6 @@ static bool gUseGpu = true;
 static bool gPurgeFontCaches = true;
 static bool gUseProcess = true;
 
-class ServerDiscardableManager : public SkStrikeServer::DiscardableHandleManager {
-public:
-    ServerDiscardableManager() = default;
-    ~ServerDiscardableManager() override = default;
-
-    SkDiscardableHandleId createHandle() override { return ++nextHandleId; }
-    bool lockHandle(SkDiscardableHandleId handleId) override {
-        return handleId > lastPurgedHandleId;
-    }
-    void purgeAll() { lastPurgedHandleId = nextHandleId; }
-
-private:
-    SkDiscardableHandleId nextHandleId = 0u;
-    SkDiscardableHandleId lastPurgedHandleId = 0u;
-};
-
-class ClientDiscardableManager : public SkStrikeClient::DiscardableHandleManager {
-public:
-    class ScopedPurgeCache {
-    public:
-        ScopedPurgeCache(ClientDiscardableManager* manager) : fManager(manager) {
-            if (fManager) fManager->allowPurging = true;
-        }
-        ~ScopedPurgeCache() {
-            if (fManager) fManager->allowPurging = false;
-        }
-
-    private:
-        ClientDiscardableManager* fManager;
-    };
-
-    ClientDiscardableManager() = default;
-    ~ClientDiscardableManager() override = default;
-
-    bool deleteHandle(SkDiscardableHandleId) override { return allowPurging; }
-
-private:
-    bool allowPurging = false;
-};
-
-static bool write_SkData(int fd, const SkData& data) {
-    size_t size = data.size();
-    ssize_t bytesWritten = ::write(fd, &size, sizeof(size));
-    if (bytesWritten < 0) {
-        err(1,"Failed write %zu", size);
-        return false;
-    }
-
-    bytesWritten = ::write(fd, data.data(), data.size());
-    if (bytesWritten < 0) {
-        err(1,"Failed write %zu", size);
-        return false;
-    }
-
-    return true;
-}
-
-static sk_sp<SkData> read_SkData(int fd) {
-    size_t size;
-    ssize_t readSize = ::read(fd, &size, sizeof(size));
-    if (readSize <= 0) {
-        if (readSize < 0) {
-            err(1, "Failed read %zu", size);
-        }
-        return nullptr;
-    }
-
-    auto out = SkData::MakeUninitialized(size);
-    auto data = (uint8_t*)out->data();
-
-    size_t totalRead = 0;
-    while (totalRead < size) {
-        ssize_t sizeRead;
-        sizeRead = ::read(fd, &data[totalRead], size - totalRead);
-        if (sizeRead <= 0) {
-            if (readSize < 0) {
-                err(1, "Failed read %zu", size);
-            }
-            return nullptr;
-        }
-        totalRead += sizeRead;
-    }
-
-    return out;
-}
-
 class Timer {
 public:
     void start() {
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// Runs a SkStrikeServer in this process and several SkStrikeClients in child processes, all
+// sharing one SkSharedGlyphPool, and checks that every client draws the same text as the server.
+//
+//     shared_glyph_pool_demo [client count] [pool file]
+
+#include <err.h>
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include "RemoteDemoUtils.h"
+#include "SkCanvas.h"
+#include "SkFont.h"
+#include "SkGraphics.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkRemoteGlyphCache.h"
+#include "SkSurface.h"
+#include "SkTextBlob.h"
+
+static constexpr int kWidth  = 640;
+static constexpr int kHeight = 480;
+
+// Several sizes of the same text, so that clients have a few strikes each.
+static sk_sp<SkPicture> make_text_picture() {
+    static const char kText[] = "The quick brown fox jumps over the lazy dog. 0123456789";
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(kWidth, kHeight);
+    canvas->clear(SK_ColorWHITE);
+    SkPaint paint;
+    SkFont font;
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    SkScalar y = 0;
+    for (SkScalar size : { 10, 12, 14, 18, 24, 32, 48 }) {
+        font.setSize(size);
+        y += size * 1.25f;
+        auto blob = SkTextBlob::MakeFromString(kText, font);
+        canvas->drawTextBlob(blob.get(), 10, y, paint);
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+static sk_sp<SkData> rasterize(const SkPicture& picture) {
+    const SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+    auto surface = SkSurface::MakeRasterN32Premul(kWidth, kHeight, &props);
+    surface->getCanvas()->drawPicture(&picture);
+
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kWidth, kHeight);
+    auto pixels = SkData::MakeUninitialized(info.computeMinByteSize());
+    surface->readPixels(info, pixels->writable_data(), info.minRowBytes(), 0, 0);
+    return pixels;
+}
+
+// Receives the picture and then its strike data, draws it, and sends back the pixels.
+static int client(int index, const char poolPath[], int readFd, int writeFd) {
+    SkGraphics::Init();
+
+    auto picData = read_SkData(readFd);
+    auto fontData = read_SkData(readFd);
+    if (!picData || !fontData) {
+        warnx("client %d: no data from server", index);
+        return 1;
+    }
+
+    // The pool exists by now; the server made it before sending anything.
+    auto pool = SkSharedGlyphPool::MakeReader(poolPath);
+    if (!pool) {
+        warnx("client %d: can't open %s", index, poolPath);
+        return 1;
+    }
+
+    auto discardableManager = sk_make_sp<ClientDiscardableManager>();
+    SkStrikeClient strikeClient(discardableManager, false);
+    strikeClient.setGlyphPool(pool);
+
+    SkDeserialProcs procs;
+    procs.fTypefaceProc = [](const void* data, size_t length, void* ctx) -> sk_sp<SkTypeface> {
+        return reinterpret_cast<SkStrikeClient*>(ctx)->deserializeTypeface(data, length);
+    };
+    procs.fTypefaceCtx = &strikeClient;
+    auto picture = SkPicture::MakeFromData(picData.get(), &procs);
+    if (!picture) {
+        warnx("client %d: bad picture", index);
+        return 1;
+    }
+
+    if (!fontData->isEmpty() && !strikeClient.readStrikeData(fontData->data(), fontData->size())) {
+        warnx("client %d: bad strike data", index);
+        return 1;
+    }
+
+    auto pixels = rasterize(*picture);
+    printf("client %d: mapped %zu pool bytes, %d cache misses\n",
+           index, pool->size(), discardableManager->cacheMisses());
+    return write_SkData(writeFd, *pixels) ? 0 : 1;
+}
+
+struct Connection {
+    pid_t fPid;
+    int   fReadFd;
+    int   fWriteFd;
+};
+
+// Sends the picture and the glyphs it needs to each client, and checks what they drew.
+static int server(const char poolPath[], const std::vector<Connection>& clients) {
+    SkGraphics::Init();
+
+    auto pool = SkSharedGlyphPool::MakeWriter(poolPath);
+    if (!pool) {
+        warnx("server: can't create %s", poolPath);
+        return 1;
+    }
+
+    auto picture = make_text_picture();
+    auto expected = rasterize(*picture);
+
+    int failures = 0;
+    for (size_t i = 0; i < clients.size(); ++i) {
+        // Each client gets a server of its own, as it would with one connection per client.
+        ServerDiscardableManager discardableManager;
+        SkStrikeServer strikeServer(&discardableManager);
+        strikeServer.setGlyphPool(pool);
+
+        SkSerialProcs procs;
+        procs.fTypefaceProc = [](SkTypeface* tf, void* ctx) -> sk_sp<SkData> {
+            return reinterpret_cast<SkStrikeServer*>(ctx)->serializeTypeface(tf);
+        };
+        procs.fTypefaceCtx = &strikeServer;
+        auto picData = picture->serialize(&procs);
+
+        const SkSurfaceProps props(0, kUnknown_SkPixelGeometry);
+        SkTextBlobCacheDiffCanvas filter(kWidth, kHeight, props, &strikeServer);
+        picture->playback(&filter);
+        std::vector<uint8_t> fontData;
+        strikeServer.writeStrikeData(&fontData);
+
+        const Connection& c = clients[i];
+        if (!write_SkData(c.fWriteFd, *picData) ||
+            !write_SkData(c.fWriteFd, *SkData::MakeWithoutCopy(fontData.data(),
+                                                               fontData.size()))) {
+            failures++;
+            continue;
+        }
+        printf("server: sent client %zu %zu bytes of strike data; pool is %zu bytes\n",
+               i, fontData.size(), pool->size());
+
+        auto actual = read_SkData(c.fReadFd);
+        if (!actual || !actual->equals(expected.get())) {
+            warnx("server: client %zu drew something else", i);
+            failures++;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    int clientCount = argc > 1 ? atoi(argv[1]) : 4;
+    std::string poolPath = argc > 2 ? argv[2] : "/dev/shm/shared_glyph_pool";
+
+    // Fork every client before the server starts any threads.
+    std::vector<Connection> clients;
+    for (int i = 0; i < clientCount; ++i) {
+        int toClient[2], toServer[2];
+        if (pipe(toClient) < 0 || pipe(toServer) < 0) {
+            err(1, "Can't make pipes");
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            err(1, "Can't fork");
+        }
+        if (pid == 0) {
+            close(toClient[1]);
+            close(toServer[0]);
+            for (const Connection& c : clients) {
+                close(c.fReadFd);
+                close(c.fWriteFd);
+            }
+            _exit(client(i, poolPath.c_str(), toClient[0], toServer[1]));
+        }
+        close(toClient[0]);
+        close(toServer[1]);
+        clients.push_back({pid, toServer[0], toClient[1]});
+    }
+
+    int result = server(poolPath.c_str(), clients);
+
+    for (const Connection& c : clients) {
+        close(c.fWriteFd);
+        close(c.fReadFd);
+        int status;
+        if (waitpid(c.fPid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            result = 1;
+        }
+    }
+    unlink(poolPath.c_str());
+
+    printf("%s\n", result == 0 ? "All clients matched." : "FAILED");
+    return result;
+}
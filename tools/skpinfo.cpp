@@ -100,6 +100,11 @@ int main(int argc, char** argv) {
         // fonts) instead. This forces us to early exit when those
         // chunks are encountered.
         switch (tag) {
+        case SK_PICT_ALIGN_TAG:
+            if (FLAGS_tags && !FLAGS_quiet) {
+                SkDebugf("SK_PICT_ALIGN_TAG %d\n", chunkSize);
+            }
+            break;
         case SK_PICT_READER_TAG:
             if (FLAGS_tags && !FLAGS_quiet) {
                 SkDebugf("SK_PICT_READER_TAG %d\n", chunkSize);